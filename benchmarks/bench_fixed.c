@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <assert.h>
+#include <emscripten.h>
+#include "../c/fixed.h"
+
+int main(int argc, char *argv[]) {
+    uint64_t log_cost = 10;
+    if (argc > 1) {
+        log_cost = strtoull(argv[1], NULL, 0);
+    }
+    uint64_t cost = 1 << log_cost;
+    int num_runs = 3;
+
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* r3_hex = "03fda000539b9f03b5b23d888ba00b45b60b180f86657ef4e685aeb681854b2b";
+    char* r_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+    char* c_hex = "094c0e4dc5769c3bcc4c984fa08b0ceaf437545d83d259471a983cf05e97f19b";
+    uint64_t mu = 1073741823;
+
+    BigInt270 p, r3, cr;
+    int result;
+    result = hex_to_bigint270(p_hex, &p);
+    assert(result == 0);
+    result = hex_to_bigint270(r3_hex, &r3);
+    assert(result == 0);
+    result = hex_to_bigint270(c_hex, &cr);
+    assert(result == 0);
+
+    FixedMul9x30 f;
+    double start = emscripten_get_now();
+    fixed_mul_9x30_init(&f, &cr, &p, mu);
+    double end = emscripten_get_now();
+    printf("fixed_mul_9x30_init took %f ms\n", end - start);
+
+    // Pseudorandom operands
+    BigInt270 *in = malloc(cost * sizeof(BigInt270));
+    BigInt270 *out = malloc(cost * sizeof(BigInt270));
+    BigInt270 *out_fixed = malloc(cost * sizeof(BigInt270));
+    BigInt270 x = bigint270_new();
+    x.v[0] = 7;
+    for (uint64_t k = 0; k < cost; k ++) {
+        x = mont_mul_9x30(&x, &r3, &p, mu);
+        in[k] = x;
+    }
+
+    // Independent products, as when scaling a vector
+    double avg_a = 0, avg_b = 0, avg_c = 0, avg_d = 0;
+    BigInt270 *crs = malloc(cost * sizeof(BigInt270));
+    for (uint64_t k = 0; k < cost; k ++) {
+        crs[k] = cr;
+    }
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            out[k] = mont_mul_9x30(&in[k], &cr, &p, mu);
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            out_fixed[k] = mont_mul_by_fixed_9x30(&in[k], &f, &p);
+        }
+        end = emscripten_get_now();
+        avg_b += end - start;
+        assert(memcmp(out, out_fixed, cost * sizeof(BigInt270)) == 0);
+
+        start = emscripten_get_now();
+        mont_mul_9x30_batch(out_fixed, in, crs, cost, &p, mu);
+        end = emscripten_get_now();
+        avg_c += end - start;
+        assert(memcmp(out, out_fixed, cost * sizeof(BigInt270)) == 0);
+
+        start = emscripten_get_now();
+        mont_mul_by_fixed_9x30_batch(out_fixed, in, cost, &f, &p);
+        end = emscripten_get_now();
+        avg_d += end - start;
+        assert(memcmp(out, out_fixed, cost * sizeof(BigInt270)) == 0);
+    }
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+    avg_c /= num_runs;
+    avg_d /= num_runs;
+
+    printf("%llu multiplications by a constant with mont_mul_9x30 took                %f ms\n", cost, avg_a);
+    printf("%llu multiplications by a constant with mont_mul_by_fixed_9x30 took       %f ms\n", cost, avg_b);
+    printf("Speedup: %fx\n", avg_a / avg_b);
+    printf("%llu multiplications by a constant with mont_mul_9x30_batch took          %f ms\n", cost, avg_c);
+    printf("%llu multiplications by a constant with mont_mul_by_fixed_9x30_batch took %f ms\n", cost, avg_d);
+    printf("Speedup: %fx\n", avg_c / avg_d);
+
+    // Dependent products, which measure latency
+    BigInt270 y, y_fixed;
+    avg_a = 0, avg_b = 0;
+    for (int i = 0; i < num_runs; i ++) {
+        y = in[0];
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            y = mont_mul_9x30(&y, &cr, &p, mu);
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+
+        y_fixed = in[0];
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            y_fixed = mont_mul_by_fixed_9x30(&y_fixed, &f, &p);
+        }
+        end = emscripten_get_now();
+        avg_b += end - start;
+        assert(memcmp(&y, &y_fixed, sizeof(BigInt270)) == 0);
+    }
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+
+    printf("%llu chained multiplications by a constant with mont_mul_9x30 took          %f ms\n", cost, avg_a);
+    printf("%llu chained multiplications by a constant with mont_mul_by_fixed_9x30 took %f ms\n", cost, avg_b);
+    printf("Speedup: %fx\n", avg_a / avg_b);
+
+    // Multiplication by a small integer, against mont_mul_9x30 by its
+    // Montgomery form. k * R mod p is computed with mul_small itself.
+    uint64_t k = 3;
+    BigInt270 r_mod_p, kr;
+    result = hex_to_bigint270(r_hex, &r_mod_p);
+    assert(result == 0);
+    bigint270_mul_small_mod(&kr, &r_mod_p, k, &p);
+
+    avg_a = 0, avg_b = 0;
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        for (uint64_t j = 0; j < cost; j ++) {
+            out[j] = mont_mul_9x30(&in[j], &kr, &p, mu);
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t j = 0; j < cost; j ++) {
+            bigint270_mul_small_mod(&out_fixed[j], &in[j], k, &p);
+        }
+        end = emscripten_get_now();
+        avg_b += end - start;
+        assert(memcmp(out, out_fixed, cost * sizeof(BigInt270)) == 0);
+    }
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+
+    printf("%llu multiplications by %llu with mont_mul_9x30 took           %f ms\n", cost, k, avg_a);
+    printf("%llu multiplications by %llu with bigint270_mul_small_mod took %f ms\n", cost, k, avg_b);
+    printf("Speedup: %fx\n", avg_a / avg_b);
+
+    free(in);
+    free(out);
+    free(out_fixed);
+    free(crs);
+}
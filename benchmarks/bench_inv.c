@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <assert.h>
+#include <emscripten.h>
+#include "../c/inv.h"
+
+/// Baseline inversion by Fermat's little theorem: a^(p - 2) using left-to-right
+/// square-and-multiply with mont_sqr_9x30 and mont_mul_9x30.
+BigInt270 reference_func_mont_inv_9x30_fermat(
+    BigInt270 *ar,
+    BigInt270 *p,
+    BigInt270 *one,
+    uint64_t mu
+) {
+    // p - 2, with 30-bit limbs
+    uint64_t e[9];
+    uint64_t borrow = 2;
+    for (int i = 0; i < 9; i ++) {
+        uint64_t diff = p->v[i] - borrow;
+        e[i] = diff & 0x3FFFFFFF;
+        borrow = diff >> 63;
+    }
+
+    BigInt270 res = *one;
+    for (int i = 8; i >= 0; i --) {
+        for (int j = 29; j >= 0; j --) {
+            res = mont_sqr_9x30(&res, p, mu);
+            if ((e[i] >> j) & 1) {
+                res = mont_mul_9x30(&res, ar, p, mu);
+            }
+        }
+    }
+    return res;
+}
+
+/// Times batch_inverse_9x30 against one mont_inv_9x30 per element, and
+/// batch_inverse_9x30_mt with 4 threads.
+void run_batch_inverse_benchmarks(
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *r3,
+    uint64_t n,
+    int num_runs
+) {
+    BigInt270 *in = malloc(n * sizeof(BigInt270));
+    BigInt270 *out = malloc(n * sizeof(BigInt270));
+    BigInt270 *scratch = malloc(n * sizeof(BigInt270));
+    BigInt270 *expected = malloc(n * sizeof(BigInt270));
+
+    // Fill the input with values below p by repeatedly multiplying by r3.
+    BigInt270 x = bigint270_new();
+    x.v[0] = 7;
+    for (uint64_t k = 0; k < n; k ++) {
+        x = mont_mul_9x30(&x, r3, p, mu);
+        in[k] = x;
+    }
+
+    double start, end;
+    double avg_a = 0, avg_b = 0, avg_c = 0;
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            expected[k] = mont_inv_9x30(&in[k], p, mu, r3);
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+
+        start = emscripten_get_now();
+        batch_inverse_9x30(out, in, n, p, mu, r3, scratch);
+        end = emscripten_get_now();
+        avg_b += end - start;
+        assert(memcmp(out, expected, n * sizeof(BigInt270)) == 0);
+
+        start = emscripten_get_now();
+        batch_inverse_9x30_mt(out, in, n, p, mu, r3, scratch, 4);
+        end = emscripten_get_now();
+        avg_c += end - start;
+        assert(memcmp(out, expected, n * sizeof(BigInt270)) == 0);
+    }
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+    avg_c /= num_runs;
+
+    printf("Inverting %llu elements:\n", n);
+    printf("  one mont_inv_9x30 each:        %f ms\n", avg_a);
+    printf("  batch_inverse_9x30:            %f ms\n", avg_b);
+    printf("  batch_inverse_9x30_mt (4):     %f ms\n", avg_c);
+
+    free(in);
+    free(out);
+    free(scratch);
+    free(expected);
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t log_cost = 10;
+    if (argc > 1) {
+        log_cost = strtoull(argv[1], NULL, 0);
+    }
+    uint64_t cost = 1 << log_cost;
+    int num_runs = 3;
+
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* ar_hex = "107b8491edf2141b3c5b6f2dc8a34c3b46e37782d348cf8a4fa87b68433a2db9";
+    // R = 2^270
+    char* r_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+    char* r3_hex = "03fda000539b9f03b5b23d888ba00b45b60b180f86657ef4e685aeb681854b2b";
+    uint64_t mu = 1073741823;
+
+    BigInt270 p, ar, r, r3, expected, res;
+    int result;
+    result = hex_to_bigint270(p_hex, &p);
+    assert(result == 0);
+    result = hex_to_bigint270(ar_hex, &ar);
+    assert(result == 0);
+    result = hex_to_bigint270(r_hex, &r);
+    assert(result == 0);
+    result = hex_to_bigint270(r3_hex, &r3);
+    assert(result == 0);
+
+    expected = reference_func_mont_inv_9x30_fermat(&ar, &p, &r, mu);
+
+    double start, end;
+    double avg_a = 0, avg_b = 0;
+
+    // Chain the inversions so that each one depends on the previous result.
+    for (int i = 0; i < num_runs; i ++) {
+        res = ar;
+        start = emscripten_get_now();
+        for (uint64_t j = 0; j < cost; j ++) {
+            res = mont_inv_9x30(&res, &p, mu, &r3);
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+    }
+
+    // An even number of inversions gives back the input.
+    if (cost % 2 == 0) {
+        assert(memcmp(&res, &ar, sizeof(BigInt270)) == 0);
+    }
+    res = mont_inv_9x30(&ar, &p, mu, &r3);
+    assert(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+
+    for (int i = 0; i < num_runs; i ++) {
+        res = ar;
+        start = emscripten_get_now();
+        for (uint64_t j = 0; j < cost; j ++) {
+            res = reference_func_mont_inv_9x30_fermat(&res, &p, &r, mu);
+        }
+        end = emscripten_get_now();
+        avg_b += end - start;
+    }
+    if (cost % 2 == 0) {
+        assert(memcmp(&res, &ar, sizeof(BigInt270)) == 0);
+    }
+
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+
+    printf("%llu inversions with safegcd (30-bit limbs) took              %f ms\n", cost, avg_a);
+    printf("%llu inversions with Fermat exponentiation (30-bit limbs) took %f ms\n", cost, avg_b);
+    printf("Speedup: %fx\n", avg_b / avg_a);
+
+    run_batch_inverse_benchmarks(&p, mu, &r3, cost * 16, num_runs);
+}
@@ -1,7 +1,13 @@
 #include <stdio.h>
 #include <assert.h>
 #include <emscripten.h>
-#include "../c/mont.h"
+#include "../c/pow.h"
+#include "../c/ctx.h"
+#include "../c/barrett.h"
+#include "../c/gen/addchain_fr.h"
+#include "../c/gen/mont_fr_29.h"
+#include "../c/gen/mont_fr_30.h"
+#include "../c/gen/mont_p12ac_30.h"
 
 BigIntF255 reference_func_mont_mul_cios_f64_simd(
     BigIntF255 *a,
@@ -27,6 +33,31 @@ BigIntF255 reference_func_mont_mul_cios_f64_simd(
     return y;
 }
 
+BigIntF255x2 reference_func_mont_mul_cios_f64_simd_x2(
+    BigIntF255x2 *a,
+    BigIntF255x2 *b,
+    BigIntF255x2 *p,
+    BigIntF255 *p_for_redc,
+    uint64_t n0,
+    uint64_t cost
+) {
+    BigIntF255x2 x = *a;
+    BigIntF255x2 y = *b;
+    BigIntF255 z0, z1;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        BigIntF255x2 z = mont_mul_cios_f64_simd_x2(&x, &y, p, n0);
+        bigintf255_unpack(&z, &z0, &z1);
+        z0 = reduce_bigintf(&z0, p_for_redc);
+        z0 = resolve_bigintf(&z0);
+        z1 = reduce_bigintf(&z1, p_for_redc);
+        z1 = resolve_bigintf(&z1);
+        x = y;
+        y = bigintf255_pack(&z0, &z1);
+    }
+    return y;
+}
+
 BigInt261 reference_func_mont_mul_9x29(
     BigInt261 *a,
     BigInt261 *b,
@@ -65,6 +96,78 @@ BigInt270 reference_func_mont_mul_9x30(
     return y;
 }
 
+BigInt261 reference_func_mont_mul_9x29_lazy(
+    BigInt261 *a,
+    BigInt261 *b,
+    BigInt261 *p,
+    uint64_t n0,
+    uint64_t cost
+) {
+    BigInt261 x = *a;
+    BigInt261 y = *b;
+    BigInt261 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = mont_mul_9x29_lazy(&x, &y, p, n0);
+        x = y;
+        y = z;
+    }
+    return canonicalize_261(&y, p);
+}
+
+BigInt270 reference_func_mont_mul_9x30_lazy(
+    BigInt270 *a,
+    BigInt270 *b,
+    BigInt270 *p,
+    uint64_t n0,
+    uint64_t cost
+) {
+    BigInt270 x = *a;
+    BigInt270 y = *b;
+    BigInt270 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = mont_mul_9x30_lazy(&x, &y, p, n0);
+        x = y;
+        y = z;
+    }
+    return canonicalize_270(&y, p);
+}
+
+BigInt270 reference_func_mont_mul_9x30_fr(
+    BigInt270 *a,
+    BigInt270 *b,
+    uint64_t cost
+) {
+    BigInt270 x = *a;
+    BigInt270 y = *b;
+    BigInt270 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = mont_mul_9x30_fr(&x, &y);
+        x = y;
+        y = z;
+    }
+    return y;
+}
+
+BigInt261 reference_func_mont_mul_9x29_fr(
+    BigInt261 *a,
+    BigInt261 *b,
+    uint64_t cost
+) {
+    BigInt261 x = *a;
+    BigInt261 y = *b;
+    BigInt261 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = mont_mul_9x29_fr(&x, &y);
+        x = y;
+        y = z;
+    }
+    return y;
+}
+
 BigInt256 reference_func_mont_mul_cios(
     BigInt256 *a,
     BigInt256 *b,
@@ -85,6 +188,25 @@ BigInt256 reference_func_mont_mul_cios(
     return y;
 }
 
+BigInt256 reference_func_mont_mul_cios_nocarry(
+    BigInt256 *a,
+    BigInt256 *b,
+    BigInt256 *p,
+    uint64_t mu,
+    uint64_t cost
+) {
+    BigInt256 x = *a;
+    BigInt256 y = *b;
+    BigInt256 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = mont_mul_cios_nocarry(&x, &y, p, mu);
+        x = y;
+        y = z;
+    }
+    return y;
+}
+
 BigInt256 reference_func_bm17_non_simd(
     BigInt256 *a,
     BigInt256 *b,
@@ -123,6 +245,879 @@ BigInt256 reference_func_bm17_simd(
     return y;
 }
 
+BigInt256 reference_func_bm17_simd_extmul(
+    BigInt256 *a,
+    BigInt256 *b,
+    BigInt256 *p,
+    uint64_t mu,
+    uint64_t cost
+) {
+    BigInt256 x = *a;
+    BigInt256 y = *b;
+    BigInt256 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = bm17_simd_extmul_mont_mul(&x, &y, p, mu);
+        x = y;
+        y = z;
+    }
+    return y;
+}
+
+BigInt256 reference_func_barrett_mul_8x32(
+    BigInt256 *a,
+    BigInt256 *b,
+    BarrettParams8x32 *bp,
+    uint64_t cost
+) {
+    BigInt256 x = *a;
+    BigInt256 y = *b;
+    BigInt256 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = barrett_mul_8x32(&x, &y, bp);
+        x = y;
+        y = z;
+    }
+    return y;
+}
+
+BigInt270 reference_func_barrett_mul_9x30(
+    BigInt270 *a,
+    BigInt270 *b,
+    BarrettParams9x30 *bp,
+    uint64_t cost
+) {
+    BigInt270 x = *a;
+    BigInt270 y = *b;
+    BigInt270 z;
+
+    for (uint64_t i = 0; i < cost; i ++) {
+        z = barrett_mul_9x30(&x, &y, bp);
+        x = y;
+        y = z;
+    }
+    return y;
+}
+
+/*
+ * Prints the time taken by n exponentiations to p - 2 with the 30-bit kernel,
+ * using plain square-and-multiply, the sliding and fixed windows in
+ * mont_pow_9x30 and mont_pow_9x30_ct, and the generated addition chain. Each
+ * exponentiation takes the previous result as its base, and all four chains
+ * must produce the same result.
+ */
+void run_pow_benchmarks(MontCtx *ctx, char* x_hex, uint64_t n, int num_runs) {
+    BigInt270 p = ctx->w30.p;
+    BigInt270 one = ctx->w30.r;
+    uint64_t mu = ctx->w30.mu;
+    BigInt270 x, y_naive, y_sliding, y_fixed, y_chain;
+    hex_to_bigint270(x_hex, &x);
+
+    // p - 2
+    BigInt256 e, two = bigint_new();
+    two.v[0] = 2;
+    bigint_sub(&e, &ctx->cios.p, &two);
+    int e_bits = exp_bit_length(&e);
+
+    double start, end;
+    double t_naive = 0, t_sliding = 0, t_fixed = 0, t_chain = 0;
+
+    for (int r = 0; r < num_runs; r ++) {
+        y_naive = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < n; i ++) {
+            BigInt270 acc = y_naive;
+            for (int b = e_bits - 2; b >= 0; b --) {
+                acc = mont_sqr_9x30(&acc, &p, mu);
+                if (exp_bit(&e, b)) {
+                    acc = mont_mul_9x30(&acc, &y_naive, &p, mu);
+                }
+            }
+            y_naive = acc;
+        }
+        end = emscripten_get_now();
+        t_naive += end - start;
+
+        y_sliding = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < n; i ++) {
+            y_sliding = mont_pow_9x30(&y_sliding, &e, &p, mu, &one);
+        }
+        end = emscripten_get_now();
+        t_sliding += end - start;
+
+        y_fixed = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < n; i ++) {
+            y_fixed = mont_pow_9x30_ct(&y_fixed, &e, &p, mu, &one);
+        }
+        end = emscripten_get_now();
+        t_fixed += end - start;
+
+        y_chain = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < n; i ++) {
+            y_chain = mont_pow_chain_9x30(&y_chain, &addchain_fr_p_minus_2, &p, mu);
+        }
+        end = emscripten_get_now();
+        t_chain += end - start;
+
+        assert(memcmp(&y_naive, &y_sliding, sizeof(BigInt270)) == 0);
+        assert(memcmp(&y_naive, &y_fixed, sizeof(BigInt270)) == 0);
+        assert(memcmp(&y_naive, &y_chain, sizeof(BigInt270)) == 0);
+    }
+
+    printf("%llu exponentiations to p - 2 with 30-bit limbs:\n", n);
+    printf("  square-and-multiply:          %f ms\n", t_naive / num_runs);
+    printf("  sliding window (mont_pow):    %f ms\n", t_sliding / num_runs);
+    printf("  fixed window (mont_pow_ct):   %f ms\n", t_fixed / num_runs);
+    printf("  addition chain:               %f ms\n", t_chain / num_runs);
+}
+
+/*
+ * Prints the time taken by cost repeated squarings with each mont_sqr_*
+ * kernel, next to the time taken by the matching multiplication with a == b.
+ * Both chains must produce the same result.
+ */
+void run_sqr_benchmarks(MontCtx *ctx, char* x_hex, uint64_t cost, int num_runs) {
+    BigInt256 p = ctx->cios.p;
+    BigInt270 p_270 = ctx->w30.p;
+    BigInt261 p_261 = ctx->w29.p;
+    BigIntF255 p_f = ctx->f64.p;
+    BigIntF255 p_for_redc = ctx->f64.p_for_redc;
+    uint64_t *p_wide = ctx->cios.p_for_redc;
+    uint64_t n0 = ctx->cios.n0;
+    uint64_t n0_f = ctx->f64.n0;
+    uint64_t mu_270 = ctx->w30.mu;
+    uint64_t mu_261 = ctx->w29.mu;
+
+    BigInt256 x, y_mul, y_sqr;
+    BigInt270 x_270, y_mul_270, y_sqr_270;
+    BigInt261 x_261, y_mul_261, y_sqr_261;
+    BigIntF255 x_f, y_mul_f, y_sqr_f;
+    hex_to_bigint256(x_hex, &x);
+    hex_to_bigint270(x_hex, &x_270);
+    hex_to_bigint261(x_hex, &x_261);
+    hex_to_bigintf255(x_hex, &x_f);
+
+    double start, end;
+    double t_cios_mul = 0, t_cios_sqr = 0, t_cios_sqr_nocarry = 0;
+    double t_f64_mul = 0, t_f64_sqr = 0;
+    double t_270_mul = 0, t_270_sqr = 0;
+    double t_261_mul = 0, t_261_sqr = 0;
+
+    for (int r = 0; r < num_runs; r ++) {
+        y_mul = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_mul = mont_mul_cios(&y_mul, &y_mul, &p, p_wide, n0);
+        }
+        end = emscripten_get_now();
+        t_cios_mul += end - start;
+
+        y_sqr = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_sqr = mont_sqr_cios(&y_sqr, &p, n0);
+        }
+        end = emscripten_get_now();
+        t_cios_sqr += end - start;
+        assert(bigint_eq(&y_mul, &y_sqr));
+
+        y_sqr = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_sqr = mont_sqr_cios_nocarry(&y_sqr, &p, n0);
+        }
+        end = emscripten_get_now();
+        t_cios_sqr_nocarry += end - start;
+        assert(bigint_eq(&y_mul, &y_sqr));
+
+        y_mul_f = x_f;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_mul_f = mont_mul_cios_f64_simd(&y_mul_f, &y_mul_f, &p_f, n0_f);
+            y_mul_f = reduce_bigintf(&y_mul_f, &p_for_redc);
+            y_mul_f = resolve_bigintf(&y_mul_f);
+        }
+        end = emscripten_get_now();
+        t_f64_mul += end - start;
+
+        y_sqr_f = x_f;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_sqr_f = mont_sqr_cios_f64_simd(&y_sqr_f, &p_f, n0_f);
+            y_sqr_f = reduce_bigintf(&y_sqr_f, &p_for_redc);
+            y_sqr_f = resolve_bigintf(&y_sqr_f);
+        }
+        end = emscripten_get_now();
+        t_f64_sqr += end - start;
+        char mul_f_hex[65], sqr_f_hex[65];
+        bigintf255_to_hex(&y_mul_f, mul_f_hex);
+        bigintf255_to_hex(&y_sqr_f, sqr_f_hex);
+        assert(strcmp(mul_f_hex, sqr_f_hex) == 0);
+
+        y_mul_270 = x_270;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_mul_270 = mont_mul_9x30(&y_mul_270, &y_mul_270, &p_270, mu_270);
+        }
+        end = emscripten_get_now();
+        t_270_mul += end - start;
+
+        y_sqr_270 = x_270;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_sqr_270 = mont_sqr_9x30(&y_sqr_270, &p_270, mu_270);
+        }
+        end = emscripten_get_now();
+        t_270_sqr += end - start;
+        assert(memcmp(&y_mul_270, &y_sqr_270, sizeof(BigInt270)) == 0);
+
+        y_mul_261 = x_261;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_mul_261 = mont_mul_9x29(&y_mul_261, &y_mul_261, &p_261, mu_261);
+        }
+        end = emscripten_get_now();
+        t_261_mul += end - start;
+
+        y_sqr_261 = x_261;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_sqr_261 = mont_sqr_9x29(&y_sqr_261, &p_261, mu_261);
+        }
+        end = emscripten_get_now();
+        t_261_sqr += end - start;
+        assert(memcmp(&y_mul_261, &y_sqr_261, sizeof(BigInt261)) == 0);
+    }
+
+    printf("%llu Montgomery squarings (mul with a == b vs dedicated sqr):\n", cost);
+    printf("  CIOS (non-SIMD):      %f ms vs %f ms\n", t_cios_mul / num_runs, t_cios_sqr / num_runs);
+    printf("  CIOS (no-carry sqr):  %f ms vs %f ms\n", t_cios_mul / num_runs, t_cios_sqr_nocarry / num_runs);
+    printf("  f64s and CIOS (SIMD): %f ms vs %f ms\n", t_f64_mul / num_runs, t_f64_sqr / num_runs);
+    printf("  30-bit limbs:         %f ms vs %f ms\n", t_270_mul / num_runs, t_270_sqr / num_runs);
+    printf("  29-bit limbs:         %f ms vs %f ms\n", t_261_mul / num_runs, t_261_sqr / num_runs);
+}
+
+/*
+ * Compares the generic kernels with the p = 1 mod 2^w kernels. For 29-bit and
+ * 30-bit limbs, these are the ones that mont_ctx_mul_* picks for the default
+ * modulus; for 32-bit limbs, it picks mont_mul_cios_nocarry. Both end with the
+ * same conditional subtraction, so only the computation of q differs. Each
+ * multiplication depends on the previous one, so this measures latency.
+ */
+void run_p1_benchmarks(MontCtx *ctx, char* x_hex, uint64_t cost, int num_runs) {
+    BigInt256 x, y, y_p1;
+    BigInt270 x_270, y_270, y_270_p1;
+    BigInt261 x_261, y_261, y_261_p1;
+    hex_to_bigint256(x_hex, &x);
+    hex_to_bigint270(x_hex, &x_270);
+    hex_to_bigint261(x_hex, &x_261);
+
+    double start, end;
+    double t_cios = 0, t_cios_p1 = 0;
+    double t_270 = 0, t_270_p1 = 0;
+    double t_261 = 0, t_261_p1 = 0;
+
+    for (int r = 0; r < num_runs; r ++) {
+        y = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y = mont_mul_cios(&y, &x, &ctx->cios.p, ctx->cios.p_for_redc, ctx->cios.n0);
+        }
+        end = emscripten_get_now();
+        t_cios += end - start;
+
+        y_p1 = x;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_p1 = mont_mul_cios_p1(&y_p1, &x, &ctx->cios.p);
+        }
+        end = emscripten_get_now();
+        t_cios_p1 += end - start;
+        assert(bigint_eq(&y, &y_p1));
+
+        y_270 = x_270;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_270 = mont_mul_9x30(&y_270, &x_270, &ctx->w30.p, ctx->w30.mu);
+        }
+        end = emscripten_get_now();
+        t_270 += end - start;
+
+        y_270_p1 = x_270;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_270_p1 = mont_mul_9x30_p1(&y_270_p1, &x_270, &ctx->w30.p);
+        }
+        end = emscripten_get_now();
+        t_270_p1 += end - start;
+        assert(memcmp(&y_270, &y_270_p1, sizeof(BigInt270)) == 0);
+
+        y_261 = x_261;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_261 = mont_mul_9x29(&y_261, &x_261, &ctx->w29.p, ctx->w29.mu);
+        }
+        end = emscripten_get_now();
+        t_261 += end - start;
+
+        y_261_p1 = x_261;
+        start = emscripten_get_now();
+        for (uint64_t i = 0; i < cost; i ++) {
+            y_261_p1 = mont_mul_9x29_p1(&y_261_p1, &x_261, &ctx->w29.p);
+        }
+        end = emscripten_get_now();
+        t_261_p1 += end - start;
+        assert(memcmp(&y_261, &y_261_p1, sizeof(BigInt261)) == 0);
+    }
+
+    printf("%llu Montgomery multiplications (generic vs p = 1 mod 2^w):\n", cost);
+    printf("  CIOS (non-SIMD):      %f ms vs %f ms\n", t_cios / num_runs, t_cios_p1 / num_runs);
+    printf("  30-bit limbs:         %f ms vs %f ms\n", t_270 / num_runs, t_270_p1 / num_runs);
+    printf("  29-bit limbs:         %f ms vs %f ms\n", t_261 / num_runs, t_261_p1 / num_runs);
+}
+
+/*
+ * Returns a pseudorandom hex string for a value below the 253-bit modulus
+ * used in this file. Remember to free() it after use.
+ */
+char* rand_field_hex(uint64_t seed) {
+    BigInt256 r = bigint_rand(seed);
+    r.v[7] &= 0x0fffffff;
+    return bigint_to_hex(&r);
+}
+
+/*
+ * Prints the number of elements per second that each *_batch kernel
+ * processes for vectors of n pseudorandom elements.
+ */
+void run_batch_benchmarks(MontCtx *ctx, uint64_t n, int num_runs) {
+
+    BigInt256 *a = malloc(n * sizeof(BigInt256));
+    BigInt256 *b = malloc(n * sizeof(BigInt256));
+    BigInt256 *out = malloc(n * sizeof(BigInt256));
+    BigInt270 *a_270 = malloc(n * sizeof(BigInt270));
+    BigInt270 *b_270 = malloc(n * sizeof(BigInt270));
+    BigInt270 *out_270 = malloc(n * sizeof(BigInt270));
+    BigInt261 *a_261 = malloc(n * sizeof(BigInt261));
+    BigInt261 *b_261 = malloc(n * sizeof(BigInt261));
+    BigInt261 *out_261 = malloc(n * sizeof(BigInt261));
+    BigIntF255 *a_f = malloc(n * sizeof(BigIntF255));
+    BigIntF255 *b_f = malloc(n * sizeof(BigIntF255));
+    BigIntF255 *out_f = malloc(n * sizeof(BigIntF255));
+
+    for (uint64_t i = 0; i < n; i ++) {
+        char* a_hex = rand_field_hex(2 * i);
+        char* b_hex = rand_field_hex(2 * i + 1);
+        hex_to_bigint256(a_hex, &a[i]);
+        hex_to_bigint256(b_hex, &b[i]);
+        hex_to_bigint270(a_hex, &a_270[i]);
+        hex_to_bigint270(b_hex, &b_270[i]);
+        hex_to_bigint261(a_hex, &a_261[i]);
+        hex_to_bigint261(b_hex, &b_261[i]);
+        hex_to_bigintf255(a_hex, &a_f[i]);
+        hex_to_bigintf255(b_hex, &b_f[i]);
+        free(a_hex);
+        free(b_hex);
+    }
+
+    double start, end;
+    double t_bm17 = 0;
+    double t_bm17_simd = 0;
+    double t_bm17_extmul = 0;
+    double t_x4 = 0;
+    double t_cios = 0;
+    double t_f64 = 0;
+    double t_270 = 0;
+    double t_261 = 0;
+
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        bm17_non_simd_mont_mul_batch(out, a, b, n, &ctx->cios.p, ctx->cios.mu_bm17);
+        end = emscripten_get_now();
+        t_bm17 += end - start;
+
+        start = emscripten_get_now();
+        bm17_simd_mont_mul_batch(out, a, b, n, &ctx->cios.p, ctx->cios.mu_bm17);
+        end = emscripten_get_now();
+        t_bm17_simd += end - start;
+
+        start = emscripten_get_now();
+        bm17_simd_extmul_mont_mul_batch(out, a, b, n, &ctx->cios.p, ctx->cios.mu_bm17);
+        end = emscripten_get_now();
+        t_bm17_extmul += end - start;
+
+        start = emscripten_get_now();
+        mont_mul_x4_batch(out, a, b, n, &ctx->cios.p, ctx->cios.n0);
+        end = emscripten_get_now();
+        t_x4 += end - start;
+
+        start = emscripten_get_now();
+        mont_mul_cios_batch(out, a, b, n, &ctx->cios.p, ctx->cios.p_for_redc, ctx->cios.n0);
+        end = emscripten_get_now();
+        t_cios += end - start;
+
+        start = emscripten_get_now();
+        mont_mul_cios_f64_simd_batch(out_f, a_f, b_f, n, &ctx->f64.p, &ctx->f64.p_for_redc, ctx->f64.n0);
+        end = emscripten_get_now();
+        t_f64 += end - start;
+
+        start = emscripten_get_now();
+        mont_mul_9x30_batch(out_270, a_270, b_270, n, &ctx->w30.p, ctx->w30.mu);
+        end = emscripten_get_now();
+        t_270 += end - start;
+
+        start = emscripten_get_now();
+        mont_mul_9x29_batch(out_261, a_261, b_261, n, &ctx->w29.p, ctx->w29.mu);
+        end = emscripten_get_now();
+        t_261 += end - start;
+    }
+
+    // Convert the total time in ms into elements per second
+    double scale = n * num_runs * 1000.0;
+    printf("Batched Montgomery multiplication of %llu elements:\n", n);
+    printf("  BM17 (non-SIMD):      %.0f elements/s\n", scale / t_bm17);
+    printf("  BM17 (SIMD):          %.0f elements/s\n", scale / t_bm17_simd);
+    printf("  BM17 (SIMD, extmul):  %.0f elements/s\n", scale / t_bm17_extmul);
+    printf("  CIOS (SIMD, 4 lanes): %.0f elements/s\n", scale / t_x4);
+    printf("  CIOS (non-SIMD):      %.0f elements/s\n", scale / t_cios);
+    printf("  f64s and CIOS (SIMD): %.0f elements/s\n", scale / t_f64);
+    printf("  30-bit limbs:         %.0f elements/s\n", scale / t_270);
+    printf("  29-bit limbs:         %.0f elements/s\n", scale / t_261);
+
+    free(a);
+    free(b);
+    free(out);
+    free(a_270);
+    free(b_270);
+    free(out_270);
+    free(a_261);
+    free(b_261);
+    free(out_261);
+    free(a_f);
+    free(b_f);
+    free(out_f);
+}
+
+/*
+ * Compares mont_dot_9x30 with a loop of mont_mul_9x30 and bigint270_add_mod
+ * on vectors of n pseudorandom elements, and prints the number of terms per
+ * second of each.
+ */
+void run_dot_benchmarks(MontCtx *ctx, uint64_t n, int num_runs) {
+    BigInt270 *a = malloc(n * sizeof(BigInt270));
+    BigInt270 *b = malloc(n * sizeof(BigInt270));
+    for (uint64_t i = 0; i < n; i ++) {
+        char* a_hex = rand_field_hex(2 * i);
+        char* b_hex = rand_field_hex(2 * i + 1);
+        hex_to_bigint270(a_hex, &a[i]);
+        hex_to_bigint270(b_hex, &b[i]);
+        free(a_hex);
+        free(b_hex);
+    }
+
+    BigInt270 *p = &ctx->w30.p;
+    uint64_t mu = ctx->w30.mu;
+    BigInt270 naive, dot, prod;
+    double start, end;
+    double t_naive = 0;
+    double t_dot = 0;
+
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        naive = bigint270_new();
+        for (uint64_t k = 0; k < n; k ++) {
+            prod = mont_mul_9x30(&a[k], &b[k], p, mu);
+            bigint270_add_mod(&naive, &naive, &prod, p);
+        }
+        end = emscripten_get_now();
+        t_naive += end - start;
+
+        start = emscripten_get_now();
+        dot = mont_dot_9x30(a, b, n, p, mu);
+        end = emscripten_get_now();
+        t_dot += end - start;
+        assert(memcmp(&naive, &dot, sizeof(BigInt270)) == 0);
+    }
+
+    // Convert the total time in ms into terms per second
+    double scale = n * num_runs * 1000.0;
+    printf("Dot product of %llu elements with 30-bit limbs:\n", n);
+    printf("  mont_mul_9x30 and bigint270_add_mod: %.0f terms/s\n", scale / t_naive);
+    printf("  mont_dot_9x30:                       %.0f terms/s\n", scale / t_dot);
+
+    free(a);
+    free(b);
+}
+
+/*
+ * Prints the number of 512-bit values per millisecond that each
+ * mont_ctx_reduce_wide_* function maps into the field, and, for comparison,
+ * the rate of parsing 256-bit values from hex and converting them into
+ * Montgomery form with 30-bit limbs.
+ */
+void run_wide_benchmarks(MontCtx *ctx, uint64_t n, int num_runs) {
+    uint8_t *bytes = malloc(n * 64);
+    char **hex = malloc(n * sizeof(char*));
+    for (uint64_t i = 0; i < n; i ++) {
+        BigInt256 lo = bigint_rand(2 * i);
+        BigInt256 hi = bigint_rand(2 * i + 1);
+        for (int j = 0; j < 32; j ++) {
+            bytes[i * 64 + j] = (hi.v[7 - j / 4] >> (24 - 8 * (j % 4))) & 0xff;
+            bytes[i * 64 + 32 + j] = (lo.v[7 - j / 4] >> (24 - 8 * (j % 4))) & 0xff;
+        }
+        hex[i] = rand_field_hex(2 * i);
+    }
+
+    BigInt256 x;
+    BigInt261 x_261;
+    BigInt270 x_270;
+    BigIntF255 x_f;
+    double start, end;
+    double t_cios = 0;
+    double t_270 = 0;
+    double t_261 = 0;
+    double t_f64 = 0;
+    double t_hex = 0;
+    // Keeps the compiler from dropping the loops
+    uint64_t sink = 0;
+
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            x = mont_ctx_reduce_wide_cios(ctx, &bytes[k * 64]);
+            sink ^= x.v[0];
+        }
+        end = emscripten_get_now();
+        t_cios += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            x_270 = mont_ctx_reduce_wide_9x30(ctx, &bytes[k * 64]);
+            sink ^= x_270.v[0];
+        }
+        end = emscripten_get_now();
+        t_270 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            x_261 = mont_ctx_reduce_wide_9x29(ctx, &bytes[k * 64]);
+            sink ^= x_261.v[0];
+        }
+        end = emscripten_get_now();
+        t_261 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            x_f = mont_ctx_reduce_wide_f64(ctx, &bytes[k * 64]);
+            sink ^= i64x2_extract_l(x_f.v[0]);
+        }
+        end = emscripten_get_now();
+        t_f64 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            hex_to_bigint270(hex[k], &x_270);
+            x_270 = mont_mul_9x30(&x_270, &ctx->w30.r2, &ctx->w30.p, ctx->w30.mu);
+            sink ^= x_270.v[0];
+        }
+        end = emscripten_get_now();
+        t_hex += end - start;
+    }
+
+    // Convert the total time in ms into elements per ms
+    double scale = n * num_runs;
+    printf("Reduction of %llu 512-bit values into Montgomery form:\n", n);
+    printf("  32-bit limbs:               %.0f elements/ms\n", scale / t_cios);
+    printf("  30-bit limbs:               %.0f elements/ms\n", scale / t_270);
+    printf("  29-bit limbs:               %.0f elements/ms\n", scale / t_261);
+    printf("  51-bit limbs in doubles:    %.0f elements/ms\n", scale / t_f64);
+    printf("  256-bit hex, 30-bit limbs:  %.0f elements/ms\n", scale / t_hex);
+    printf("  (checksum %llu)\n", sink);
+
+    free(bytes);
+    for (uint64_t i = 0; i < n; i ++) {
+        free(hex[i]);
+    }
+    free(hex);
+}
+
+/*
+ * Compares the branching final subtraction in each kernel with the
+ * branch-free one in its *_ct variant, on n independent products of
+ * pseudorandom elements, rather than on a chain of products of fixed inputs.
+ */
+void run_ct_benchmarks(MontCtx *ctx, uint64_t n, int num_runs) {
+    BigInt256 *a = malloc(n * sizeof(BigInt256));
+    BigInt256 *b = malloc(n * sizeof(BigInt256));
+    BigInt256 *out = malloc(n * sizeof(BigInt256));
+    BigInt270 *a_270 = malloc(n * sizeof(BigInt270));
+    BigInt270 *b_270 = malloc(n * sizeof(BigInt270));
+    BigInt270 *out_270 = malloc(n * sizeof(BigInt270));
+    BigInt261 *a_261 = malloc(n * sizeof(BigInt261));
+    BigInt261 *b_261 = malloc(n * sizeof(BigInt261));
+    BigInt261 *out_261 = malloc(n * sizeof(BigInt261));
+    BigIntF255 *ab_f = malloc(n * sizeof(BigIntF255));
+    BigIntF255 *out_f = malloc(n * sizeof(BigIntF255));
+
+    for (uint64_t i = 0; i < n; i ++) {
+        char* a_hex = rand_field_hex(2 * i);
+        char* b_hex = rand_field_hex(2 * i + 1);
+        hex_to_bigint256(a_hex, &a[i]);
+        hex_to_bigint256(b_hex, &b[i]);
+        hex_to_bigint270(a_hex, &a_270[i]);
+        hex_to_bigint270(b_hex, &b_270[i]);
+        hex_to_bigint261(a_hex, &a_261[i]);
+        hex_to_bigint261(b_hex, &b_261[i]);
+        BigIntF255 a_f, b_f;
+        hex_to_bigintf255(a_hex, &a_f);
+        hex_to_bigintf255(b_hex, &b_f);
+        ab_f[i] = mont_mul_cios_f64_simd(&a_f, &b_f, &ctx->f64.p, ctx->f64.n0);
+        free(a_hex);
+        free(b_hex);
+    }
+
+    MontParamsCios *cios = &ctx->cios;
+    MontParams9x30 *w30 = &ctx->w30;
+    MontParams9x29 *w29 = &ctx->w29;
+    double start, end;
+    double t_cios = 0, t_cios_ct = 0;
+    double t_bm17 = 0, t_bm17_ct = 0;
+    double t_270 = 0, t_270_ct = 0;
+    double t_261 = 0, t_261_ct = 0;
+    double t_f64 = 0, t_f64_ct = 0;
+
+    for (int r = 0; r < num_runs; r ++) {
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out[k] = mont_mul_cios(&a[k], &b[k], &cios->p, cios->p_for_redc, cios->n0);
+        }
+        end = emscripten_get_now();
+        t_cios += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out[k] = mont_mul_cios_ct(&a[k], &b[k], &cios->p, cios->p_for_redc, cios->n0);
+        }
+        end = emscripten_get_now();
+        t_cios_ct += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out[k] = bm17_non_simd_mont_mul(&a[k], &b[k], &cios->p, cios->mu_bm17);
+        }
+        end = emscripten_get_now();
+        t_bm17 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out[k] = bm17_non_simd_mont_mul_ct(&a[k], &b[k], &cios->p, cios->mu_bm17);
+        }
+        end = emscripten_get_now();
+        t_bm17_ct += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out_270[k] = mont_mul_9x30(&a_270[k], &b_270[k], &w30->p, w30->mu);
+        }
+        end = emscripten_get_now();
+        t_270 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out_270[k] = mont_mul_9x30_ct(&a_270[k], &b_270[k], &w30->p, w30->mu);
+        }
+        end = emscripten_get_now();
+        t_270_ct += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out_261[k] = mont_mul_9x29(&a_261[k], &b_261[k], &w29->p, w29->mu);
+        }
+        end = emscripten_get_now();
+        t_261 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out_261[k] = mont_mul_9x29_ct(&a_261[k], &b_261[k], &w29->p, w29->mu);
+        }
+        end = emscripten_get_now();
+        t_261_ct += end - start;
+
+        // Only the reduction, as the f64 multiplication itself does not branch
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out_f[k] = reduce_bigintf(&ab_f[k], &ctx->f64.p_for_redc);
+        }
+        end = emscripten_get_now();
+        t_f64 += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < n; k ++) {
+            out_f[k] = reduce_bigintf_ct(&ab_f[k], &ctx->f64.p_for_redc);
+        }
+        end = emscripten_get_now();
+        t_f64_ct += end - start;
+    }
+
+    printf("%llu Montgomery multiplications of random elements (branching vs branch-free reduction):\n", n);
+    printf("  CIOS (non-SIMD):      %f ms vs %f ms\n", t_cios / num_runs, t_cios_ct / num_runs);
+    printf("  BM17 (non-SIMD):      %f ms vs %f ms\n", t_bm17 / num_runs, t_bm17_ct / num_runs);
+    printf("  30-bit limbs:         %f ms vs %f ms\n", t_270 / num_runs, t_270_ct / num_runs);
+    printf("  29-bit limbs:         %f ms vs %f ms\n", t_261 / num_runs, t_261_ct / num_runs);
+    printf("  reduce_bigintf only:  %f ms vs %f ms\n", t_f64 / num_runs, t_f64_ct / num_runs);
+
+    free(a);
+    free(b);
+    free(out);
+    free(a_270);
+    free(b_270);
+    free(out_270);
+    free(a_261);
+    free(b_261);
+    free(out_261);
+    free(ab_f);
+    free(out_f);
+}
+
+/// Compares the sparse kernels in sparse.h with the generic kernels for the
+/// modulus p_hex, and prints the number of 64-bit multiplications that each
+/// does per Montgomery product. mul_270_gen is the kernel that
+/// scripts/gen_mont.py generates for the same modulus, which drops the zero
+/// limbs at build time.
+void run_sparse_benchmarks(
+    char* name,
+    char* p_hex,
+    BigInt270 (*mul_270_gen)(BigInt270 *, BigInt270 *),
+    uint64_t cost,
+    int num_runs
+) {
+    MontCtx ctx;
+    int result = mont_ctx_init_hex(&ctx, p_hex);
+    assert(result == 0);
+
+    // The modulus is at least as large as the default one, so these are in
+    // range.
+    char* a_hex = rand_field_hex(1);
+    char* b_hex = rand_field_hex(2);
+    BigInt256 a, b, x, y, z;
+    BigInt270 a_270, b_270, x_270, y_270, z_270;
+    hex_to_bigint256(a_hex, &a);
+    hex_to_bigint256(b_hex, &b);
+    hex_to_bigint270(a_hex, &a_270);
+    hex_to_bigint270(b_hex, &b_270);
+    free(a_hex);
+    free(b_hex);
+
+    MontParamsCios *cios = &ctx.cios;
+    MontParams9x30 *w30 = &ctx.w30;
+    double start, end;
+    double t_cios = 0, t_cios_sparse = 0;
+    double t_bm17 = 0, t_bm17_sparse = 0;
+    double t_270 = 0, t_270_sparse = 0, t_270_gen = 0;
+    BigInt256 res, res_sparse;
+    BigInt270 res_270, res_270_sparse;
+
+    for (int i = 0; i < num_runs; i ++) {
+        x = a, y = b;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z = mont_mul_cios(&x, &y, &cios->p, cios->p_for_redc, cios->n0);
+            x = y;
+            y = z;
+        }
+        end = emscripten_get_now();
+        t_cios += end - start;
+        res = y;
+
+        x = a, y = b;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z = mont_mul_cios_sparse(&x, &y, &cios->p, cios->n0, &cios->sparse);
+            x = y;
+            y = z;
+        }
+        end = emscripten_get_now();
+        t_cios_sparse += end - start;
+        assert(bigint_eq(&res, &y));
+
+        x = a, y = b;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z = bm17_non_simd_mont_mul(&x, &y, &cios->p, cios->mu_bm17);
+            x = y;
+            y = z;
+        }
+        end = emscripten_get_now();
+        t_bm17 += end - start;
+        res = y;
+
+        x = a, y = b;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z = bm17_non_simd_mont_mul_sparse(&x, &y, &cios->p, cios->mu_bm17, &cios->sparse);
+            x = y;
+            y = z;
+        }
+        end = emscripten_get_now();
+        t_bm17_sparse += end - start;
+        assert(bigint_eq(&res, &y));
+
+        x_270 = a_270, y_270 = b_270;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z_270 = mont_mul_9x30(&x_270, &y_270, &w30->p, w30->mu);
+            x_270 = y_270;
+            y_270 = z_270;
+        }
+        end = emscripten_get_now();
+        t_270 += end - start;
+        res_270 = y_270;
+
+        x_270 = a_270, y_270 = b_270;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z_270 = mont_mul_9x30_sparse(&x_270, &y_270, &w30->p, w30->mu, &w30->sparse);
+            x_270 = y_270;
+            y_270 = z_270;
+        }
+        end = emscripten_get_now();
+        t_270_sparse += end - start;
+        assert(memcmp(&res_270, &y_270, sizeof(BigInt270)) == 0);
+
+        x_270 = a_270, y_270 = b_270;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            z_270 = mul_270_gen(&x_270, &y_270);
+            x_270 = y_270;
+            y_270 = z_270;
+        }
+        end = emscripten_get_now();
+        t_270_gen += end - start;
+        assert(memcmp(&res_270, &y_270, sizeof(BigInt270)) == 0);
+    }
+
+    // Multiplications per product: n^2 for a * b, n^2 for q * p, and n for q
+    // (plus n + 1 more in BM17, which also computes mu * b_0 and mu * (d_0 - e_0))
+    size_t muls_cios = 2 * 8 * 8 + 8;
+    size_t muls_bm17 = 2 * 8 * 8 + 2 * 8 + 1;
+    size_t muls_270 = 2 * 9 * 9 + 9;
+    size_t skipped = mont_sparse_skipped_muls(&cios->sparse);
+    size_t skipped_270 = mont_sparse_skipped_muls(&w30->sparse);
+
+    printf("Sparse Montgomery multiplication modulo %s (%llu products):\n", name, cost);
+    printf("  CIOS (non-SIMD):     %f ms vs %f ms, %zu vs %zu multiplications\n",
+        t_cios_sparse / num_runs, t_cios / num_runs, muls_cios - skipped, muls_cios);
+    printf("  BM17 (non-SIMD):     %f ms vs %f ms, %zu vs %zu multiplications\n",
+        t_bm17_sparse / num_runs, t_bm17 / num_runs, muls_bm17 - skipped, muls_bm17);
+    printf("  30-bit limbs:        %f ms vs %f ms, %zu vs %zu multiplications\n",
+        t_270_sparse / num_runs, t_270 / num_runs, muls_270 - skipped_270, muls_270);
+    printf("  30-bit, generated:   %f ms\n", t_270_gen / num_runs);
+}
+
 int main(int argc, char *argv[]) {
     uint64_t log_cost = 10;
     if (argc > 1) {
@@ -150,8 +1145,15 @@ int main(int argc, char *argv[]) {
     // These results are hardcoded for cost == 1024
     char* expected_hex = "116a8d07bb676b153699f5744d2eace047a0646f4cfe06012a0bbd53720543b1";
 
-    result = hex_to_bigint256(p_hex, &p);
+    // All of the constants for p are derived from it at runtime.
+    MontCtx ctx;
+    double start_init = emscripten_get_now();
+    result = mont_ctx_init_hex(&ctx, p_hex);
+    double end_init = emscripten_get_now();
     assert(result == 0);
+    printf("mont_ctx_init took %f ms\n", end_init - start_init);
+
+    p = ctx.cios.p;
     result = hex_to_bigint256(ar_hex, &ar);
     assert(result == 0);
     result = hex_to_bigint256(br_hex, &br);
@@ -164,6 +1166,7 @@ int main(int argc, char *argv[]) {
     double start_d, end_d;
     double start_e, end_e;
     double start_f, end_f;
+    double start_g, end_g;
 
     double avg_a = 0;
     double avg_b = 0;
@@ -171,11 +1174,12 @@ int main(int argc, char *argv[]) {
     double avg_d = 0;
     double avg_e = 0;
     double avg_f = 0;
+    double avg_g = 0;
 
     // Benchmark bm17_non_simd_mont_mul
     for (int i = 0; i < num_runs; i ++) {
         start_a = emscripten_get_now();
-        res = reference_func_bm17_non_simd(&ar, &br, &p, 1, cost);
+        res = reference_func_bm17_non_simd(&ar, &br, &p, ctx.cios.mu_bm17, cost);
         end_a = emscripten_get_now();
         avg_a += end_a - start_a;
         char* res_hex = bigint_to_hex(&res);
@@ -187,7 +1191,7 @@ int main(int argc, char *argv[]) {
     // natively executed by the CPU.
     for (int i = 0; i < num_runs; i ++) {
         start_b = emscripten_get_now();
-        res = reference_func_bm17_simd(&ar, &br, &p, 1, cost);
+        res = reference_func_bm17_simd(&ar, &br, &p, ctx.cios.mu_bm17, cost);
         end_b = emscripten_get_now();
         avg_b += end_b - start_b;
         char* res_hex = bigint_to_hex(&res);
@@ -195,15 +1199,23 @@ int main(int argc, char *argv[]) {
             assert(strcmp(res_hex, expected_hex) == 0);
     }
 
-    // Benchmark mont_mul_cios
-    uint64_t p_wide[9] = {0};
-    for (int i = 0; i < 8; i ++) {
-        p_wide[i] = p.v[i];
+    // Benchmark bm17_simd_extmul_mont_mul, which uses extmul instead of i64x2.mul
+    double avg_bx = 0;
+    double start_bx, end_bx;
+    for (int i = 0; i < num_runs; i ++) {
+        start_bx = emscripten_get_now();
+        res = reference_func_bm17_simd_extmul(&ar, &br, &p, ctx.cios.mu_bm17, cost);
+        end_bx = emscripten_get_now();
+        avg_bx += end_bx - start_bx;
+        char* res_hex = bigint_to_hex(&res);
+        if (do_assert)
+            assert(strcmp(res_hex, expected_hex) == 0);
     }
 
+    // Benchmark mont_mul_cios
     for (int i = 0; i < num_runs; i ++) {
         start_c = emscripten_get_now();
-        res = reference_func_mont_mul_cios(&ar, &br, &p, p_wide, 4294967295, cost);
+        res = reference_func_mont_mul_cios(&ar, &br, &p, ctx.cios.p_for_redc, ctx.cios.n0, cost);
         end_c = emscripten_get_now();
         avg_c += end_c - start_c;
         char* res_hex = bigint_to_hex(&res);
@@ -211,52 +1223,75 @@ int main(int argc, char *argv[]) {
             assert(strcmp(res_hex, expected_hex) == 0);
     }
 
+    // Benchmark mont_mul_cios_nocarry
+    double avg_l = 0;
+    double start_l, end_l;
+    for (int i = 0; i < num_runs; i ++) {
+        start_l = emscripten_get_now();
+        res = reference_func_mont_mul_cios_nocarry(&ar, &br, &p, ctx.cios.n0, cost);
+        end_l = emscripten_get_now();
+        avg_l += end_l - start_l;
+        char* res_hex = bigint_to_hex(&res);
+        if (do_assert)
+            assert(strcmp(res_hex, expected_hex) == 0);
+    }
+
     // Benchmark mont_mul_cios_f64_simd
     ar_hex = "0c0048f9de61fa9334139e21184664eb16a77e902d9d06924a1b6b05f6d08675";
     br_hex = "0dfbb9d62fd1a0c9168072b6fe615e7626f0e5ae29e92ca41254de782f4bf8ce";
     char* expected_for_cios_f64_hex = "120af9332aca0835cba7214954b32e70d0a56db70e7f03011a0e9ea9b902a1d9";
 
     // Benchmark mont_mul_cios_f64_simd
-    result = hex_to_bigintf255(p_hex, &p_f);
-    assert(result == 0);
+    p_f = ctx.f64.p;
     result = hex_to_bigintf255(ar_hex, &ar_f);
     assert(result == 0);
     result = hex_to_bigintf255(br_hex, &br_f);
     assert(result == 0);
 
-    BigIntF255 p_for_redc = bigintf_new();
-    uint64_t p0 = 0x1800000000001;
-    uint64_t p1 = 0x7DA0000002142;
-    uint64_t p2 = 0x0DEC00566A9DB;
-    uint64_t p3 = 0x2AB305A268F2E;
-    uint64_t p4 = 0x12AB655E9A2CA;
-    memcpy(&(p_for_redc.v[0]), &p0, sizeof(uint64_t));
-    memcpy(&(p_for_redc.v[1]), &p1, sizeof(uint64_t));
-    memcpy(&(p_for_redc.v[2]), &p2, sizeof(uint64_t));
-    memcpy(&(p_for_redc.v[3]), &p3, sizeof(uint64_t));
-    memcpy(&(p_for_redc.v[4]), &p4, sizeof(uint64_t));
-
-    uint64_t n0 = 422212465065983;
+    BigIntF255 p_for_redc = ctx.f64.p_for_redc;
+    uint64_t n0 = ctx.f64.n0;
 
     for (int i = 0; i < num_runs; i ++) {
         start_d = emscripten_get_now();
         res_f = reference_func_mont_mul_cios_f64_simd(&ar_f, &br_f, &p_f, &p_for_redc, n0, cost);
         end_d = emscripten_get_now();
-        avg_d = end_d - start_d;
+        avg_d += end_d - start_d;
         char res_f_hex[65];
         bigintf255_to_hex(&res_f, res_f_hex);
         if (do_assert)
             assert(strcmp(res_f_hex, expected_for_cios_f64_hex) == 0);
     }
 
+    // Benchmark mont_mul_cios_f64_simd_x2. Both lanes run the same chain as
+    // above, so each lane should produce the same result.
+    BigIntF255x2 p_f2 = bigintf255_pack(&p_f, &p_f);
+    BigIntF255x2 ar_f2 = bigintf255_pack(&ar_f, &ar_f);
+    BigIntF255x2 br_f2 = bigintf255_pack(&br_f, &br_f);
+    BigIntF255x2 res_f2;
+    BigIntF255 res_f_l, res_f_h;
+
+    for (int i = 0; i < num_runs; i ++) {
+        start_g = emscripten_get_now();
+        res_f2 = reference_func_mont_mul_cios_f64_simd_x2(&ar_f2, &br_f2, &p_f2, &p_for_redc, n0, cost);
+        end_g = emscripten_get_now();
+        avg_g += end_g - start_g;
+        bigintf255_unpack(&res_f2, &res_f_l, &res_f_h);
+        char res_f_hex[65];
+        bigintf255_to_hex(&res_f_l, res_f_hex);
+        if (do_assert)
+            assert(strcmp(res_f_hex, expected_for_cios_f64_hex) == 0);
+        bigintf255_to_hex(&res_f_h, res_f_hex);
+        if (do_assert)
+            assert(strcmp(res_f_hex, expected_for_cios_f64_hex) == 0);
+    }
+
     // Benchmark mont_mul_9x30
     ar_hex = "107b8491edf2141b3c5b6f2dc8a34c3b46e37782d348cf8a4fa87b68433a2db9";
     br_hex = "11ab14a88c521c7574625aa40c9ff2066edb54cc3651a587358f17a5fc66a022";
     char* expected_for_9x30_hex = "0261dacd294624a0f0d0dab1fe80014ac3d36e2541800c75d286dc8150ec044c";
 
     BigInt270 ar_270, br_270, p_270, res_270;
-    result = hex_to_bigint270(p_hex, &p_270);
-    assert(result == 0);
+    p_270 = ctx.w30.p;
     result = hex_to_bigint270(ar_hex, &ar_270);
     assert(result == 0);
     result = hex_to_bigint270(br_hex, &br_270);
@@ -264,9 +1299,9 @@ int main(int argc, char *argv[]) {
 
     for (int i = 0; i < num_runs; i ++) {
         start_e = emscripten_get_now();
-        res_270 = reference_func_mont_mul_9x30(&ar_270, &br_270, &p_270, 1073741823, cost);
+        res_270 = reference_func_mont_mul_9x30(&ar_270, &br_270, &p_270, ctx.w30.mu, cost);
         end_e = emscripten_get_now();
-        avg_e = end_e - start_e;
+        avg_e += end_e - start_e;
         char* res_hex = bigint270_to_hex(&res_270);
         if (do_assert)
             assert(strcmp(res_hex, expected_for_9x30_hex) == 0);
@@ -281,8 +1316,7 @@ int main(int argc, char *argv[]) {
     char* expected_for_9x29 = "076d42656adcf183ebe06a2fb8840c71b1018e61f7d62192d487edf04c2dcfdd";
 
     BigInt261 ar_261, br_261, p_261, res_261;
-    result = hex_to_bigint261(p_hex, &p_261);
-    assert(result == 0);
+    p_261 = ctx.w29.p;
     result = hex_to_bigint261(ar_hex, &ar_261);
     assert(result == 0);
     result = hex_to_bigint261(br_hex, &br_261);
@@ -290,25 +1324,131 @@ int main(int argc, char *argv[]) {
 
     for (int i = 0; i < num_runs; i ++) {
         start_f = emscripten_get_now();
-        res_261 = reference_func_mont_mul_9x29(&ar_261, &br_261, &p_261, 536870911, cost);
+        res_261 = reference_func_mont_mul_9x29(&ar_261, &br_261, &p_261, ctx.w29.mu, cost);
         end_f = emscripten_get_now();
-        avg_f = end_f - start_f;
+        avg_f += end_f - start_f;
+        char* res_hex = bigint261_to_hex(&res_261);
+        if (do_assert)
+            assert(strcmp(res_hex, expected_for_9x29) == 0);
+    }
+
+    // Benchmark the lazy variants of mont_mul_9x30 and mont_mul_9x29
+    double avg_h = 0, avg_i = 0;
+    double start_h, end_h, start_i, end_i;
+    for (int i = 0; i < num_runs; i ++) {
+        start_h = emscripten_get_now();
+        res_270 = reference_func_mont_mul_9x30_lazy(&ar_270, &br_270, &p_270, ctx.w30.mu, cost);
+        end_h = emscripten_get_now();
+        avg_h += end_h - start_h;
+        char* res_hex = bigint270_to_hex(&res_270);
+        if (do_assert)
+            assert(strcmp(res_hex, expected_for_9x30_hex) == 0);
+    }
+
+    for (int i = 0; i < num_runs; i ++) {
+        start_i = emscripten_get_now();
+        res_261 = reference_func_mont_mul_9x29_lazy(&ar_261, &br_261, &p_261, ctx.w29.mu, cost);
+        end_i = emscripten_get_now();
+        avg_i += end_i - start_i;
+        char* res_hex = bigint261_to_hex(&res_261);
+        if (do_assert)
+            assert(strcmp(res_hex, expected_for_9x29) == 0);
+    }
+
+    // Benchmark the kernels generated for this modulus by scripts/gen_mont.py
+    double avg_j = 0, avg_k = 0;
+    double start_j, end_j, start_k, end_k;
+    for (int i = 0; i < num_runs; i ++) {
+        start_j = emscripten_get_now();
+        res_270 = reference_func_mont_mul_9x30_fr(&ar_270, &br_270, cost);
+        end_j = emscripten_get_now();
+        avg_j += end_j - start_j;
+        char* res_hex = bigint270_to_hex(&res_270);
+        if (do_assert)
+            assert(strcmp(res_hex, expected_for_9x30_hex) == 0);
+    }
+
+    for (int i = 0; i < num_runs; i ++) {
+        start_k = emscripten_get_now();
+        res_261 = reference_func_mont_mul_9x29_fr(&ar_261, &br_261, cost);
+        end_k = emscripten_get_now();
+        avg_k += end_k - start_k;
         char* res_hex = bigint261_to_hex(&res_261);
         if (do_assert)
             assert(strcmp(res_hex, expected_for_9x29) == 0);
     }
 
+    // Benchmark Barrett multiplication on canonical values, with the 32-bit
+    // and 30-bit operands of the Montgomery benchmarks above. The chains do
+    // not give the same values as the Montgomery ones, but agree with each
+    // other.
+    BarrettCtx barrett;
+    result = barrett_ctx_init_hex(&barrett, p_hex);
+    assert(result == 0);
+    BigInt270 ar_b, br_b, res_b;
+    bigint256_to_bigint270(&ar_b, &ar);
+    bigint256_to_bigint270(&br_b, &br);
+
+    double avg_m = 0, avg_n = 0;
+    double start_m, end_m, start_n, end_n;
+    for (int i = 0; i < num_runs; i ++) {
+        start_m = emscripten_get_now();
+        res = reference_func_barrett_mul_8x32(&ar, &br, &barrett.w32, cost);
+        end_m = emscripten_get_now();
+        avg_m += end_m - start_m;
+
+        start_n = emscripten_get_now();
+        res_b = reference_func_barrett_mul_9x30(&ar_b, &br_b, &barrett.w30, cost);
+        end_n = emscripten_get_now();
+        avg_n += end_n - start_n;
+
+        char* res_hex = bigint_to_hex(&res);
+        char* res_b_hex = bigint270_to_hex(&res_b);
+        assert(strcmp(res_hex, res_b_hex) == 0);
+        free(res_hex);
+    }
+
     avg_a /= num_runs;
     avg_b /= num_runs;
+    avg_bx /= num_runs;
     avg_c /= num_runs;
+    avg_l /= num_runs;
     avg_d /= num_runs;
     avg_e /= num_runs;
     avg_f /= num_runs;
+    avg_g /= num_runs;
+    avg_h /= num_runs;
+    avg_i /= num_runs;
+    avg_j /= num_runs;
+    avg_k /= num_runs;
+    avg_m /= num_runs;
+    avg_n /= num_runs;
 
     printf("%llu Montgomery multiplications with BM17 (non-SIMD) took                             %f ms\n", cost, avg_a);
     printf("%llu Montgomery multiplications with BM17 (SIMD) took                                 %f ms\n", cost, avg_b);
+    printf("%llu Montgomery multiplications with BM17 (SIMD, extmul) took                         %f ms\n", cost, avg_bx);
     printf("%llu Montgomery multiplications with CIOS (non-SIMD, without gnark optimisation) took %f ms\n", cost, avg_c);
+    printf("%llu Montgomery multiplications with CIOS (non-SIMD, with gnark optimisation) took    %f ms\n", cost, avg_l);
     printf("%llu Montgomery multiplications with f64s and CIOS (SIMD) took                        %f ms\n", cost, avg_d);
+    printf("%llu Montgomery multiplications with f64s and CIOS (SIMD, both lanes) took            %f ms\n", cost * 2, avg_g);
     printf("%llu Montgomery multiplications with 30-bit limbs took                                %f ms\n", cost, avg_e);
     printf("%llu Montgomery multiplications with 29-bit limbs took                                %f ms\n", cost, avg_f);
+    printf("%llu Montgomery multiplications with 30-bit limbs (lazy reduction) took               %f ms\n", cost, avg_h);
+    printf("%llu Montgomery multiplications with 29-bit limbs (lazy reduction) took               %f ms\n", cost, avg_i);
+    printf("%llu Montgomery multiplications with 30-bit limbs (generated for this modulus) took    %f ms\n", cost, avg_j);
+    printf("%llu Montgomery multiplications with 29-bit limbs (generated for this modulus) took    %f ms\n", cost, avg_k);
+    printf("%llu Barrett multiplications with 32-bit limbs took                                   %f ms\n", cost, avg_m);
+    printf("%llu Barrett multiplications with 30-bit limbs took                                   %f ms\n", cost, avg_n);
+
+    run_batch_benchmarks(&ctx, cost, num_runs);
+    run_ct_benchmarks(&ctx, cost, num_runs);
+    run_dot_benchmarks(&ctx, cost, num_runs);
+    run_wide_benchmarks(&ctx, cost, num_runs);
+    run_sparse_benchmarks("the BLS12-377 scalar field", p_hex, mont_mul_9x30_fr, cost, num_runs);
+    run_sparse_benchmarks("0x12ac * 2^240 + 2^125 + 1",
+        "12ac000000000000000000000000000020000000000000000000000000000001",
+        mont_mul_9x30_p12ac, cost, num_runs);
+    run_sqr_benchmarks(&ctx, ar_hex, cost, num_runs);
+    run_p1_benchmarks(&ctx, ar_hex, cost, num_runs);
+    run_pow_benchmarks(&ctx, ar_hex, cost / 256 + 1, num_runs);
 }
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <assert.h>
+#include <emscripten.h>
+#include "../c/bigint.h"
+
+/*
+ * Times limbs_mul_schoolbook against one level of limbs_mul_karatsuba for n
+ * limbs of w bits. Each product feeds the low half of the next one's first
+ * operand, so the compiler can't hoist the work out of the loop.
+ */
+void run_mul_wide_benchmark(int n, int w, uint64_t cost, int num_runs) {
+    uint64_t mask = (1ULL << w) - 1;
+    uint64_t a[LIMBS_MUL_MAX], b[LIMBS_MUL_MAX];
+    uint64_t res_s[2 * LIMBS_MUL_MAX], res_k[2 * LIMBS_MUL_MAX];
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < n; i ++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        a[i] = (x >> 20) & mask;
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        b[i] = (x >> 20) & mask;
+    }
+
+    double avg_s = 0, avg_k = 0;
+    for (int r = 0; r < num_runs; r ++) {
+        uint64_t a_s[LIMBS_MUL_MAX], a_k[LIMBS_MUL_MAX];
+        memcpy(a_s, a, sizeof(a));
+        memcpy(a_k, a, sizeof(a));
+
+        double start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            limbs_mul_schoolbook(res_s, a_s, b, n, w);
+            memcpy(a_s, res_s, n * sizeof(uint64_t));
+        }
+        double end = emscripten_get_now();
+        avg_s += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            limbs_mul_karatsuba(res_k, a_k, b, n, w);
+            memcpy(a_k, res_k, n * sizeof(uint64_t));
+        }
+        end = emscripten_get_now();
+        avg_k += end - start;
+
+        assert(memcmp(res_s, res_k, 2 * n * sizeof(uint64_t)) == 0);
+    }
+    avg_s /= num_runs;
+    avg_k /= num_runs;
+
+    printf("%llu %2dx%d-bit products: schoolbook %f ms, Karatsuba %f ms (%fx)\n",
+        cost, n, w, avg_s, avg_k, avg_s / avg_k);
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t log_cost = 16;
+    if (argc > 1) {
+        log_cost = strtoull(argv[1], NULL, 0);
+    }
+    uint64_t cost = 1 << log_cost;
+    int num_runs = 3;
+
+    // About 256 bits in each layout
+    run_mul_wide_benchmark(8, 32, cost, num_runs);
+    run_mul_wide_benchmark(9, 30, cost, num_runs);
+    run_mul_wide_benchmark(13, 20, cost, num_runs);
+    run_mul_wide_benchmark(16, 16, cost, num_runs);
+
+    printf("limbs_mul uses Karatsuba from %d limbs\n", LIMBS_KARATSUBA_THRESHOLD);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <time.h>
+#include "../c/native.h"
+
+/*
+ * Benchmarks the 4 x 64-bit kernels in c/native.h. This is built with the
+ * host compiler rather than emcc (see the native targets in the Makefile), so
+ * it times with clock_gettime instead of emscripten_get_now. The timings are
+ * a native upper bound for the WASM kernels in benchmarks/bench_mont_mul.c.
+ */
+double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t log_cost = 16;
+    if (argc > 1) {
+        log_cost = strtoull(argv[1], NULL, 0);
+    }
+    uint64_t cost = 1 << log_cost;
+    int num_runs = 3;
+
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt256 p;
+    MontParams4x64 mp;
+    int result = hex_to_bigint256(p_hex, &p);
+    assert(result == 0);
+    result = mont_4x64_init(&mp, &p);
+    assert(result == 0);
+
+    // Pseudorandom operands in Montgomery form
+    BigInt_4_64 *in = malloc(cost * sizeof(BigInt_4_64));
+    BigInt_4_64 *out = malloc(cost * sizeof(BigInt_4_64));
+    BigInt_4_64 x = {{7, 0, 0, 0}};
+    BigInt_4_64 y = mont_mul_4x64(&mp.r2, &mp.r2, &mp.p, mp.n0);
+    for (uint64_t k = 0; k < cost; k ++) {
+        x = mont_mul_4x64(&x, &y, &mp.p, mp.n0);
+        in[k] = x;
+    }
+
+    double lat_mul = 0, thr_mul = 0, lat_sqr = 0, avg_add = 0, avg_sub = 0;
+    uint64_t sink = 0;
+    for (int i = 0; i < num_runs; i ++) {
+        // Dependent products, which measure latency
+        x = in[0];
+        double start = now_ms();
+        for (uint64_t k = 0; k < cost; k ++) {
+            x = mont_mul_4x64(&x, &y, &mp.p, mp.n0);
+        }
+        double end = now_ms();
+        lat_mul += end - start;
+        sink += x.v[0];
+
+        // Independent products, which measure throughput
+        start = now_ms();
+        for (uint64_t k = 0; k < cost; k ++) {
+            out[k] = mont_mul_4x64(&in[k], &y, &mp.p, mp.n0);
+        }
+        end = now_ms();
+        thr_mul += end - start;
+        sink += out[cost - 1].v[0];
+
+        x = in[0];
+        start = now_ms();
+        for (uint64_t k = 0; k < cost; k ++) {
+            x = mont_sqr_4x64(&x, &mp.p, mp.n0);
+        }
+        end = now_ms();
+        lat_sqr += end - start;
+        sink += x.v[0];
+
+        x = in[0];
+        start = now_ms();
+        for (uint64_t k = 0; k < cost; k ++) {
+            x = bigint_4_64_add_mod(&x, &in[k], &mp.p);
+        }
+        end = now_ms();
+        avg_add += end - start;
+        sink += x.v[0];
+
+        start = now_ms();
+        for (uint64_t k = 0; k < cost; k ++) {
+            x = bigint_4_64_sub_mod(&x, &in[k], &mp.p);
+        }
+        end = now_ms();
+        avg_sub += end - start;
+        sink += x.v[0];
+    }
+
+    printf("%" PRIu64 " dependent Montgomery multiplications with 64-bit limbs took   %f ms\n", cost, lat_mul / num_runs);
+    printf("%" PRIu64 " independent Montgomery multiplications with 64-bit limbs took %f ms\n", cost, thr_mul / num_runs);
+    printf("%" PRIu64 " dependent Montgomery squarings with 64-bit limbs took         %f ms\n", cost, lat_sqr / num_runs);
+    printf("%" PRIu64 " modular additions with 64-bit limbs took                      %f ms\n", cost, avg_add / num_runs);
+    printf("%" PRIu64 " modular subtractions with 64-bit limbs took                   %f ms\n", cost, avg_sub / num_runs);
+    printf("(checksum %" PRIu64 ")\n", sink);
+
+    free(in);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <assert.h>
+#include <emscripten.h>
+#include "../c/sqrt.h"
+#include "../c/gen/addchain_fr.h"
+
+/// Baseline square root with plain Tonelli-Shanks, which finds the order of
+/// a^t by repeated squaring, so it costs up to about s^2 / 2 squarings. Uses
+/// the (t - 1) / 2 exponent and the generator from ctx, but not its tables.
+bool reference_func_tonelli_shanks_9x30(
+    BigInt270 *res,
+    BigInt270 *ar,
+    SqrtCtx9x30 *ctx
+) {
+    BigInt270 p = ctx->p;
+    uint64_t mu = ctx->mu;
+
+    BigInt270 x = mont_pow_9x30(ar, &ctx->t_minus_1_over_2, &p, mu, &ctx->one);
+    BigInt270 u = mont_mul_9x30(ar, &x, &p, mu);
+    BigInt270 v = mont_mul_9x30(&u, &x, &p, mu);
+    // ctx->lo[0][1] = g^-1, which also generates the subgroup of order 2^s.
+    BigInt270 c = ctx->lo[0][1];
+    int m = ctx->s;
+
+    while (memcmp(&v, &ctx->one, sizeof(BigInt270)) != 0) {
+        // The least k such that v^(2^k) = 1
+        int k = 0;
+        BigInt270 y = v;
+        while (memcmp(&y, &ctx->one, sizeof(BigInt270)) != 0) {
+            y = mont_sqr_9x30(&y, &p, mu);
+            k ++;
+            if (k == m) {
+                return false;
+            }
+        }
+
+        BigInt270 b = c;
+        for (int i = 0; i < m - k - 1; i ++) {
+            b = mont_sqr_9x30(&b, &p, mu);
+        }
+        m = k;
+        c = mont_sqr_9x30(&b, &p, mu);
+        u = mont_mul_9x30(&u, &b, &p, mu);
+        v = mont_mul_9x30(&v, &c, &p, mu);
+    }
+    *res = u;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t log_cost = 10;
+    if (argc > 1) {
+        log_cost = strtoull(argv[1], NULL, 0);
+    }
+    uint64_t cost = 1 << log_cost;
+    int num_runs = 3;
+
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    // R = 2^270
+    char* r_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+    char* r3_hex = "03fda000539b9f03b5b23d888ba00b45b60b180f86657ef4e685aeb681854b2b";
+    // (p - 1) / 2
+    char* p_minus_1_over_2_hex = "0955b2af4d1652ab305a268f2e1bd800acd53b7f680000008508c00000000000";
+    uint64_t mu = 1073741823;
+
+    BigInt270 p, one, r3;
+    BigInt256 e;
+    int result;
+    result = hex_to_bigint270(p_hex, &p);
+    assert(result == 0);
+    result = hex_to_bigint270(r_hex, &one);
+    assert(result == 0);
+    result = hex_to_bigint270(r3_hex, &r3);
+    assert(result == 0);
+    result = hex_to_bigint256(p_minus_1_over_2_hex, &e);
+    assert(result == 0);
+
+    SqrtCtx9x30 *ctx = malloc(sizeof(SqrtCtx9x30));
+    double start = emscripten_get_now();
+    result = sqrt_ctx_9x30_init(ctx, &p, mu, &one, &addchain_fr_t_minus_1_over_2);
+    double end = emscripten_get_now();
+    assert(result == 0);
+    printf("sqrt_ctx_9x30_init took %f ms\n", end - start);
+
+    // Half of the inputs are squares and half are random.
+    BigInt270 *in = malloc(cost * sizeof(BigInt270));
+    BigInt270 x = bigint270_new();
+    x.v[0] = 7;
+    for (uint64_t k = 0; k < cost; k ++) {
+        x = mont_mul_9x30(&x, &r3, &p, mu);
+        in[k] = k % 2 == 0 ? mont_sqr_9x30(&x, &p, mu) : x;
+    }
+
+    BigInt270 res;
+    int count_a = 0, count_b = 0, count_c = 0;
+    double avg_a = 0, avg_b = 0, avg_c = 0;
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            count_a += reference_func_tonelli_shanks_9x30(&res, &in[k], ctx);
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+
+        ctx->chain = NULL;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            count_b += mont_sqrt_9x30(&res, &in[k], ctx);
+        }
+        end = emscripten_get_now();
+        avg_b += end - start;
+
+        ctx->chain = &addchain_fr_t_minus_1_over_2;
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            count_c += mont_sqrt_9x30(&res, &in[k], ctx);
+        }
+        end = emscripten_get_now();
+        avg_c += end - start;
+    }
+    assert(count_a == count_b && count_b == count_c);
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+    avg_c /= num_runs;
+
+    printf("%llu square roots with plain Tonelli-Shanks took        %f ms\n", cost, avg_a);
+    printf("%llu square roots with mont_sqrt_9x30 took              %f ms\n", cost, avg_b);
+    printf("%llu square roots with mont_sqrt_9x30 and a chain took  %f ms\n", cost, avg_c);
+    printf("Speedup: %fx\n", avg_a / avg_c);
+
+    count_a = 0, count_b = 0, count_c = 0;
+    avg_a = 0, avg_b = 0, avg_c = 0;
+    for (int i = 0; i < num_runs; i ++) {
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            x = mont_pow_9x30(&in[k], &e, &p, mu, &one);
+            count_a += memcmp(&x, &one, sizeof(BigInt270)) == 0;
+        }
+        end = emscripten_get_now();
+        avg_a += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            x = mont_pow_chain_9x30(&in[k], &addchain_fr_p_minus_1_over_2, &p, mu);
+            count_b += memcmp(&x, &one, sizeof(BigInt270)) == 0;
+        }
+        end = emscripten_get_now();
+        avg_b += end - start;
+
+        start = emscripten_get_now();
+        for (uint64_t k = 0; k < cost; k ++) {
+            count_c += legendre_9x30(&in[k], &p, mu, &one) == 1;
+        }
+        end = emscripten_get_now();
+        avg_c += end - start;
+    }
+    assert(count_a == count_b && count_b == count_c);
+    avg_a /= num_runs;
+    avg_b /= num_runs;
+    avg_c /= num_runs;
+
+    printf("%llu Legendre symbols with Euler's criterion took             %f ms\n", cost, avg_a);
+    printf("%llu Legendre symbols with Euler's criterion and a chain took %f ms\n", cost, avg_b);
+    printf("%llu Legendre symbols with legendre_9x30 took                 %f ms\n", cost, avg_c);
+    printf("Speedup: %fx\n", avg_a / avg_c);
+
+    free(in);
+    free(ctx);
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <assert.h>
+#include <emscripten.h>
+#include "../c/width.h"
+
+/*
+ * Prints a table with the latency and throughput of Montgomery multiplication
+ * and squaring for each limb width in c/width.h.
+ *
+ * Latency is measured on a chain of dependent products, and throughput on
+ * products of independent operands, so that the engine can overlap them.
+ * "rows" is the number of rows between normalisations of the accumulator,
+ * where 0 means the 32-bit kernel, which carries every product.
+ *
+ * Usage: bench_width [log_cost] [modulus in hex]
+ */
+int main(int argc, char *argv[]) {
+    uint64_t log_cost = 16;
+    if (argc > 1) {
+        log_cost = strtoull(argv[1], NULL, 0);
+    }
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    if (argc > 2) {
+        p_hex = argv[2];
+    }
+    uint64_t cost = 1 << log_cost;
+    int num_runs = 3;
+
+    BigInt256 p;
+    int result = hex_to_bigint256(p_hex, &p);
+    assert(result == 0);
+    printf("Modulus %s, %llu products per measurement, ns per product\n", p_hex, cost);
+    printf(" w  n  rows(mul) rows(sqr)  mul latency  mul throughput  sqr latency  sqr throughput\n");
+
+    uint64_t (*in)[MONT_WIDTH_MAX_LIMBS] = malloc(cost * sizeof(*in));
+    uint64_t (*out)[MONT_WIDTH_MAX_LIMBS] = malloc(cost * sizeof(*out));
+    uint64_t sink = 0;
+
+    for (size_t k = 0; k < NUM_MONT_WIDTH_KERNELS; k ++) {
+        const MontWidthKernel *kern = &mont_width_kernels[k];
+        MontWidthParams mp;
+        result = mont_width_params_init(&mp, &p, kern->w);
+        assert(result == 0);
+
+        // Pseudorandom operands in Montgomery form
+        uint64_t x[MONT_WIDTH_MAX_LIMBS] = {7};
+        uint64_t y[MONT_WIDTH_MAX_LIMBS];
+        kern->mul(y, mp.r2, mp.r2, mp.p, mp.mu);
+        for (uint64_t i = 0; i < cost; i ++) {
+            kern->mul(x, x, y, mp.p, mp.mu);
+            memcpy(in[i], x, sizeof(x));
+        }
+
+        double lat_mul = 0, thr_mul = 0, lat_sqr = 0, thr_sqr = 0;
+        for (int r = 0; r < num_runs; r ++) {
+            memcpy(x, in[0], sizeof(x));
+            double start = emscripten_get_now();
+            for (uint64_t i = 0; i < cost; i ++) {
+                kern->mul(x, x, y, mp.p, mp.mu);
+            }
+            double end = emscripten_get_now();
+            lat_mul += end - start;
+            sink += x[0];
+
+            start = emscripten_get_now();
+            for (uint64_t i = 0; i < cost; i ++) {
+                kern->mul(out[i], in[i], y, mp.p, mp.mu);
+            }
+            end = emscripten_get_now();
+            thr_mul += end - start;
+            sink += out[cost - 1][0];
+
+            memcpy(x, in[0], sizeof(x));
+            start = emscripten_get_now();
+            for (uint64_t i = 0; i < cost; i ++) {
+                kern->sqr(x, x, mp.p, mp.mu);
+            }
+            end = emscripten_get_now();
+            lat_sqr += end - start;
+            sink += x[0];
+
+            start = emscripten_get_now();
+            for (uint64_t i = 0; i < cost; i ++) {
+                kern->sqr(out[i], in[i], mp.p, mp.mu);
+            }
+            end = emscripten_get_now();
+            thr_sqr += end - start;
+            sink += out[cost - 1][0];
+        }
+
+        double scale = 1e6 / (num_runs * (double) cost);
+        printf("%2d %2d  %9llu %9llu  %11.2f  %14.2f  %11.2f  %14.2f\n",
+            kern->w, kern->n,
+            mont_width_rows(kern->w, 2), mont_width_rows(kern->w, 3),
+            lat_mul * scale, thr_mul * scale, lat_sqr * scale, thr_sqr * scale);
+    }
+
+    printf("(checksum %llu)\n", sink);
+    free(in);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "./mont.h"
+#include <stdint.h>
+
+// Barrett multiplication on canonical values.
+//
+// The kernels in mont.h work on values in Montgomery form, so code that mixes
+// them with canonical values (hash outputs, serialised elements, small
+// constants) pays for a conversion at each boundary. Barrett reduction
+// computes a * b mod p directly: with mu = floor(b^(2n) / p) precomputed, the
+// quotient of a * b by p is estimated from the top limbs of the product and
+// mu, and subtracted. It takes more limb products than Montgomery
+// multiplication, but no conversions.
+//
+// This follows Algorithm 14.42 of the Handbook of Applied Cryptography, with
+// the limbs of q1 * mu below column n - 1 left out.
+//
+// Done:
+// - Barrett multiplication with 32-bit and 30-bit limbs
+
+/// Constants for barrett_mul_8x32, with 8 limbs of 32 bits.
+typedef struct {
+    BigInt256 p;
+    BigInt256 p2;
+    /// floor(2^512 / p)
+    uint64_t mu[9];
+} BarrettParams8x32;
+
+/// Constants for barrett_mul_9x30, with 9 limbs of 30 bits.
+typedef struct {
+    BigInt270 p;
+    BigInt270 p2;
+    /// floor(2^540 / p)
+    uint64_t mu[10];
+} BarrettParams9x30;
+
+typedef struct {
+    BarrettParams8x32 w32;
+    BarrettParams9x30 w30;
+} BarrettCtx;
+
+/// Stores floor(2^(2 * n * w) / p) in the n + 1 limbs of mu, by long
+/// division, one bit at a time. p has n limbs of w bits, and its top limb is
+/// not zero.
+static inline void barrett_init_mu(uint64_t *mu, const uint64_t *p, int n, int w) {
+    uint64_t rem[10] = {1};
+    uint64_t d[10];
+    uint64_t p_wide[10] = {0};
+    for (int i = 0; i < n; i ++) {
+        p_wide[i] = p[i];
+    }
+    for (int i = 0; i < n + 1; i ++) {
+        mu[i] = 0;
+    }
+
+    // rem stays below p, so 2 * rem fits in n + 1 limbs.
+    for (int b = 2 * n * w - 1; b >= 0; b --) {
+        limbs_add(rem, rem, rem, n + 1, w);
+        if (limbs_sub(d, rem, p_wide, n + 1, w) == 0) {
+            for (int i = 0; i < n + 1; i ++) {
+                rem[i] = d[i];
+            }
+            mu[b / w] |= 1ULL << (b % w);
+        }
+    }
+}
+
+/// Computes every constant in ctx for the modulus p. Returns 0 on success, and
+/// -1 if bigint_is_valid_modulus rejects p.
+int barrett_ctx_init(BarrettCtx *ctx, BigInt256 *p) {
+    if (!bigint_is_valid_modulus(p)) {
+        return -1;
+    }
+
+    BigInt256 p2;
+    bigint_add(&p2, p, p);
+
+    ctx->w32.p = *p;
+    ctx->w32.p2 = p2;
+    barrett_init_mu(ctx->w32.mu, p->v, 8, 32);
+
+    bigint256_to_bigint270(&ctx->w30.p, p);
+    bigint256_to_bigint270(&ctx->w30.p2, &p2);
+    barrett_init_mu(ctx->w30.mu, ctx->w30.p.v, 9, 30);
+    return 0;
+}
+
+/// Like barrett_ctx_init, but takes p as a 64-character big-endian hex string.
+int barrett_ctx_init_hex(BarrettCtx *ctx, const char *p_hex) {
+    BigInt256 p;
+    if (hex_to_bigint256(p_hex, &p) != 0) {
+        return -1;
+    }
+    return barrett_ctx_init(ctx, &p);
+}
+
+/// Adds the products a[i] * b[j] with min_col <= i + j <= max_col into res,
+/// which has room for max_col + 2 limbs of w bits. Carries out of column
+/// max_col are dropped, and so are the products below min_col, so the limbs
+/// of res below min_col are not meaningful.
+///
+/// With 32-bit limbs, each row is carried as it goes, as in mont_mul_cios.
+/// With narrower limbs, a column of up to 10 products fits in 64 bits, so the
+/// products are added up without carries, as in mont_mul_9x30, and the
+/// columns are carried once at the end.
+static inline void barrett_mul_limbs(
+    uint64_t *res,
+    const uint64_t *a,
+    int na,
+    const uint64_t *b,
+    int nb,
+    int w,
+    int min_col,
+    int max_col
+) {
+    const uint64_t mask = (1ULL << w) - 1;
+    for (int i = 0; i < max_col + 2; i ++) {
+        res[i] = 0;
+    }
+
+    if (w < 32) {
+        for (int i = 0; i < na; i ++) {
+            int j_min = min_col - i > 0 ? min_col - i : 0;
+            int j_max = max_col - i < nb - 1 ? max_col - i : nb - 1;
+            for (int j = j_min; j <= j_max; j ++) {
+                res[i + j] += a[i] * b[j];
+            }
+        }
+        uint64_t c = 0;
+        for (int k = min_col; k <= max_col; k ++) {
+            c += res[k];
+            res[k] = c & mask;
+            c >>= w;
+        }
+        res[max_col + 1] = c;
+        return;
+    }
+
+    for (int i = 0; i < na; i ++) {
+        int j_min = min_col - i > 0 ? min_col - i : 0;
+        int j_max = max_col - i < nb - 1 ? max_col - i : nb - 1;
+        uint64_t c = 0, cs;
+        for (int j = j_min; j <= j_max; j ++) {
+            cs = res[i + j] + a[i] * b[j] + c;
+            res[i + j] = cs & mask;
+            c = cs >> w;
+        }
+        if (j_max >= j_min && i + j_max + 1 <= max_col + 1) {
+            res[i + j_max + 1] += c;
+        }
+    }
+}
+
+/// Computes a * b mod p for a and b in [0, p), where p has n limbs of w bits.
+///
+/// With x = a * b and base b = 2^w, q3 = floor(floor(x / b^(n - 1)) * mu /
+/// b^(n + 1)) is at most 2 below floor(x / p), and leaving out the columns of
+/// q1 * mu below n - 1 loses less than 1 more. r = x - q3 * p is then in
+/// [0, 4p), and is computed mod b^(n + 1), which is larger. Two conditional
+/// subtractions, of 2p and then p, bring it into [0, p). This needs 4p to fit
+/// in n limbs, so p < 2^254 with 32-bit limbs.
+static inline void barrett_mul_limbs_mod(
+    uint64_t *res,
+    const uint64_t *a,
+    const uint64_t *b,
+    const uint64_t *p,
+    const uint64_t *p2,
+    const uint64_t *mu,
+    int n,
+    int w
+) {
+    const uint64_t mask = (1ULL << w) - 1;
+    uint64_t x[19], q2[21], qp[20];
+
+    // x = a * b, in 2n limbs
+    limbs_mul(x, a, b, n, w);
+
+    // q3 = limbs n + 1 to 2n + 1 of q1 * mu, where q1 = limbs n - 1 to 2n of x
+    const uint64_t *q1 = &x[n - 1];
+    barrett_mul_limbs(q2, q1, n + 1, mu, n + 1, w, n - 1, 2 * n + 1);
+    const uint64_t *q3 = &q2[n + 1];
+
+    // r = x - q3 * p mod b^(n + 1)
+    barrett_mul_limbs(qp, q3, n + 1, p, n, w, 0, n);
+    uint64_t borrow = 0, diff;
+    for (int i = 0; i < n; i ++) {
+        diff = x[i] - qp[i] - borrow;
+        res[i] = diff & mask;
+        borrow = diff >> 63;
+    }
+
+    limbs_reduce(res, res, p2, n, w);
+    limbs_reduce(res, res, p, n, w);
+}
+
+/// Computes a * b mod p with 32-bit limbs, for canonical a and b in [0, p).
+BigInt256 barrett_mul_8x32(
+    BigInt256 *a,
+    BigInt256 *b,
+    BarrettParams8x32 *bp
+) {
+    BigInt256 res;
+    barrett_mul_limbs_mod(res.v, a->v, b->v, bp->p.v, bp->p2.v, bp->mu, 8, 32);
+    return res;
+}
+
+/// Computes a * b mod p with 30-bit limbs, for canonical a and b in [0, p).
+BigInt270 barrett_mul_9x30(
+    BigInt270 *a,
+    BigInt270 *b,
+    BarrettParams9x30 *bp
+) {
+    BigInt270 res;
+    barrett_mul_limbs_mod(res.v, a->v, b->v, bp->p.v, bp->p2.v, bp->mu, 9, 30);
+    return res;
+}
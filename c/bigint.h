@@ -1,3 +1,5 @@
+#pragma once
+
 // TODO: implement:
 // - functions using inline assembly?: https://webassembly.github.io/wabt/demo/wat2wasm/
 
@@ -43,6 +45,18 @@ typedef struct {
 
 typedef BigInt_8_32 BigInt256;
 
+// Full-width products: 16 x 32-bit limbs and 18 x 30-bit limbs, as returned
+// by bigint_mul_wide and bigint270_mul_wide.
+typedef struct {
+    uint64_t v[16];
+} BigInt_16_32;
+typedef BigInt_16_32 BigInt512;
+
+typedef struct {
+    uint64_t v[18];
+} BigInt_18_30;
+typedef BigInt_18_30 BigInt540;
+
 /*
  * Returns a pseudorandomly generated BigInt_8_32.
  */
@@ -372,3 +386,537 @@ char* bigint261_to_hex(const BigInt261 *val) {
 
     return hex_str;
 }
+
+/*
+ * Stores a >> shift in result, repacked from 30-bit limbs into 32-bit limbs.
+ * Bits above bit 255 of the shifted value are dropped.
+ */
+void bigint270_to_bigint256_shr(BigInt256 *result, const BigInt270 *a, int shift) {
+    for (int i = 0; i < 8; i ++) {
+        result->v[i] = 0;
+    }
+    for (int b = 0; b < 256 && b + shift < 270; b ++) {
+        int src = b + shift;
+        uint64_t bit = (a->v[src / 30] >> (src % 30)) & 1;
+        result->v[b / 32] |= bit << (b % 32);
+    }
+}
+
+/*
+ * Stores a in result, repacked from 32-bit limbs into 30-bit limbs.
+ */
+void bigint256_to_bigint270(BigInt270 *result, const BigInt256 *a) {
+    for (int i = 0; i < 9; i ++) {
+        result->v[i] = 0;
+    }
+    for (int b = 0; b < 256; b ++) {
+        uint64_t bit = (a->v[b / 32] >> (b % 32)) & 1;
+        result->v[b / 30] |= bit << (b % 30);
+    }
+}
+
+/*
+ * Stores a in result, repacked from 32-bit limbs into 29-bit limbs.
+ */
+void bigint256_to_bigint261(BigInt261 *result, const BigInt256 *a) {
+    for (int i = 0; i < 9; i ++) {
+        result->v[i] = 0;
+    }
+    for (int b = 0; b < 256; b ++) {
+        uint64_t bit = (a->v[b / 32] >> (b % 32)) & 1;
+        result->v[b / 29] |= bit << (b % 29);
+    }
+}
+
+/*
+ * Helpers for the modular arithmetic functions below. Each operates on n
+ * limbs of w bits each, stored in uint64_t words in little-endian order. res
+ * may alias a or b.
+ */
+
+/*
+ * Stores a + b in res and returns the carry out of the top limb.
+ */
+static inline uint64_t limbs_add(uint64_t *res, const uint64_t *a, const uint64_t *b, int n, int w) {
+    uint64_t mask = (1ULL << w) - 1;
+    uint64_t c = 0;
+    for (int i = 0; i < n; i ++) {
+        c = a[i] + b[i] + c;
+        res[i] = c & mask;
+        c >>= w;
+    }
+    return c;
+}
+
+/*
+ * Stores a - b in res and returns the borrow out of the top limb.
+ */
+static inline uint64_t limbs_sub(uint64_t *res, const uint64_t *a, const uint64_t *b, int n, int w) {
+    uint64_t mask = (1ULL << w) - 1;
+    uint64_t borrow = 0;
+    for (int i = 0; i < n; i ++) {
+        uint64_t diff = a[i] - b[i] - borrow;
+        res[i] = diff & mask;
+        borrow = diff >> 63;
+    }
+    return borrow;
+}
+
+/*
+ * Stores a + (b & mask) in res, where mask is either all zeroes or all ones,
+ * and discards the carry.
+ */
+static inline void limbs_add_masked(uint64_t *res, const uint64_t *a, const uint64_t *b, uint64_t mask, int n, int w) {
+    uint64_t limb_mask = (1ULL << w) - 1;
+    uint64_t c = 0;
+    for (int i = 0; i < n; i ++) {
+        c = a[i] + (b[i] & mask) + c;
+        res[i] = c & limb_mask;
+        c >>= w;
+    }
+}
+
+/*
+ * Stores a - m in res if a >= m, and a otherwise. Both a - m and the borrow
+ * are always computed, and the result is selected with a mask rather than a
+ * branch.
+ */
+static inline void limbs_reduce(uint64_t *res, const uint64_t *a, const uint64_t *m, int n, int w) {
+    uint64_t d[9];
+    uint64_t borrow = limbs_sub(d, a, m, n, w);
+    uint64_t keep_a = -borrow;
+    for (int i = 0; i < n; i ++) {
+        res[i] = (a[i] & keep_a) | (d[i] & ~keep_a);
+    }
+}
+
+/*
+ * Stores (a + b) mod p in res, for a and b in [0, p).
+ */
+static inline void limbs_add_mod(uint64_t *res, const uint64_t *a, const uint64_t *b, const uint64_t *p, int n, int w) {
+    uint64_t t[9];
+    uint64_t d[9];
+    uint64_t c = limbs_add(t, a, b, n, w);
+    uint64_t borrow = limbs_sub(d, t, p, n, w);
+    // Keep t only if the sum did not carry out and t < p
+    uint64_t keep_t = -(borrow & (c ^ 1));
+    for (int i = 0; i < n; i ++) {
+        res[i] = (t[i] & keep_t) | (d[i] & ~keep_t);
+    }
+}
+
+/*
+ * Stores (a - b) mod p in res, for a and b in [0, p).
+ */
+static inline void limbs_sub_mod(uint64_t *res, const uint64_t *a, const uint64_t *b, const uint64_t *p, int n, int w) {
+    uint64_t t[9];
+    uint64_t borrow = limbs_sub(t, a, b, n, w);
+    limbs_add_masked(res, t, p, -borrow, n, w);
+}
+
+/*
+ * Stores a / 2 mod p in res, for a in [0, p) and odd p.
+ */
+static inline void limbs_halve_mod(uint64_t *res, const uint64_t *a, const uint64_t *p, int n, int w) {
+    uint64_t t[9];
+    uint64_t limb_mask = (1ULL << w) - 1;
+    uint64_t odd = -(a[0] & 1);
+
+    // Add p if a is odd, keeping the carry out of the top limb
+    uint64_t c = 0;
+    for (int i = 0; i < n; i ++) {
+        c = a[i] + (p[i] & odd) + c;
+        t[i] = c & limb_mask;
+        c >>= w;
+    }
+
+    for (int i = 0; i < n - 1; i ++) {
+        res[i] = (t[i] >> 1) | ((t[i + 1] & 1) << (w - 1));
+    }
+    res[n - 1] = (t[n - 1] >> 1) | (c << (w - 1));
+}
+
+/*
+ * Returns all ones if the n limbs of a are all zero, and 0 otherwise.
+ */
+static inline uint64_t limbs_zero_mask(const uint64_t *a, int n) {
+    uint64_t acc = 0;
+    for (int i = 0; i < n; i ++) {
+        acc |= a[i];
+    }
+    // acc | -acc has its top bit set unless acc is 0
+    return ((acc | (0 - acc)) >> 63) - 1;
+}
+
+/*
+ * Stores b in res where mask is all ones, and a where it is all zeroes.
+ */
+static inline void limbs_select(uint64_t *res, const uint64_t *a, const uint64_t *b, uint64_t mask, int n) {
+    for (int i = 0; i < n; i ++) {
+        res[i] = (a[i] & ~mask) | (b[i] & mask);
+    }
+}
+
+/*
+ * Stores a * k in res and returns the limb that carries out of the top, for
+ * k < 2^20. Each limb product is below 2^52, so it fits with the carry.
+ */
+static inline uint64_t limbs_mul_small(uint64_t *res, const uint64_t *a, uint64_t k, int n, int w) {
+    uint64_t mask = (1ULL << w) - 1;
+    uint64_t c = 0;
+    for (int i = 0; i < n; i ++) {
+        c = a[i] * k + c;
+        res[i] = c & mask;
+        c >>= w;
+    }
+    return c;
+}
+
+/*
+ * Returns floor(x / 2^(n * w - 44)), where x is a plus top * 2^(n * w) and is
+ * below 2^(n * w + 20), so the result fits in 64 bits.
+ */
+static inline uint64_t limbs_top_44(const uint64_t *a, uint64_t top, int n, int w) {
+    int s = n * w - 44;
+    uint64_t res = top << 44;
+    for (int i = n - 1; i >= 0 && i * w + w > s; i --) {
+        int off = i * w - s;
+        res += off >= 0 ? a[i] << off : a[i] >> -off;
+    }
+    return res;
+}
+
+/*
+ * Stores a * k mod p in res, for a in [0, p) and k < 2^20. p must be at least
+ * 2^(n * w - 24), which holds for 253-bit moduli in every limb width here.
+ *
+ * Let s = n * w - 44. With t = a * k, the quotient is estimated as
+ * q = floor((t >> s) / ((p >> s) + 1)), which is never too large, and is at
+ * most (k + 1) / ((p >> s) + 1) + 1 below floor(t / p). As p >> s is at least
+ * 2^20, q is at most 1 too small, so t - q * p is in [0, 2p) and one
+ * conditional subtraction finishes the reduction.
+ */
+static inline void limbs_mul_small_mod(uint64_t *res, const uint64_t *a, uint64_t k, const uint64_t *p, int n, int w) {
+    uint64_t mask = (1ULL << w) - 1;
+    uint64_t t[9];
+    uint64_t c = limbs_mul_small(t, a, k, n, w);
+    uint64_t q = limbs_top_44(t, c, n, w) / (limbs_top_44(p, 0, n, w) + 1);
+
+    // t - q * p is below 2p < 2^(n * w), so the limbs that carry out cancel.
+    // The signed carry holds the borrow.
+    int64_t d = 0;
+    for (int i = 0; i < n; i ++) {
+        d += (int64_t) t[i] - (int64_t) (q * p[i]);
+        t[i] = (uint64_t) d & mask;
+        d >>= w;
+    }
+    limbs_reduce(res, t, p, n, w);
+}
+
+/*
+ * Non-modular multiplication. limbs_mul stores the full 2n-limb product of
+ * two n-limb values, for use by reductions that take the product as a whole
+ * (separated-operand-scanning Montgomery, Barrett, or reduction of a wide
+ * value) rather than interleaving it with the multiplication.
+ *
+ * Below LIMBS_KARATSUBA_THRESHOLD limbs this is schoolbook multiplication.
+ * From there on, Karatsuba's method trades one of the four half-size products
+ * for a few additions and subtractions, and recurses until the halves are
+ * below the threshold. n must be at most LIMBS_MUL_MAX, and the threshold
+ * must be at least 4 for the recursion to shrink.
+ *
+ * With 64-bit limb products, the additions cost more than the product they
+ * save at these sizes: benchmarks/bench_mul_wide.c measures one level of
+ * Karatsuba at 0.5x the speed of schoolbook at 8 and 9 limbs and 0.8x at 16.
+ * The default threshold is therefore above LIMBS_MUL_MAX, so limbs_mul is
+ * schoolbook throughout. It can be lowered with -D to try other platforms.
+ */
+#define LIMBS_MUL_MAX 16
+#ifndef LIMBS_KARATSUBA_THRESHOLD
+#define LIMBS_KARATSUBA_THRESHOLD (LIMBS_MUL_MAX + 1)
+#endif
+
+/*
+ * Stores the 2n-limb product a * b in res, with one row of limb products per
+ * limb of a. The row carries keep every sum below 2^64 for limbs of up to 32
+ * bits. res must not alias a or b.
+ */
+static inline void limbs_mul_schoolbook(uint64_t *res, const uint64_t *a, const uint64_t *b, int n, int w) {
+    uint64_t mask = (1ULL << w) - 1;
+    for (int i = 0; i < 2 * n; i ++) {
+        res[i] = 0;
+    }
+    for (int i = 0; i < n; i ++) {
+        uint64_t c = 0;
+        for (int j = 0; j < n; j ++) {
+            c = res[i + j] + a[i] * b[j] + c;
+            res[i + j] = c & mask;
+            c >>= w;
+        }
+        res[i + n] = c;
+    }
+}
+
+/*
+ * Stores the 2n-limb product a * b in res, with one level of Karatsuba's
+ * method, for n >= 3. With a and b split into a low half of h = n / 2 limbs
+ * and a high half of m = n - h limbs, z0 = a0 * b0, z2 = a1 * b1 and
+ * z1 = (a0 + a1) * (b0 + b1) - z0 - z2, and a * b = z0 + z1 * B^h + z2 * B^2h.
+ * The sums a0 + a1 and b0 + b1 take m + 1 limbs, with a top limb of 0 or 1.
+ * The three half-size products go through limbs_mul, so they recurse only if
+ * they are at or above the threshold. res must not alias a or b.
+ */
+static inline void limbs_mul(uint64_t *res, const uint64_t *a, const uint64_t *b, int n, int w);
+
+static void limbs_mul_karatsuba(uint64_t *res, const uint64_t *a, const uint64_t *b, int n, int w) {
+    int h = n / 2;
+    int m = n - h;
+    uint64_t sa[LIMBS_MUL_MAX / 2 + 2] = {0}, sb[LIMBS_MUL_MAX / 2 + 2] = {0};
+    uint64_t z1[LIMBS_MUL_MAX + 4];
+
+    // sa = a0 + a1 and sb = b0 + b1, with a0 and b0 zero-extended to m limbs
+    for (int i = 0; i < h; i ++) {
+        sa[i] = a[i];
+        sb[i] = b[i];
+    }
+    sa[m] = limbs_add(sa, sa, &a[h], m, w);
+    sb[m] = limbs_add(sb, sb, &b[h], m, w);
+
+    // z0 and z2 go straight into res
+    limbs_mul(res, a, b, h, w);
+    limbs_mul(&res[2 * h], &a[h], &b[h], m, w);
+    limbs_mul(z1, sa, sb, m + 1, w);
+
+    // z1 -= z0 + z2, in one pass with a signed borrow. The difference is
+    // a0 * b1 + a1 * b0, so it is not negative.
+    uint64_t mask = (1ULL << w) - 1;
+    int64_t d = 0;
+    for (int i = 0; i < 2 * m + 2; i ++) {
+        d += (int64_t) z1[i];
+        d -= i < 2 * h ? (int64_t) res[i] : 0;
+        d -= i < 2 * m ? (int64_t) res[2 * h + i] : 0;
+        z1[i] = (uint64_t) d & mask;
+        d >>= w;
+    }
+
+    // res += z1 * B^h. The sum is a * b, so the carry stops within 2n limbs.
+    uint64_t c = 0;
+    for (int i = h; i < 2 * n; i ++) {
+        c += res[i] + (i - h < 2 * m + 2 ? z1[i - h] : 0);
+        res[i] = c & mask;
+        c >>= w;
+    }
+}
+
+/*
+ * Stores the 2n-limb product a * b in res, choosing schoolbook or Karatsuba
+ * multiplication by the number of limbs. res must not alias a or b.
+ */
+static inline void limbs_mul(uint64_t *res, const uint64_t *a, const uint64_t *b, int n, int w) {
+    if (n < LIMBS_KARATSUBA_THRESHOLD) {
+        limbs_mul_schoolbook(res, a, b, n, w);
+    } else {
+        limbs_mul_karatsuba(res, a, b, n, w);
+    }
+}
+
+/*
+ * Modular addition, subtraction, negation, doubling, halving and
+ * multiplication by small integers.
+ *
+ * The *_mod functions take inputs in [0, p) and return outputs in [0, p).
+ * *_mul_small_mod multiplies by an integer k < 2^20, such as a curve
+ * coefficient, with one pass over the limbs and a single quotient estimate
+ * instead of a full Montgomery product. k is not in Montgomery form, so a
+ * Montgomery-form input gives a Montgomery-form output.
+ *
+ * The lazy functions skip the conditional subtraction and leave results in a
+ * wider range, which the headroom between p and the capacity of the limbs
+ * (e.g. 2^253 vs 2^270) can absorb. This is useful when several additions and
+ * subtractions are chained before a Montgomery multiplication:
+ * - *_add_lazy returns a + b, so inputs in [0, 2p) give outputs in [0, 4p).
+ * - *_sub_lazy returns a - b + 2p, given p2 = 2p, so inputs in [0, 2p) give
+ *   outputs in (0, 4p).
+ * - *_reduce subtracts m once if the input is at least m. With m = 2p it maps
+ *   [0, 4p) to [0, 2p), and with m = p it maps [0, 2p) to [0, p).
+ * These require 4p to be less than the capacity of the limbs, which holds for
+ * moduli of up to 253 bits.
+ */
+
+/*
+ * Stores a + b in result and returns the carry.
+ */
+uint64_t bigint_add(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *b) {
+    return limbs_add(result->v, a->v, b->v, 8, 32);
+}
+
+void bigint_add_mod(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *b, const BigInt_8_32 *p) {
+    limbs_add_mod(result->v, a->v, b->v, p->v, 8, 32);
+}
+
+void bigint_sub_mod(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *b, const BigInt_8_32 *p) {
+    limbs_sub_mod(result->v, a->v, b->v, p->v, 8, 32);
+}
+
+void bigint_neg_mod(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *p) {
+    BigInt_8_32 zero = bigint_new();
+    limbs_sub_mod(result->v, zero.v, a->v, p->v, 8, 32);
+}
+
+void bigint_double_mod(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *p) {
+    limbs_add_mod(result->v, a->v, a->v, p->v, 8, 32);
+}
+
+void bigint_halve_mod(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *p) {
+    limbs_halve_mod(result->v, a->v, p->v, 8, 32);
+}
+
+void bigint_mul_small_mod(BigInt_8_32 *result, const BigInt_8_32 *a, uint64_t k, const BigInt_8_32 *p) {
+    limbs_mul_small_mod(result->v, a->v, k, p->v, 8, 32);
+}
+
+void bigint_add_lazy(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *b) {
+    limbs_add(result->v, a->v, b->v, 8, 32);
+}
+
+void bigint_sub_lazy(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *b, const BigInt_8_32 *p2) {
+    limbs_add(result->v, a->v, p2->v, 8, 32);
+    limbs_sub(result->v, result->v, b->v, 8, 32);
+}
+
+void bigint_reduce(BigInt_8_32 *result, const BigInt_8_32 *a, const BigInt_8_32 *m) {
+    limbs_reduce(result->v, a->v, m->v, 8, 32);
+}
+
+/*
+ * Returns true if p is odd, p >= 3, and p < 2^254, so that 4p fits in 256
+ * bits. These are the moduli that mont_ctx_init and the other *_init
+ * functions accept.
+ */
+bool bigint_is_valid_modulus(const BigInt_8_32 *p) {
+    BigInt_8_32 three = bigint_new();
+    three.v[0] = 3;
+    return (p->v[0] & 1) == 1 && !bigint_gt(&three, p) && (p->v[7] >> 30) == 0;
+}
+
+/*
+ * Returns 2^k mod p, computed by doubling.
+ */
+BigInt_8_32 bigint_pow2_mod(int k, const BigInt_8_32 *p) {
+    BigInt_8_32 x = bigint_new();
+    x.v[0] = 1;
+    for (int i = 0; i < k; i ++) {
+        bigint_double_mod(&x, &x, p);
+    }
+    return x;
+}
+
+/*
+ * Returns a^-1 mod 2^64 for odd a. Each Newton iteration doubles the number of
+ * correct bits, starting from 3, as a * a = 1 mod 8.
+ */
+uint64_t inv_mod_2_64(uint64_t a) {
+    uint64_t inv = a;
+    for (int i = 0; i < 5; i ++) {
+        inv *= 2 - a * inv;
+    }
+    return inv;
+}
+
+uint64_t bigint261_add(BigInt261 *result, const BigInt261 *a, const BigInt261 *b) {
+    return limbs_add(result->v, a->v, b->v, 9, 29);
+}
+
+void bigint261_add_mod(BigInt261 *result, const BigInt261 *a, const BigInt261 *b, const BigInt261 *p) {
+    limbs_add_mod(result->v, a->v, b->v, p->v, 9, 29);
+}
+
+void bigint261_sub_mod(BigInt261 *result, const BigInt261 *a, const BigInt261 *b, const BigInt261 *p) {
+    limbs_sub_mod(result->v, a->v, b->v, p->v, 9, 29);
+}
+
+void bigint261_neg_mod(BigInt261 *result, const BigInt261 *a, const BigInt261 *p) {
+    BigInt261 zero = bigint261_new();
+    limbs_sub_mod(result->v, zero.v, a->v, p->v, 9, 29);
+}
+
+void bigint261_double_mod(BigInt261 *result, const BigInt261 *a, const BigInt261 *p) {
+    limbs_add_mod(result->v, a->v, a->v, p->v, 9, 29);
+}
+
+void bigint261_halve_mod(BigInt261 *result, const BigInt261 *a, const BigInt261 *p) {
+    limbs_halve_mod(result->v, a->v, p->v, 9, 29);
+}
+
+void bigint261_mul_small_mod(BigInt261 *result, const BigInt261 *a, uint64_t k, const BigInt261 *p) {
+    limbs_mul_small_mod(result->v, a->v, k, p->v, 9, 29);
+}
+
+void bigint261_add_lazy(BigInt261 *result, const BigInt261 *a, const BigInt261 *b) {
+    limbs_add(result->v, a->v, b->v, 9, 29);
+}
+
+void bigint261_sub_lazy(BigInt261 *result, const BigInt261 *a, const BigInt261 *b, const BigInt261 *p2) {
+    limbs_add(result->v, a->v, p2->v, 9, 29);
+    limbs_sub(result->v, result->v, b->v, 9, 29);
+}
+
+void bigint261_reduce(BigInt261 *result, const BigInt261 *a, const BigInt261 *m) {
+    limbs_reduce(result->v, a->v, m->v, 9, 29);
+}
+
+uint64_t bigint270_add(BigInt270 *result, const BigInt270 *a, const BigInt270 *b) {
+    return limbs_add(result->v, a->v, b->v, 9, 30);
+}
+
+void bigint270_add_mod(BigInt270 *result, const BigInt270 *a, const BigInt270 *b, const BigInt270 *p) {
+    limbs_add_mod(result->v, a->v, b->v, p->v, 9, 30);
+}
+
+void bigint270_sub_mod(BigInt270 *result, const BigInt270 *a, const BigInt270 *b, const BigInt270 *p) {
+    limbs_sub_mod(result->v, a->v, b->v, p->v, 9, 30);
+}
+
+void bigint270_neg_mod(BigInt270 *result, const BigInt270 *a, const BigInt270 *p) {
+    BigInt270 zero = bigint270_new();
+    limbs_sub_mod(result->v, zero.v, a->v, p->v, 9, 30);
+}
+
+void bigint270_double_mod(BigInt270 *result, const BigInt270 *a, const BigInt270 *p) {
+    limbs_add_mod(result->v, a->v, a->v, p->v, 9, 30);
+}
+
+void bigint270_halve_mod(BigInt270 *result, const BigInt270 *a, const BigInt270 *p) {
+    limbs_halve_mod(result->v, a->v, p->v, 9, 30);
+}
+
+void bigint270_mul_small_mod(BigInt270 *result, const BigInt270 *a, uint64_t k, const BigInt270 *p) {
+    limbs_mul_small_mod(result->v, a->v, k, p->v, 9, 30);
+}
+
+void bigint270_add_lazy(BigInt270 *result, const BigInt270 *a, const BigInt270 *b) {
+    limbs_add(result->v, a->v, b->v, 9, 30);
+}
+
+void bigint270_sub_lazy(BigInt270 *result, const BigInt270 *a, const BigInt270 *b, const BigInt270 *p2) {
+    limbs_add(result->v, a->v, p2->v, 9, 30);
+    limbs_sub(result->v, result->v, b->v, 9, 30);
+}
+
+void bigint270_reduce(BigInt270 *result, const BigInt270 *a, const BigInt270 *m) {
+    limbs_reduce(result->v, a->v, m->v, 9, 30);
+}
+
+/*
+ * Stores the full 512-bit product a * b in result, without reduction.
+ */
+void bigint_mul_wide(BigInt512 *result, const BigInt_8_32 *a, const BigInt_8_32 *b) {
+    limbs_mul(result->v, a->v, b->v, 8, 32);
+}
+
+/*
+ * Stores the full 540-bit product a * b in result, without reduction.
+ */
+void bigint270_mul_wide(BigInt540 *result, const BigInt270 *a, const BigInt270 *b) {
+    limbs_mul(result->v, a->v, b->v, 9, 30);
+}
@@ -19,6 +19,34 @@ BigInt_5_51 bigintf_new() {
     return result;
 }
 
+// Two BigIntF255 values interleaved lane-by-lane: lane 0 of each f128 holds a
+// limb of the first value, and lane 1 holds the same limb of the second value.
+typedef BigInt_5_51 BigIntF255x2;
+
+/*
+ * Packs the lane-0 limbs of a and b into a single BigIntF255x2. The raw bits
+ * of each limb are copied, so this works on both the double form (inputs to
+ * mont_mul_cios_f64_simd_x2) and the integer form (its outputs).
+ */
+BigIntF255x2 bigintf255_pack(const BigIntF255 *a, const BigIntF255 *b) {
+    BigIntF255x2 res;
+    for (int i = 0; i < 5; i ++) {
+        res.v[i] = i64x2_make(i64x2_extract_l(a->v[i]), i64x2_extract_l(b->v[i]));
+    }
+    return res;
+}
+
+/*
+ * Splits a BigIntF255x2 into two BigIntF255 values whose limbs are in lane 0,
+ * with lane 1 set to zero. The raw bits of each limb are copied.
+ */
+void bigintf255_unpack(const BigIntF255x2 *x, BigIntF255 *a, BigIntF255 *b) {
+    for (int i = 0; i < 5; i ++) {
+        a->v[i] = i64x2_make(i64x2_extract_l(x->v[i]), 0);
+        b->v[i] = i64x2_make(i64x2_extract_h(x->v[i]), 0);
+    }
+}
+
 //TODO
 BigInt_5_51 bigintf_sub(
     BigInt_5_51 *a,
@@ -37,6 +65,174 @@ BigInt_5_51 bigintf_sub(
     return res;
 }
 
+/*
+ * Modular arithmetic on BigIntF255 values in double form, i.e. resolved
+ * values with a 51-bit limb in lane 0 of each f128, as returned by
+ * hex_to_bigintf255() and resolve_bigintf(). The limbs are converted to
+ * integers, operated on, and converted back.
+ *
+ * The *_mod functions take inputs in [0, p) and return outputs in [0, p). The
+ * lazy functions mirror those in bigint.h: *_add_lazy returns a + b,
+ * *_sub_lazy returns a - b + 2p given p2 = 2p, and *_reduce subtracts m once
+ * if the input is at least m. 4p fits in 255 bits for moduli of up to 253
+ * bits.
+ */
+
+static inline void bigintf255_get_limbs(const BigIntF255 *x, uint64_t *limbs) {
+    for (int i = 0; i < 5; i ++) {
+        limbs[i] = (uint64_t) f64x2_extract_l(x->v[i]);
+    }
+}
+
+static inline void bigintf255_set_limbs(BigIntF255 *x, const uint64_t *limbs) {
+    for (int i = 0; i < 5; i ++) {
+        x->v[i] = f64x2_make((double) limbs[i], 0);
+    }
+}
+
+static inline uint64_t bigintf255_limbs_add(uint64_t *res, const uint64_t *a, const uint64_t *b) {
+    uint64_t c = 0;
+    for (int i = 0; i < 5; i ++) {
+        c = a[i] + b[i] + c;
+        res[i] = c & 0x7ffffffffffff;
+        c >>= 51;
+    }
+    return c;
+}
+
+static inline uint64_t bigintf255_limbs_sub(uint64_t *res, const uint64_t *a, const uint64_t *b) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 5; i ++) {
+        uint64_t diff = a[i] - b[i] - borrow;
+        res[i] = diff & 0x7ffffffffffff;
+        borrow = diff >> 63;
+    }
+    return borrow;
+}
+
+/*
+ * Stores d in res if keep_d is all ones, and t if it is zero.
+ */
+static inline void bigintf255_limbs_select(uint64_t *res, const uint64_t *d, const uint64_t *t, uint64_t keep_d) {
+    for (int i = 0; i < 5; i ++) {
+        res[i] = (d[i] & keep_d) | (t[i] & ~keep_d);
+    }
+}
+
+/*
+ * Stores a * k in res and returns the limb that carries out of the top, for
+ * k < 2^21. A 51-bit limb times k does not fit in 64 bits, so each limb is
+ * split into 26 and 25-bit halves, whose products with k do.
+ */
+static inline uint64_t bigintf255_limbs_mul_small(uint64_t *res, const uint64_t *a, uint64_t k) {
+    uint64_t c = 0;
+    for (int i = 0; i < 5; i ++) {
+        uint64_t lo = (a[i] & 0x3ffffff) * k + c;
+        uint64_t hi = (a[i] >> 26) * k + (lo >> 26);
+        res[i] = ((hi & 0x1ffffff) << 26) | (lo & 0x3ffffff);
+        c = hi >> 25;
+    }
+    return c;
+}
+
+void bigintf255_add_mod(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *b, const BigIntF255 *p) {
+    uint64_t al[5], bl[5], pl[5], t[5], d[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(b, bl);
+    bigintf255_get_limbs(p, pl);
+    bigintf255_limbs_add(t, al, bl);
+    uint64_t borrow = bigintf255_limbs_sub(d, t, pl);
+    bigintf255_limbs_select(t, t, d, -borrow);
+    bigintf255_set_limbs(res, t);
+}
+
+void bigintf255_sub_mod(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *b, const BigIntF255 *p) {
+    uint64_t al[5], bl[5], pl[5], t[5], d[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(b, bl);
+    bigintf255_get_limbs(p, pl);
+    uint64_t borrow = bigintf255_limbs_sub(t, al, bl);
+    bigintf255_limbs_add(d, t, pl);
+    bigintf255_limbs_select(t, d, t, -borrow);
+    bigintf255_set_limbs(res, t);
+}
+
+void bigintf255_neg_mod(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *p) {
+    BigIntF255 zero = bigintf_new();
+    bigintf255_sub_mod(res, &zero, a, p);
+}
+
+void bigintf255_double_mod(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *p) {
+    bigintf255_add_mod(res, a, a, p);
+}
+
+void bigintf255_halve_mod(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *p) {
+    uint64_t al[5], pl[5], t[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(p, pl);
+    uint64_t odd = -(al[0] & 1);
+    for (int i = 0; i < 5; i ++) {
+        pl[i] &= odd;
+    }
+    // a + p is less than 2^255, so there is no carry out of the top limb
+    bigintf255_limbs_add(t, al, pl);
+    for (int i = 0; i < 4; i ++) {
+        t[i] = (t[i] >> 1) | ((t[i + 1] & 1) << 50);
+    }
+    t[4] >>= 1;
+    bigintf255_set_limbs(res, t);
+}
+
+/*
+ * Stores a * k mod p in res, for k < 2^20. See limbs_mul_small_mod in
+ * bigint.h: q is estimated from the bits of a * k and p above bit 211, and is
+ * at most 1 too small.
+ */
+void bigintf255_mul_small_mod(BigIntF255 *res, const BigIntF255 *a, uint64_t k, const BigIntF255 *p) {
+    uint64_t al[5], pl[5], t[5], qp[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(p, pl);
+    uint64_t c = bigintf255_limbs_mul_small(t, al, k);
+
+    // Bit 211 is bit 7 of the top limb.
+    uint64_t t_top = (c << 44) + (t[4] >> 7);
+    uint64_t p_top = pl[4] >> 7;
+    uint64_t q = t_top / (p_top + 1);
+
+    bigintf255_limbs_mul_small(qp, pl, q);
+    bigintf255_limbs_sub(t, t, qp);
+    uint64_t borrow = bigintf255_limbs_sub(qp, t, pl);
+    bigintf255_limbs_select(t, t, qp, -borrow);
+    bigintf255_set_limbs(res, t);
+}
+
+void bigintf255_add_lazy(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *b) {
+    uint64_t al[5], bl[5], t[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(b, bl);
+    bigintf255_limbs_add(t, al, bl);
+    bigintf255_set_limbs(res, t);
+}
+
+void bigintf255_sub_lazy(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *b, const BigIntF255 *p2) {
+    uint64_t al[5], bl[5], pl[5], t[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(b, bl);
+    bigintf255_get_limbs(p2, pl);
+    bigintf255_limbs_add(t, al, pl);
+    bigintf255_limbs_sub(t, t, bl);
+    bigintf255_set_limbs(res, t);
+}
+
+void bigintf255_reduce(BigIntF255 *res, const BigIntF255 *a, const BigIntF255 *m) {
+    uint64_t al[5], ml[5], d[5];
+    bigintf255_get_limbs(a, al);
+    bigintf255_get_limbs(m, ml);
+    uint64_t borrow = bigintf255_limbs_sub(d, al, ml);
+    bigintf255_limbs_select(d, al, d, -borrow);
+    bigintf255_set_limbs(res, d);
+}
+
 uint64_t extract_bits(uint64_t *num, int start_bit, int num_bits) {
     int start_idx = start_bit / 64;
     int start_offset = start_bit % 64;
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "./mont.h"
+#include "./sparse.h"
+#include <stdint.h>
+
+// Montgomery constants for a modulus, derived at runtime.
+//
+// Each kernel in mont.h takes the modulus and its Montgomery constant as
+// separate arguments, in the representation that it works on. A MontCtx holds
+// all of them for one modulus, computed once by mont_ctx_init, so callers do
+// not need to hard-code mu, n0 or the limbs of p for each representation, and
+// can switch moduli without recompiling. The values for each representation
+// are grouped together, so a kernel only touches one contiguous part of the
+// struct.
+//
+// Done:
+// - 29-bit, 30-bit, 32-bit and 51-bit (f64) constants from a single modulus
+// - Classification of the limbs of p for the sparse kernels in sparse.h
+// - Selection of the p = 1 mod 2^w and no-carry kernels (mont_ctx_mul_* and
+//   mont_ctx_sqr_cios)
+// - Reduction of 512-bit values, such as hash outputs, into Montgomery form
+//   in every limb representation (mont_ctx_reduce_wide_*)
+
+/// Constants for the 29-bit kernels (mont_mul_9x29 and mont_sqr_9x29), where
+/// R = 2^261.
+typedef struct {
+    BigInt261 p;
+    /// -p^-1 mod 2^29
+    uint64_t mu;
+    /// Whether p = 1 mod 2^29, so that mont_mul_9x29_p1 applies
+    bool p_is_1_mod_limb;
+    BigInt261 p2;
+    BigInt261 p4;
+    BigInt261 r;
+    BigInt261 r2;
+    BigInt261 r3;
+    /// The limbs of p that are 0 or 1, for mont_mul_9x29_sparse
+    MontSparse sparse;
+} MontParams9x29;
+
+/// Constants for the 30-bit kernels (mont_mul_9x30 and mont_sqr_9x30), where
+/// R = 2^270.
+typedef struct {
+    BigInt270 p;
+    /// -p^-1 mod 2^30
+    uint64_t mu;
+    /// Whether p = 1 mod 2^30, so that mont_mul_9x30_p1 applies
+    bool p_is_1_mod_limb;
+    BigInt270 p2;
+    BigInt270 p4;
+    BigInt270 r;
+    BigInt270 r2;
+    BigInt270 r3;
+    /// The limbs of p that are 0 or 1, for mont_mul_9x30_sparse
+    MontSparse sparse;
+} MontParams9x30;
+
+/// Constants for the 32-bit kernels (mont_mul_cios, mont_sqr_cios and the BM17
+/// kernels), where R = 2^256.
+typedef struct {
+    BigInt256 p;
+    /// p with a zero top limb, for the final subtraction in mont_mul_cios
+    uint64_t p_for_redc[9];
+    /// -p^-1 mod 2^32, for mont_mul_cios and mont_sqr_cios
+    uint64_t n0;
+    /// Whether p = 1 mod 2^32, so that mont_mul_cios_p1 applies
+    bool p_is_1_mod_limb;
+    /// Whether the top limb of p leaves enough spare bits for
+    /// mont_mul_cios_nocarry and mont_sqr_cios_nocarry respectively
+    bool mul_nocarry;
+    bool sqr_nocarry;
+    /// p^-1 mod 2^32, for bm17_non_simd_mont_mul and bm17_simd_mont_mul
+    uint64_t mu_bm17;
+    BigInt256 p2;
+    BigInt256 p4;
+    BigInt256 r;
+    BigInt256 r2;
+    BigInt256 r3;
+    /// The limbs of p that are 0 or 1, for mont_mul_cios_sparse and
+    /// bm17_non_simd_mont_mul_sparse
+    MontSparse sparse;
+} MontParamsCios;
+
+/// Constants for the f64 kernels (mont_mul_cios_f64_simd and
+/// mont_sqr_cios_f64_simd), where R = 2^255. p, r, r2 and r3 are in double
+/// form, and p_for_redc holds the limbs of p as integers, in the form that
+/// reduce_bigintf expects.
+typedef struct {
+    BigIntF255 p;
+    BigIntF255 p_for_redc;
+    /// -p^-1 mod 2^51
+    uint64_t n0;
+    BigIntF255 r;
+    BigIntF255 r2;
+    BigIntF255 r3;
+} MontParamsF64;
+
+typedef struct {
+    MontParams9x29 w29;
+    MontParams9x30 w30;
+    MontParamsCios cios;
+    MontParamsF64 f64;
+} MontCtx;
+
+/// Returns bits [start, start + w) of the little-endian array of 32-bit words
+/// x, which has num_words words, for w < 64. Bits past the end are 0.
+static inline uint64_t mont_ctx_get_bits(
+    const uint64_t *x,
+    int num_words,
+    int start,
+    int w
+) {
+    uint64_t res = 0;
+    for (int b = start - start % 32; b < start + w && b < 32 * num_words; b += 32) {
+        uint64_t word = x[b / 32];
+        res |= b >= start ? word << (b - start) : word >> (start - b);
+    }
+    return res & ((1ULL << w) - 1);
+}
+
+/// Stores a in result, repacked from 32-bit limbs into 51-bit limbs in double
+/// form.
+static inline void mont_ctx_to_bigintf255(BigIntF255 *result, BigInt256 *a) {
+    uint64_t limbs[5];
+    for (int i = 0; i < 5; i ++) {
+        limbs[i] = mont_ctx_get_bits(a->v, 8, 51 * i, 51);
+    }
+    bigintf255_set_limbs(result, limbs);
+}
+
+/// Computes every constant in ctx for the modulus p. Returns 0 on success, and
+/// -1 if p is even, p < 3, or p >= 2^254, in which case 4p would not fit in 256
+/// bits. Note that the f64 kernels and the lazy functions in bigint.h and
+/// bigintf.h have tighter bounds; see their documentation.
+int mont_ctx_init(MontCtx *ctx, BigInt256 *p) {
+    if (!bigint_is_valid_modulus(p)) {
+        return -1;
+    }
+
+    uint64_t p_lo = p->v[0] | (p->v[1] << 32);
+    uint64_t p_inv = inv_mod_2_64(p_lo);
+
+    BigInt256 p2, p4;
+    bigint_add(&p2, p, p);
+    bigint_add(&p4, &p2, &p2);
+
+    // 29-bit limbs
+    MontParams9x29 *w29 = &ctx->w29;
+    BigInt256 x;
+    bigint256_to_bigint261(&w29->p, p);
+    w29->mu = (0 - p_inv) & 0x1FFFFFFF;
+    w29->p_is_1_mod_limb = (p_lo & 0x1FFFFFFF) == 1;
+    bigint256_to_bigint261(&w29->p2, &p2);
+    bigint256_to_bigint261(&w29->p4, &p4);
+    x = bigint_pow2_mod(261, p);
+    bigint256_to_bigint261(&w29->r, &x);
+    x = bigint_pow2_mod(2 * 261, p);
+    bigint256_to_bigint261(&w29->r2, &x);
+    x = bigint_pow2_mod(3 * 261, p);
+    bigint256_to_bigint261(&w29->r3, &x);
+    mont_sparse_init(&w29->sparse, w29->p.v, 9);
+
+    // 30-bit limbs
+    MontParams9x30 *w30 = &ctx->w30;
+    bigint256_to_bigint270(&w30->p, p);
+    w30->mu = (0 - p_inv) & 0x3FFFFFFF;
+    w30->p_is_1_mod_limb = (p_lo & 0x3FFFFFFF) == 1;
+    bigint256_to_bigint270(&w30->p2, &p2);
+    bigint256_to_bigint270(&w30->p4, &p4);
+    x = bigint_pow2_mod(270, p);
+    bigint256_to_bigint270(&w30->r, &x);
+    x = bigint_pow2_mod(2 * 270, p);
+    bigint256_to_bigint270(&w30->r2, &x);
+    x = bigint_pow2_mod(3 * 270, p);
+    bigint256_to_bigint270(&w30->r3, &x);
+    mont_sparse_init(&w30->sparse, w30->p.v, 9);
+
+    // 32-bit limbs
+    MontParamsCios *cios = &ctx->cios;
+    cios->p = *p;
+    for (int i = 0; i < 8; i ++) {
+        cios->p_for_redc[i] = p->v[i];
+    }
+    cios->p_for_redc[8] = 0;
+    cios->n0 = (0 - p_inv) & 0xFFFFFFFF;
+    cios->p_is_1_mod_limb = (p_lo & 0xFFFFFFFF) == 1;
+    cios->mul_nocarry = p->v[7] < 0x7FFFFFFF;
+    cios->sqr_nocarry = p->v[7] < 0x3FFFFFFF;
+    cios->mu_bm17 = p_inv & 0xFFFFFFFF;
+    cios->p2 = p2;
+    cios->p4 = p4;
+    cios->r = bigint_pow2_mod(256, p);
+    cios->r2 = bigint_pow2_mod(2 * 256, p);
+    cios->r3 = bigint_pow2_mod(3 * 256, p);
+    mont_sparse_init(&cios->sparse, p->v, 8);
+
+    // 51-bit limbs in doubles
+    MontParamsF64 *f64 = &ctx->f64;
+    mont_ctx_to_bigintf255(&f64->p, p);
+    f64->p_for_redc = bigintf_new();
+    for (int i = 0; i < 5; i ++) {
+        uint64_t limb = (uint64_t) f64x2_extract_l(f64->p.v[i]);
+        memcpy(&(f64->p_for_redc.v[i]), &limb, sizeof(uint64_t));
+    }
+    f64->n0 = (0 - p_inv) & 0x7FFFFFFFFFFFF;
+    x = bigint_pow2_mod(255, p);
+    mont_ctx_to_bigintf255(&f64->r, &x);
+    x = bigint_pow2_mod(2 * 255, p);
+    mont_ctx_to_bigintf255(&f64->r2, &x);
+    x = bigint_pow2_mod(3 * 255, p);
+    mont_ctx_to_bigintf255(&f64->r3, &x);
+
+    return 0;
+}
+
+/// Like mont_ctx_init, but takes p as a 64-character big-endian hex string.
+/// Returns -1 if the string cannot be parsed, or if p is not a valid modulus.
+int mont_ctx_init_hex(MontCtx *ctx, const char *p_hex) {
+    BigInt256 p;
+    if (hex_to_bigint256(p_hex, &p) != 0) {
+        return -1;
+    }
+    return mont_ctx_init(ctx, &p);
+}
+
+/// Computes ar * br * R^-1 mod p with 29-bit limbs, using mont_mul_9x29_p1 if
+/// p = 1 mod 2^29, and mont_mul_9x29 otherwise.
+BigInt261 mont_ctx_mul_9x29(MontCtx *ctx, BigInt261 *ar, BigInt261 *br) {
+    MontParams9x29 *w29 = &ctx->w29;
+    if (w29->p_is_1_mod_limb) {
+        return mont_mul_9x29_p1(ar, br, &w29->p);
+    }
+    return mont_mul_9x29(ar, br, &w29->p, w29->mu);
+}
+
+/// Computes ar * br * R^-1 mod p with 30-bit limbs, using mont_mul_9x30_p1 if
+/// p = 1 mod 2^30, and mont_mul_9x30 otherwise.
+BigInt270 mont_ctx_mul_9x30(MontCtx *ctx, BigInt270 *ar, BigInt270 *br) {
+    MontParams9x30 *w30 = &ctx->w30;
+    if (w30->p_is_1_mod_limb) {
+        return mont_mul_9x30_p1(ar, br, &w30->p);
+    }
+    return mont_mul_9x30(ar, br, &w30->p, w30->mu);
+}
+
+/// Computes ar * br * R^-1 mod p with 32-bit limbs. Uses
+/// mont_mul_cios_nocarry if the top limb of p allows it, then mont_mul_cios_p1
+/// if p = 1 mod 2^32, and mont_mul_cios otherwise.
+BigInt256 mont_ctx_mul_cios(MontCtx *ctx, BigInt256 *ar, BigInt256 *br) {
+    MontParamsCios *cios = &ctx->cios;
+    if (cios->mul_nocarry) {
+        return mont_mul_cios_nocarry(ar, br, &cios->p, cios->n0);
+    }
+    if (cios->p_is_1_mod_limb) {
+        return mont_mul_cios_p1(ar, br, &cios->p);
+    }
+    return mont_mul_cios(ar, br, &cios->p, cios->p_for_redc, cios->n0);
+}
+
+/// Computes ar * ar * R^-1 mod p with 32-bit limbs, using mont_sqr_cios_nocarry
+/// if the top limb of p allows it, and mont_sqr_cios otherwise.
+BigInt256 mont_ctx_sqr_cios(MontCtx *ctx, BigInt256 *ar) {
+    MontParamsCios *cios = &ctx->cios;
+    if (cios->sqr_nocarry) {
+        return mont_sqr_cios_nocarry(ar, &cios->p, cios->n0);
+    }
+    return mont_sqr_cios(ar, &cios->p, cios->n0);
+}
+
+/// Reads 64 bytes as a big-endian 512-bit integer, the byte order of hash
+/// outputs and of the hex strings in bigint.h, into 16 little-endian 32-bit
+/// words.
+static inline void mont_ctx_wide_words(uint64_t *words, const uint8_t *bytes) {
+    for (int i = 0; i < 16; i ++) {
+        const uint8_t *b = &bytes[60 - 4 * i];
+        words[i] = ((uint64_t) b[0] << 24) | ((uint64_t) b[1] << 16) |
+            ((uint64_t) b[2] << 8) | (uint64_t) b[3];
+    }
+}
+
+/// Splits the 512-bit integer in words into x = x0 + x1 * 2^(n * w), where x0
+/// and x1 have n limbs of w bits each. Both are below R = 2^(n * w), which is
+/// all that the Montgomery kernels need of one operand when the other is
+/// below p.
+static inline void mont_ctx_wide_split(
+    uint64_t *x0,
+    uint64_t *x1,
+    const uint64_t *words,
+    int n,
+    int w
+) {
+    for (int i = 0; i < n; i ++) {
+        x0[i] = mont_ctx_get_bits(words, 16, w * i, w);
+        x1[i] = mont_ctx_get_bits(words, 16, w * (n + i), w);
+    }
+}
+
+/// Reduces the 512-bit big-endian integer x in bytes mod p, and returns it in
+/// Montgomery form with 29-bit limbs, i.e. x * 2^261 mod p. With
+/// x = x0 + x1 * R, this is x0 * r2 * R^-1 + x1 * r3 * R^-1, which takes two
+/// Montgomery multiplications and a modular addition.
+BigInt261 mont_ctx_reduce_wide_9x29(MontCtx *ctx, const uint8_t *bytes) {
+    MontParams9x29 *w29 = &ctx->w29;
+    uint64_t words[16];
+    BigInt261 x0, x1, lo, hi;
+    mont_ctx_wide_words(words, bytes);
+    mont_ctx_wide_split(x0.v, x1.v, words, 9, 29);
+    lo = mont_mul_9x29(&x0, &w29->r2, &w29->p, w29->mu);
+    hi = mont_mul_9x29(&x1, &w29->r3, &w29->p, w29->mu);
+    bigint261_add_mod(&lo, &lo, &hi, &w29->p);
+    return lo;
+}
+
+/// Like mont_ctx_reduce_wide_9x29, with 30-bit limbs and R = 2^270.
+BigInt270 mont_ctx_reduce_wide_9x30(MontCtx *ctx, const uint8_t *bytes) {
+    MontParams9x30 *w30 = &ctx->w30;
+    uint64_t words[16];
+    BigInt270 x0, x1, lo, hi;
+    mont_ctx_wide_words(words, bytes);
+    mont_ctx_wide_split(x0.v, x1.v, words, 9, 30);
+    lo = mont_mul_9x30(&x0, &w30->r2, &w30->p, w30->mu);
+    hi = mont_mul_9x30(&x1, &w30->r3, &w30->p, w30->mu);
+    bigint270_add_mod(&lo, &lo, &hi, &w30->p);
+    return lo;
+}
+
+/// Like mont_ctx_reduce_wide_9x29, with 32-bit limbs and R = 2^256. This uses
+/// mont_mul_cios rather than the no-carry kernels, which need both operands
+/// to be below p.
+BigInt256 mont_ctx_reduce_wide_cios(MontCtx *ctx, const uint8_t *bytes) {
+    MontParamsCios *cios = &ctx->cios;
+    uint64_t words[16];
+    BigInt256 x0, x1, lo, hi;
+    mont_ctx_wide_words(words, bytes);
+    mont_ctx_wide_split(x0.v, x1.v, words, 8, 32);
+    lo = mont_mul_cios(&x0, &cios->r2, &cios->p, cios->p_for_redc, cios->n0);
+    hi = mont_mul_cios(&x1, &cios->r3, &cios->p, cios->p_for_redc, cios->n0);
+    bigint_add_mod(&lo, &lo, &hi, &cios->p);
+    return lo;
+}
+
+/// Like mont_ctx_reduce_wide_9x29, in double form with R = 2^255. x1 would be
+/// 257 bits wide with a split at 2^255, so x * 2^256 mod p is computed with
+/// 32-bit limbs instead, and halved.
+BigIntF255 mont_ctx_reduce_wide_f64(MontCtx *ctx, const uint8_t *bytes) {
+    BigInt256 x = mont_ctx_reduce_wide_cios(ctx, bytes);
+    bigint_halve_mod(&x, &x, &ctx->cios.p);
+    BigIntF255 res;
+    mont_ctx_to_bigintf255(&res, &x);
+    return res;
+}
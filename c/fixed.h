@@ -0,0 +1,195 @@
+#pragma once
+
+#include "./mont.h"
+#include <stdint.h>
+
+// Multiplication by fixed field elements with Shoup's precomputed quotient.
+//
+// NTT twiddles, curve constants and round constants are each multiplied by
+// many different operands. For a constant w, FixedMul9x30 stores w and
+// w' = floor(w * 2^270 / p). The quotient floor(x * w / p) is then (within 1)
+// the top half of x * w', so x * w mod p only needs the top half of x * w',
+// and the bottom half of x * w + q * (2^270 - p), which is summed in a single
+// pass over the columns. The product does not have the
+// serial dependency of Montgomery reduction, where each row's q depends on the
+// previous row.
+//
+// The constant is given in Montgomery form, and the result is in Montgomery
+// form, so mont_mul_by_fixed_9x30(ar, f, p) computes the same value as
+// mont_mul_9x30(ar, cr, p, mu).
+//
+// Done:
+// - Shoup multiplication with 30-bit limbs, for single values and for vectors
+// - Unrolled columns, with x * w and q * p summed in one pass
+
+/// A constant prepared for mont_mul_by_fixed_9x30.
+typedef struct {
+    /// The constant, out of Montgomery form
+    BigInt270 w;
+    /// floor(w * 2^270 / p)
+    BigInt270 w_shoup;
+    /// 2^270 - p, so that q * p is subtracted by adding q * p_neg
+    BigInt270 p_neg;
+} FixedMul9x30;
+
+/// Prepares the constant cr, which is in Montgomery form with R = 2^270, for
+/// mont_mul_by_fixed_9x30. w' is computed by long division, one bit at a time.
+void fixed_mul_9x30_init(
+    FixedMul9x30 *f,
+    BigInt270 *cr,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 one = bigint270_new();
+    one.v[0] = 1;
+    f->w = mont_mul_9x30(cr, &one, p, mu);
+
+    // rem stays below p, so 2 * rem fits in 270 bits.
+    BigInt270 rem = f->w;
+    f->w_shoup = bigint270_new();
+    for (int b = 269; b >= 0; b --) {
+        bigint270_add(&rem, &rem, &rem);
+        if (gt_270(rem.v, p)) {
+            sub_270(rem.v, rem.v, p);
+            f->w_shoup.v[b / 30] |= 1ULL << (b % 30);
+        }
+    }
+
+    BigInt270 zero = bigint270_new();
+    limbs_sub(f->p_neg.v, zero.v, p->v, 9, 30);
+}
+
+/// Computes ar * w mod p into r, where w is the constant in f, without the
+/// final conditional subtraction, so r is in [0, 2p).
+///
+/// The 9 x 9 limb products fit in columns of 64 bits without carries, as each
+/// is below 2^60. q is computed from columns 7 to 16 of ar * w'. Dropping
+/// columns 0 to 6 changes the product by less than 2^243, and w' is at most
+/// 1 below w * 2^270 / p, so q is at least floor(ar * w / p) - 1, and the
+/// remainder is in [0, 2p). Since 2p < 2^270, it can be computed from the low
+/// 9 limbs of ar * w + q * (2^270 - p), in one pass over the columns. The
+/// longest column, 8, has 18 products, but the top limbs of x, w and q are
+/// below 2^14 for p < 2^254, so 4 of them are small and the column still fits
+/// in 64 bits.
+///
+/// Every column is written out, as the loops over columns of varying length
+/// were much slower than the rows of mont_mul_9x30.
+static inline void mont_mul_by_fixed_9x30_unreduced(
+    uint64_t *r,
+    const BigInt270 *ar,
+    const FixedMul9x30 *f
+) {
+    const uint64_t *x = ar->v;
+    const uint64_t *w = f->w.v;
+    const uint64_t *ws = f->w_shoup.v;
+    const uint64_t *pn = f->p_neg.v;
+    uint64_t q[9];
+    uint64_t acc;
+
+    // q = floor(x * w' / 2^270), from columns 7 and up
+    acc = x[0] * ws[7] + x[1] * ws[6] + x[2] * ws[5] + x[3] * ws[4] + x[4] * ws[3]
+        + x[5] * ws[2] + x[6] * ws[1] + x[7] * ws[0];
+    acc = hi_30(acc) + x[0] * ws[8] + x[1] * ws[7] + x[2] * ws[6] + x[3] * ws[5]
+        + x[4] * ws[4] + x[5] * ws[3] + x[6] * ws[2] + x[7] * ws[1] + x[8] * ws[0];
+    acc = hi_30(acc) + x[1] * ws[8] + x[2] * ws[7] + x[3] * ws[6] + x[4] * ws[5]
+        + x[5] * ws[4] + x[6] * ws[3] + x[7] * ws[2] + x[8] * ws[1];
+    q[0] = lo_30(acc);
+    acc = hi_30(acc) + x[2] * ws[8] + x[3] * ws[7] + x[4] * ws[6] + x[5] * ws[5]
+        + x[6] * ws[4] + x[7] * ws[3] + x[8] * ws[2];
+    q[1] = lo_30(acc);
+    acc = hi_30(acc) + x[3] * ws[8] + x[4] * ws[7] + x[5] * ws[6] + x[6] * ws[5]
+        + x[7] * ws[4] + x[8] * ws[3];
+    q[2] = lo_30(acc);
+    acc = hi_30(acc) + x[4] * ws[8] + x[5] * ws[7] + x[6] * ws[6] + x[7] * ws[5]
+        + x[8] * ws[4];
+    q[3] = lo_30(acc);
+    acc = hi_30(acc) + x[5] * ws[8] + x[6] * ws[7] + x[7] * ws[6] + x[8] * ws[5];
+    q[4] = lo_30(acc);
+    acc = hi_30(acc) + x[6] * ws[8] + x[7] * ws[7] + x[8] * ws[6];
+    q[5] = lo_30(acc);
+    acc = hi_30(acc) + x[7] * ws[8] + x[8] * ws[7];
+    q[6] = lo_30(acc);
+    acc = hi_30(acc) + x[8] * ws[8];
+    q[7] = lo_30(acc);
+    q[8] = hi_30(acc);
+
+    // r = x * w + q * (2^270 - p) mod 2^270
+    acc = x[0] * w[0] + q[0] * pn[0];
+    r[0] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[1] + x[1] * w[0] + q[0] * pn[1] + q[1] * pn[0];
+    r[1] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[2] + x[1] * w[1] + x[2] * w[0] + q[0] * pn[2]
+        + q[1] * pn[1] + q[2] * pn[0];
+    r[2] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[3] + x[1] * w[2] + x[2] * w[1] + x[3] * w[0]
+        + q[0] * pn[3] + q[1] * pn[2] + q[2] * pn[1] + q[3] * pn[0];
+    r[3] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[4] + x[1] * w[3] + x[2] * w[2] + x[3] * w[1]
+        + x[4] * w[0] + q[0] * pn[4] + q[1] * pn[3] + q[2] * pn[2] + q[3] * pn[1]
+        + q[4] * pn[0];
+    r[4] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[5] + x[1] * w[4] + x[2] * w[3] + x[3] * w[2]
+        + x[4] * w[1] + x[5] * w[0] + q[0] * pn[5] + q[1] * pn[4] + q[2] * pn[3]
+        + q[3] * pn[2] + q[4] * pn[1] + q[5] * pn[0];
+    r[5] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[6] + x[1] * w[5] + x[2] * w[4] + x[3] * w[3]
+        + x[4] * w[2] + x[5] * w[1] + x[6] * w[0] + q[0] * pn[6] + q[1] * pn[5]
+        + q[2] * pn[4] + q[3] * pn[3] + q[4] * pn[2] + q[5] * pn[1] + q[6] * pn[0];
+    r[6] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[7] + x[1] * w[6] + x[2] * w[5] + x[3] * w[4]
+        + x[4] * w[3] + x[5] * w[2] + x[6] * w[1] + x[7] * w[0] + q[0] * pn[7]
+        + q[1] * pn[6] + q[2] * pn[5] + q[3] * pn[4] + q[4] * pn[3] + q[5] * pn[2]
+        + q[6] * pn[1] + q[7] * pn[0];
+    r[7] = lo_30(acc);
+    acc = hi_30(acc) + x[0] * w[8] + x[1] * w[7] + x[2] * w[6] + x[3] * w[5]
+        + x[4] * w[4] + x[5] * w[3] + x[6] * w[2] + x[7] * w[1] + x[8] * w[0]
+        + q[0] * pn[8] + q[1] * pn[7] + q[2] * pn[6] + q[3] * pn[5] + q[4] * pn[4]
+        + q[5] * pn[3] + q[6] * pn[2] + q[7] * pn[1] + q[8] * pn[0];
+    r[8] = lo_30(acc);
+}
+
+/// Computes ar * w mod p, where w is the constant in f, for ar in [0, p). If
+/// ar is in Montgomery form, so is the result. As in mont_mul_9x30, the final
+/// subtraction is a compare and a branch.
+BigInt270 mont_mul_by_fixed_9x30(
+    BigInt270 *ar,
+    FixedMul9x30 *f,
+    BigInt270 *p
+) {
+    BigInt270 res;
+    mont_mul_by_fixed_9x30_unreduced(res.v, ar, f);
+    if (gt_270(res.v, p)) {
+        sub_270(res.v, res.v, p);
+    }
+    return res;
+}
+
+/// Like mont_mul_by_fixed_9x30, but with a branch-free final subtraction
+/// (limbs_reduce), as in mont_mul_9x30_ct.
+BigInt270 mont_mul_by_fixed_9x30_ct(
+    BigInt270 *ar,
+    FixedMul9x30 *f,
+    BigInt270 *p
+) {
+    BigInt270 res;
+    mont_mul_by_fixed_9x30_unreduced(res.v, ar, f);
+    limbs_reduce(res.v, res.v, p->v, 9, 30);
+    return res;
+}
+
+/// Computes out[k] = a[k] * w mod p for k in [0, n), where w is the constant
+/// in f. out may alias a. As in the *_batch functions in mont.h, the final
+/// subtraction is branch-free.
+void mont_mul_by_fixed_9x30_batch(
+    BigInt270 *out,
+    BigInt270 *a,
+    size_t n,
+    FixedMul9x30 *f,
+    BigInt270 *p
+) {
+    FixedMul9x30 f_local = *f;
+    BigInt270 p_local = *p;
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = mont_mul_by_fixed_9x30_ct(&a[k], &f_local, &p_local);
+    }
+}
@@ -0,0 +1,556 @@
+#pragma once
+
+#include "./mont.h"
+#include <stdint.h>
+#include <pthread.h>
+
+// Constant-time field inversion using the safegcd algorithm from Bernstein and
+// Yang, "Fast constant-time gcd computation and modular inversion"
+// (https://gcd.cr.yp.to/safegcd-20190413.pdf), with the divstep batching and
+// limb updates from libsecp256k1's modinv32
+// (https://github.com/bitcoin-core/secp256k1/blob/master/doc/safegcd_implementation.md).
+//
+// Values are held in 9 signed 30-bit limbs, which is the same limb layout as
+// BigInt270, so a BigInt270 converts for free. 20 batches of 30 divsteps (600
+// in total) are enough for any modulus of up to 256 bits.
+//
+// Done:
+// - Inversion of plain and Montgomery-form values with 30-bit limbs
+// - Inversion of Montgomery-form values with 32-bit limbs
+// - Batch inversion (Montgomery's trick), single- and multi-threaded
+
+/// 9 x 30-bit limbs in little-endian form. Each limb is signed, and only the
+/// top limb may hold more than 30 bits, so the value can be negative.
+typedef struct {
+    int32_t v[9];
+} BigIntS270;
+
+/// The transition matrix of a batch of 30 divsteps, scaled by 2^30.
+typedef struct {
+    int32_t u, v, q, r;
+} DivstepMatrix;
+
+/// Runs 30 divsteps on the low 30 bits of f and g, starting from
+/// zeta = -(delta + 1/2), and returns the new zeta. The masks are derived from
+/// the sign of zeta and the low bit of g, so there are no branches.
+static inline int32_t divsteps_30(
+    int32_t zeta,
+    uint32_t f0,
+    uint32_t g0,
+    DivstepMatrix *t
+) {
+    uint32_t u = 1, v = 0, q = 0, r = 1;
+    uint32_t f = f0, g = g0;
+    uint32_t mask1, mask2, x, y, z;
+
+    for (int i = 0; i < 30; i ++) {
+        // mask1 is all ones if zeta < 0 (delta > 0), and mask2 is all ones if
+        // g is odd.
+        mask1 = (uint32_t)(zeta >> 31);
+        mask2 = -(g & 1);
+
+        // Conditionally negate f, u and v, and add them to g, q and r.
+        x = (f ^ mask1) - mask1;
+        y = (u ^ mask1) - mask1;
+        z = (v ^ mask1) - mask1;
+        g += x & mask2;
+        q += y & mask2;
+        r += z & mask2;
+
+        // If both conditions hold, swap by adding the new g, q and r back.
+        mask1 &= mask2;
+        zeta = (zeta ^ (int32_t)mask1) - 1;
+        f += g & mask1;
+        u += q & mask1;
+        v += r & mask1;
+
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+
+    t->u = (int32_t)u;
+    t->v = (int32_t)v;
+    t->q = (int32_t)q;
+    t->r = (int32_t)r;
+    return zeta;
+}
+
+/// Computes (t * [d, e]) / 2^30 mod p. Multiples of p are added first so that
+/// the bottom 30 bits of both products are zero, which makes the division
+/// exact. p_inv is p^-1 mod 2^30. d and e must be in (-2p, p), and so are the
+/// outputs.
+static inline void update_de_30(
+    BigIntS270 *d,
+    BigIntS270 *e,
+    DivstepMatrix *t,
+    BigIntS270 *p,
+    uint32_t p_inv
+) {
+    const int32_t mask = 0x3FFFFFFF;
+    const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int32_t di, ei, md, me, sd, se;
+    int64_t cd, ce;
+
+    // Add p to the outputs once for each negative input, so that they are not
+    // pushed below -2p.
+    sd = d->v[8] >> 31;
+    se = e->v[8] >> 31;
+    md = (u & sd) + (v & se);
+    me = (q & sd) + (r & se);
+
+    di = d->v[0];
+    ei = e->v[0];
+    cd = (int64_t)u * di + (int64_t)v * ei;
+    ce = (int64_t)q * di + (int64_t)r * ei;
+
+    // Adjust md and me so that the bottom 30 bits of cd and ce become zero.
+    md -= (p_inv * (uint32_t)cd + md) & mask;
+    me -= (p_inv * (uint32_t)ce + me) & mask;
+    cd += (int64_t)p->v[0] * md;
+    ce += (int64_t)p->v[0] * me;
+    cd >>= 30;
+    ce >>= 30;
+
+    for (int i = 1; i < 9; i ++) {
+        di = d->v[i];
+        ei = e->v[i];
+        cd += (int64_t)u * di + (int64_t)v * ei;
+        ce += (int64_t)q * di + (int64_t)r * ei;
+        cd += (int64_t)p->v[i] * md;
+        ce += (int64_t)p->v[i] * me;
+        d->v[i - 1] = (int32_t)cd & mask;
+        e->v[i - 1] = (int32_t)ce & mask;
+        cd >>= 30;
+        ce >>= 30;
+    }
+    d->v[8] = (int32_t)cd;
+    e->v[8] = (int32_t)ce;
+}
+
+/// Computes (t * [f, g]) / 2^30. The bottom 30 bits of both products are zero
+/// by construction, so the division is exact.
+static inline void update_fg_30(
+    BigIntS270 *f,
+    BigIntS270 *g,
+    DivstepMatrix *t
+) {
+    const int32_t mask = 0x3FFFFFFF;
+    const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int32_t fi, gi;
+    int64_t cf, cg;
+
+    fi = f->v[0];
+    gi = g->v[0];
+    cf = (int64_t)u * fi + (int64_t)v * gi;
+    cg = (int64_t)q * fi + (int64_t)r * gi;
+    cf >>= 30;
+    cg >>= 30;
+
+    for (int i = 1; i < 9; i ++) {
+        fi = f->v[i];
+        gi = g->v[i];
+        cf += (int64_t)u * fi + (int64_t)v * gi;
+        cg += (int64_t)q * fi + (int64_t)r * gi;
+        f->v[i - 1] = (int32_t)cf & mask;
+        g->v[i - 1] = (int32_t)cg & mask;
+        cf >>= 30;
+        cg >>= 30;
+    }
+    f->v[8] = (int32_t)cf;
+    g->v[8] = (int32_t)cg;
+}
+
+/// Maps r from (-2p, p) to [0, p), negating it first if sign is negative.
+static inline void normalize_30(
+    BigIntS270 *r,
+    int32_t sign,
+    BigIntS270 *p
+) {
+    const int32_t mask = 0x3FFFFFFF;
+    int32_t cond_add, cond_negate;
+
+    // Add p if r is negative, and then negate if requested.
+    cond_add = r->v[8] >> 31;
+    cond_negate = sign >> 31;
+    for (int i = 0; i < 9; i ++) {
+        r->v[i] += p->v[i] & cond_add;
+        r->v[i] = (r->v[i] ^ cond_negate) - cond_negate;
+    }
+    for (int i = 0; i < 8; i ++) {
+        r->v[i + 1] += r->v[i] >> 30;
+        r->v[i] &= mask;
+    }
+
+    // r is now in (-p, p), so add p once more if it is still negative.
+    cond_add = r->v[8] >> 31;
+    for (int i = 0; i < 9; i ++) {
+        r->v[i] += p->v[i] & cond_add;
+    }
+    for (int i = 0; i < 8; i ++) {
+        r->v[i + 1] += r->v[i] >> 30;
+        r->v[i] &= mask;
+    }
+}
+
+/// Computes x^-1 mod p in constant time. x must be in [0, p), p must be odd
+/// and at most 256 bits long, and p_inv must be p^-1 mod 2^30. Returns 0 if x
+/// is 0.
+void bigints270_inv(
+    BigIntS270 *res,
+    BigIntS270 *x,
+    BigIntS270 *p,
+    uint32_t p_inv
+) {
+    BigIntS270 d = {{0}};
+    BigIntS270 e = {{1}};
+    BigIntS270 f = *p;
+    BigIntS270 g = *x;
+    DivstepMatrix t;
+    int32_t zeta = -1;
+
+    for (int i = 0; i < 20; i ++) {
+        zeta = divsteps_30(zeta, (uint32_t)f.v[0], (uint32_t)g.v[0], &t);
+        update_de_30(&d, &e, &t, p, p_inv);
+        update_fg_30(&f, &g, &t);
+    }
+
+    // f is now +-1, and d is +-x^-1.
+    normalize_30(&d, f.v[8], p);
+    *res = d;
+}
+
+/// Copies the 30-bit limbs of a BigInt270 into a BigIntS270.
+static inline BigIntS270 bigint270_to_signed(BigInt270 *a) {
+    BigIntS270 res;
+    for (int i = 0; i < 9; i ++) {
+        res.v[i] = (int32_t)a->v[i];
+    }
+    return res;
+}
+
+/// Copies the limbs of a BigIntS270 in [0, p) into a BigInt270.
+static inline BigInt270 bigints270_to_unsigned(BigIntS270 *a) {
+    BigInt270 res;
+    for (int i = 0; i < 9; i ++) {
+        res.v[i] = (uint64_t)a->v[i];
+    }
+    return res;
+}
+
+/// Repacks the 32-bit limbs of a BigInt256 into 30-bit limbs.
+static inline BigIntS270 bigint256_to_signed(BigInt256 *a) {
+    BigIntS270 res;
+    uint64_t acc = 0;
+    int bits = 0;
+    int j = 0;
+    for (int i = 0; i < 8; i ++) {
+        acc |= a->v[i] << bits;
+        bits += 32;
+        while (bits >= 30) {
+            res.v[j ++] = (int32_t)(acc & 0x3FFFFFFF);
+            acc >>= 30;
+            bits -= 30;
+        }
+    }
+    res.v[8] = (int32_t)acc;
+    return res;
+}
+
+/// Repacks the 30-bit limbs of a BigIntS270 in [0, 2^256) into 32-bit limbs.
+static inline BigInt256 bigints270_to_bigint256(BigIntS270 *a) {
+    BigInt256 res;
+    uint64_t acc = 0;
+    int bits = 0;
+    int j = 0;
+    for (int i = 0; i < 9; i ++) {
+        acc |= (uint64_t)a->v[i] << bits;
+        bits += 30;
+        while (bits >= 32 && j < 8) {
+            res.v[j ++] = acc & 0xFFFFFFFF;
+            acc >>= 32;
+            bits -= 32;
+        }
+    }
+    return res;
+}
+
+/// Inverts a Montgomery-form value with 30-bit limbs, returning the result in
+/// Montgomery form: given a * R mod p, returns a^-1 * R mod p, where R = 2^270.
+/// The plain inverse of a * R is a^-1 * R^-1, so it is multiplied by
+/// r3 = R^3 mod p to get back into Montgomery form. mu is the same constant
+/// that mont_mul_9x30 takes (-p^-1 mod 2^30). Runs in constant time, as the
+/// final multiplication uses mont_mul_9x30_ct, and returns 0 if ar is 0.
+BigInt270 mont_inv_9x30(
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *r3
+) {
+    BigIntS270 x = bigint270_to_signed(ar);
+    BigIntS270 ps = bigint270_to_signed(p);
+    uint32_t p_inv = (uint32_t)(-mu) & 0x3FFFFFFF;
+
+    BigIntS270 x_inv;
+    bigints270_inv(&x_inv, &x, &ps, p_inv);
+
+    BigInt270 res = bigints270_to_unsigned(&x_inv);
+    return mont_mul_9x30_ct(&res, r3, p, mu);
+}
+
+/// Inverts a Montgomery-form value with 32-bit limbs, returning the result in
+/// Montgomery form: given a * R mod p, returns a^-1 * R mod p, where R = 2^256.
+/// r3 must be R^3 mod p. p, p_for_redc and n0 are the same parameters that
+/// mont_mul_cios takes. Runs in constant time, as the final multiplication
+/// uses mont_mul_cios_ct, and returns 0 if ar is 0.
+BigInt256 mont_inv_cios(
+    BigInt256 *ar,
+    BigInt256 *p,
+    uint64_t *p_for_redc,
+    uint64_t n0,
+    BigInt256 *r3
+) {
+    BigIntS270 x = bigint256_to_signed(ar);
+    BigIntS270 ps = bigint256_to_signed(p);
+    uint32_t p_inv = (uint32_t)(-n0) & 0x3FFFFFFF;
+
+    BigIntS270 x_inv;
+    bigints270_inv(&x_inv, &x, &ps, p_inv);
+
+    BigInt256 res = bigints270_to_bigint256(&x_inv);
+    return mont_mul_cios_ct(&res, r3, p, p_for_redc, n0);
+}
+
+/// The maximum number of threads that the *_mt batch inversion functions use.
+#define BATCH_INV_MAX_THREADS 64
+
+/// Batch inversion with Montgomery's trick. Sets out[k] = in[k]^-1 for k in
+/// [0, n), in Montgomery form, using one call to mont_inv_9x30 and about 3n
+/// calls to mont_mul_9x30. The prefix products in[0] * ... * in[k] are stored
+/// in scratch, which must hold n elements and can be reused across calls, so
+/// nothing is allocated. Zero inputs are treated as one when forming the
+/// products and give zero outputs, so they do not affect the other elements.
+/// out may alias in. p, mu and r3 are as for mont_inv_9x30.
+void batch_inverse_9x30(
+    BigInt270 *out,
+    BigInt270 *in,
+    size_t n,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *r3,
+    BigInt270 *scratch
+) {
+    if (n == 0) {
+        return;
+    }
+    BigInt270 p_local = *p;
+
+    // The Montgomery form of 1 is R mod p = r3 * R^-2.
+    BigInt270 unit = bigint270_new();
+    unit.v[0] = 1;
+    BigInt270 one = mont_mul_9x30(r3, &unit, &p_local, mu);
+    one = mont_mul_9x30(&one, &unit, &p_local, mu);
+    BigInt270 zero = bigint270_new();
+
+    BigInt270 acc = one;
+    BigInt270 x;
+    for (size_t k = 0; k < n; k ++) {
+        uint64_t z = limbs_zero_mask(in[k].v, 9);
+        limbs_select(x.v, in[k].v, one.v, z, 9);
+        acc = k == 0 ? x : mont_mul_9x30(&acc, &x, &p_local, mu);
+        scratch[k] = acc;
+    }
+
+    BigInt270 inv = mont_inv_9x30(&acc, &p_local, mu, r3);
+
+    // inv holds (in[0] * ... * in[k])^-1 at the start of each step.
+    BigInt270 r;
+    for (size_t k = n - 1; k > 0; k --) {
+        uint64_t z = limbs_zero_mask(in[k].v, 9);
+        limbs_select(x.v, in[k].v, one.v, z, 9);
+        r = mont_mul_9x30(&inv, &scratch[k - 1], &p_local, mu);
+        inv = mont_mul_9x30(&inv, &x, &p_local, mu);
+        limbs_select(out[k].v, r.v, zero.v, z, 9);
+    }
+    uint64_t z = limbs_zero_mask(in[0].v, 9);
+    limbs_select(out[0].v, inv.v, zero.v, z, 9);
+}
+
+/// Like batch_inverse_9x30, but for Montgomery-form values with 32-bit limbs.
+/// p, p_for_redc, n0 and r3 are as for mont_inv_cios.
+void batch_inverse_cios(
+    BigInt256 *out,
+    BigInt256 *in,
+    size_t n,
+    BigInt256 *p,
+    uint64_t *p_for_redc,
+    uint64_t n0,
+    BigInt256 *r3,
+    BigInt256 *scratch
+) {
+    if (n == 0) {
+        return;
+    }
+    BigInt256 p_local = *p;
+    uint64_t p_for_redc_local[9];
+    for (int i = 0; i < 9; i ++) {
+        p_for_redc_local[i] = p_for_redc[i];
+    }
+
+    // The Montgomery form of 1 is R mod p = r3 * R^-2.
+    BigInt256 unit = bigint_new();
+    unit.v[0] = 1;
+    BigInt256 one = mont_mul_cios(r3, &unit, &p_local, p_for_redc_local, n0);
+    one = mont_mul_cios(&one, &unit, &p_local, p_for_redc_local, n0);
+    BigInt256 zero = bigint_new();
+
+    BigInt256 acc = one;
+    BigInt256 x;
+    for (size_t k = 0; k < n; k ++) {
+        uint64_t z = limbs_zero_mask(in[k].v, 8);
+        limbs_select(x.v, in[k].v, one.v, z, 8);
+        acc = k == 0 ? x : mont_mul_cios(&acc, &x, &p_local, p_for_redc_local, n0);
+        scratch[k] = acc;
+    }
+
+    BigInt256 inv = mont_inv_cios(&acc, &p_local, p_for_redc_local, n0, r3);
+
+    BigInt256 r;
+    for (size_t k = n - 1; k > 0; k --) {
+        uint64_t z = limbs_zero_mask(in[k].v, 8);
+        limbs_select(x.v, in[k].v, one.v, z, 8);
+        r = mont_mul_cios(&inv, &scratch[k - 1], &p_local, p_for_redc_local, n0);
+        inv = mont_mul_cios(&inv, &x, &p_local, p_for_redc_local, n0);
+        limbs_select(out[k].v, r.v, zero.v, z, 8);
+    }
+    uint64_t z = limbs_zero_mask(in[0].v, 8);
+    limbs_select(out[0].v, inv.v, zero.v, z, 8);
+}
+
+typedef struct {
+    BigInt270 *out;
+    BigInt270 *in;
+    size_t n;
+    BigInt270 *p;
+    uint64_t mu;
+    BigInt270 *r3;
+    BigInt270 *scratch;
+} BatchInverse9x30Task;
+
+static void *batch_inverse_9x30_worker(void *arg) {
+    BatchInverse9x30Task *t = (BatchInverse9x30Task *)arg;
+    batch_inverse_9x30(t->out, t->in, t->n, t->p, t->mu, t->r3, t->scratch);
+    return NULL;
+}
+
+/// Multi-threaded batch_inverse_9x30. The array is split into num_threads
+/// contiguous chunks, and each chunk is inverted on its own thread with its
+/// own inversion, using the matching slice of scratch. num_threads is capped
+/// at BATCH_INV_MAX_THREADS. If a thread cannot be started (for example in a
+/// wasm build without -pthread), its chunk runs on the calling thread.
+void batch_inverse_9x30_mt(
+    BigInt270 *out,
+    BigInt270 *in,
+    size_t n,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *r3,
+    BigInt270 *scratch,
+    int num_threads
+) {
+    if (num_threads > BATCH_INV_MAX_THREADS) {
+        num_threads = BATCH_INV_MAX_THREADS;
+    }
+    if (num_threads <= 1 || n < (size_t)num_threads) {
+        batch_inverse_9x30(out, in, n, p, mu, r3, scratch);
+        return;
+    }
+
+    pthread_t threads[BATCH_INV_MAX_THREADS];
+    bool started[BATCH_INV_MAX_THREADS];
+    BatchInverse9x30Task tasks[BATCH_INV_MAX_THREADS];
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    // Rounding chunk up can leave the last threads with nothing to do (n = 9
+    // and 4 threads gives chunks of 3), so only start as many as there are
+    // chunks. Every chunk then starts before n and is not empty.
+    num_threads = (int)((n + chunk - 1) / chunk);
+
+    for (int k = 0; k < num_threads; k ++) {
+        size_t start = k * chunk;
+        size_t len = n - start < chunk ? n - start : chunk;
+        BatchInverse9x30Task t = { out + start, in + start, len, p, mu, r3, scratch + start };
+        tasks[k] = t;
+        started[k] = pthread_create(&threads[k], NULL, batch_inverse_9x30_worker, &tasks[k]) == 0;
+        if (!started[k]) {
+            batch_inverse_9x30_worker(&tasks[k]);
+        }
+    }
+    for (int k = 0; k < num_threads; k ++) {
+        if (started[k]) {
+            pthread_join(threads[k], NULL);
+        }
+    }
+}
+
+typedef struct {
+    BigInt256 *out;
+    BigInt256 *in;
+    size_t n;
+    BigInt256 *p;
+    uint64_t *p_for_redc;
+    uint64_t n0;
+    BigInt256 *r3;
+    BigInt256 *scratch;
+} BatchInverseCiosTask;
+
+static void *batch_inverse_cios_worker(void *arg) {
+    BatchInverseCiosTask *t = (BatchInverseCiosTask *)arg;
+    batch_inverse_cios(t->out, t->in, t->n, t->p, t->p_for_redc, t->n0, t->r3, t->scratch);
+    return NULL;
+}
+
+/// Multi-threaded batch_inverse_cios. See batch_inverse_9x30_mt.
+void batch_inverse_cios_mt(
+    BigInt256 *out,
+    BigInt256 *in,
+    size_t n,
+    BigInt256 *p,
+    uint64_t *p_for_redc,
+    uint64_t n0,
+    BigInt256 *r3,
+    BigInt256 *scratch,
+    int num_threads
+) {
+    if (num_threads > BATCH_INV_MAX_THREADS) {
+        num_threads = BATCH_INV_MAX_THREADS;
+    }
+    if (num_threads <= 1 || n < (size_t)num_threads) {
+        batch_inverse_cios(out, in, n, p, p_for_redc, n0, r3, scratch);
+        return;
+    }
+
+    pthread_t threads[BATCH_INV_MAX_THREADS];
+    bool started[BATCH_INV_MAX_THREADS];
+    BatchInverseCiosTask tasks[BATCH_INV_MAX_THREADS];
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    // Rounding chunk up can leave the last threads with nothing to do (n = 9
+    // and 4 threads gives chunks of 3), so only start as many as there are
+    // chunks. Every chunk then starts before n and is not empty.
+    num_threads = (int)((n + chunk - 1) / chunk);
+
+    for (int k = 0; k < num_threads; k ++) {
+        size_t start = k * chunk;
+        size_t len = n - start < chunk ? n - start : chunk;
+        BatchInverseCiosTask t = { out + start, in + start, len, p, p_for_redc, n0, r3, scratch + start };
+        tasks[k] = t;
+        started[k] = pthread_create(&threads[k], NULL, batch_inverse_cios_worker, &tasks[k]) == 0;
+        if (!started[k]) {
+            batch_inverse_cios_worker(&tasks[k]);
+        }
+    }
+    for (int k = 0; k < num_threads; k ++) {
+        if (started[k]) {
+            pthread_join(threads[k], NULL);
+        }
+    }
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "./bigint.h"
 #include "./bigintf.h"
 #include <stdint.h>
@@ -10,8 +12,18 @@
 // - Non-SIMD CIOS (51-bit limbs in arrays of doubles) from BM17
 // - SIMD CIOS (51-bit limbs in arrays of doubles) from BM17
 // - Niall's SIMD algo using f64s
+// - Niall's SIMD algo using f64s, with both lanes computing independent products
 // - Non-SIMD CIOS (30-bit limbs in arrays of uint64_t) from Mitscha-Baude
 // - Non-SIMD CIOS (29-bit limbs in arrays of uint64_t) from Mitscha-Baude
+// - Montgomery squaring for the 29-bit, 30-bit, 32-bit and f64 kernels
+// - Lazy (unreduced) 29-bit and 30-bit Montgomery multiplication and squaring
+// - 29-bit, 30-bit and 32-bit multiplication for moduli where p = 1 mod 2^w
+// - gnark's no-carry CIOS multiplication and squaring with 32-bit limbs
+// - Branch-free final subtraction (*_ct), used by the batched kernels and by
+//   constant-time exponentiation
+// - Dot products with 30-bit limbs and one reduction per block of terms
+// - SIMD BM17 with i64x2.extmul_{low,high}_u32x4 instead of i64x2.mul
+// - SIMD CIOS with four independent products, one per 32-bit lane
 
 /// Returns the higher 29 bits.
 static inline uint64_t hi_29(uint64_t v) {
@@ -75,7 +87,21 @@ void sub_261(
     }
 }
 
-BigInt261 mont_mul_9x29(
+/// Maps a value in [0, 2p), such as the output of mont_mul_9x29_lazy, to
+/// [0, p).
+BigInt261 canonicalize_261(
+    BigInt261 *a,
+    BigInt261 *p
+) {
+    BigInt261 res;
+    bigint261_reduce(&res, a, p);
+    return res;
+}
+
+/// Computes ar * br * R^-1 mod p into s without the final conditional
+/// subtraction. See mont_mul_9x29_lazy.
+static inline void mont_mul_9x29_unreduced(
+    uint64_t *s,
     BigInt261 *ar,
     BigInt261 *br,
     BigInt261 *p,
@@ -83,8 +109,10 @@ BigInt261 mont_mul_9x29(
 ) {
     //const int nsafe = 32;
     const size_t NUM_LIMBS = 9;
-    uint64_t s[9] = {0};
     uint64_t t, t_lo, qi, c;
+    for (int i = 0; i < 9; i ++) {
+        s[i] = 0;
+    }
 
     for (int i = 0; i < NUM_LIMBS; i ++) {
         t = s[0] + ar->v[i] * br->v[0];
@@ -111,6 +139,16 @@ BigInt261 mont_mul_9x29(
         s[i] = lo_29(c);
         c = hi_29(c);
     }
+}
+
+BigInt261 mont_mul_9x29(
+    BigInt261 *ar,
+    BigInt261 *br,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    uint64_t s[9];
+    mont_mul_9x29_unreduced(s, ar, br, p, mu);
 
     // Conditional reduction
     BigInt261 res = bigint261_new();
@@ -128,6 +166,306 @@ BigInt261 mont_mul_9x29(
     return res;
 }
 
+/// Like mont_mul_9x29, but skips the final compare-and-subtract. If
+/// the inputs are in [0, 2p) and 4p < R, which holds for moduli of up to 253
+/// bits, the output is also in [0, 2p), so it can be fed straight back in.
+/// Call canonicalize_261() at the end of a chain to get a value in [0, p).
+BigInt261 mont_mul_9x29_lazy(
+    BigInt261 *ar,
+    BigInt261 *br,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    BigInt261 res;
+    mont_mul_9x29_unreduced(res.v, ar, br, p, mu);
+    return res;
+}
+
+/// Like mont_mul_9x29, but with a branch-free final subtraction
+/// (limbs_reduce), so the running time does not depend on whether the result
+/// is above p. The *_batch functions use this.
+BigInt261 mont_mul_9x29_ct(
+    BigInt261 *ar,
+    BigInt261 *br,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    BigInt261 res;
+    mont_mul_9x29_unreduced(res.v, ar, br, p, mu);
+    limbs_reduce(res.v, res.v, p->v, 9, 29);
+    return res;
+}
+
+/// Like mont_mul_9x29_unreduced, but for moduli where p = 1 mod 2^29, so
+/// mu = 2^29 - 1 and the lowest limb of p is 1. Then q = -t mod 2^29, which is a
+/// subtraction and a mask rather than a multiplication, and t + q * p_0 = t + q.
+/// This removes both multiplications from the start of each row, which the
+/// rest of the row depends on.
+static inline void mont_mul_9x29_p1_unreduced(
+    uint64_t *s,
+    BigInt261 *ar,
+    BigInt261 *br,
+    BigInt261 *p
+) {
+    const size_t NUM_LIMBS = 9;
+    uint64_t t, qi, c;
+    for (int i = 0; i < 9; i ++) {
+        s[i] = 0;
+    }
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        t = s[0] + ar->v[i] * br->v[0];
+        qi = lo_29(0 - t);
+        c = hi_29(t + qi);
+
+        t = s[1] + ar->v[i] * br->v[1] + qi * p->v[1];
+        s[0] = t + c;
+        for (int j = 2; j < NUM_LIMBS - 1; j ++) {
+            t = s[j] + ar->v[i] * br->v[j] + qi * p->v[j];
+            s[j - 1] = t;
+        }
+        s[NUM_LIMBS - 2] = ar->v[i] * br->v[NUM_LIMBS - 1] + qi * p->v[NUM_LIMBS - 1];
+    }
+
+    c = 0;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        c = s[i] + c;
+        s[i] = lo_29(c);
+        c = hi_29(c);
+    }
+}
+
+/// Like mont_mul_9x29, but only for moduli where p = 1 mod 2^29, such as the
+/// BLS12-377 scalar field. See mont_mul_9x29_p1_unreduced. MontCtx records
+/// whether this holds, and mont_ctx_mul_9x29 picks this kernel when it does.
+BigInt261 mont_mul_9x29_p1(
+    BigInt261 *ar,
+    BigInt261 *br,
+    BigInt261 *p
+) {
+    BigInt261 res;
+    mont_mul_9x29_p1_unreduced(res.v, ar, br, p);
+    if (gt_261(res.v, p)) {
+        sub_261(res.v, res.v, p);
+    }
+    return res;
+}
+
+/// Computes ar * ar * R^-1 mod p into s without the final conditional
+/// subtraction. See mont_sqr_9x29_lazy.
+///
+/// Every row is written out, with the accumulator in locals, so the products
+/// a[i] * a[j] for j > i are added in the same pass as q * p. With loops over
+/// the part of each row that has them, the compiler did not unroll the rows,
+/// and squaring was slower than mont_mul_9x29(ar, ar).
+static inline void mont_sqr_9x29_unreduced(
+    uint64_t *s,
+    BigInt261 *ar,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    const uint64_t *a = ar->v;
+    const uint64_t *m = p->v;
+    uint64_t t, qi, c, ai2;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // Row 0: s is zero, and a[0]^2 is the only product in the lowest column
+    ai2 = 2 * a[0];
+    t = a[0] * a[0];
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = qi * m[1] + ai2 * a[1] + c;
+    s1 = qi * m[2] + ai2 * a[2];
+    s2 = qi * m[3] + ai2 * a[3];
+    s3 = qi * m[4] + ai2 * a[4];
+    s4 = qi * m[5] + ai2 * a[5];
+    s5 = qi * m[6] + ai2 * a[6];
+    s6 = qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 1. In row i, the columns below i only get q * p, column i gets
+    // a[i]^2, and column j > i gets 2 * a[i] * a[j], shifted down by one limb.
+    ai2 = 2 * a[1];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + a[1] * a[1] + c;
+    s1 = s2 + qi * m[2] + ai2 * a[2];
+    s2 = s3 + qi * m[3] + ai2 * a[3];
+    s3 = s4 + qi * m[4] + ai2 * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 2
+    ai2 = 2 * a[2];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2] + a[2] * a[2];
+    s2 = s3 + qi * m[3] + ai2 * a[3];
+    s3 = s4 + qi * m[4] + ai2 * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 3
+    ai2 = 2 * a[3];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3] + a[3] * a[3];
+    s3 = s4 + qi * m[4] + ai2 * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 4
+    ai2 = 2 * a[4];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4] + a[4] * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 5
+    ai2 = 2 * a[5];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5] + a[5] * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 6
+    ai2 = 2 * a[6];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5];
+    s5 = s6 + qi * m[6] + a[6] * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 7
+    ai2 = 2 * a[7];
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5];
+    s5 = s6 + qi * m[6];
+    s6 = s7 + qi * m[7] + a[7] * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 8
+    t = s0;
+    qi = lo_29(mu * lo_29(t));
+    c = hi_29(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5];
+    s5 = s6 + qi * m[6];
+    s6 = s7 + qi * m[7];
+    s7 = qi * m[8] + a[8] * a[8];
+
+    c = s0;
+    s[0] = lo_29(c);
+    c = s1 + hi_29(c);
+    s[1] = lo_29(c);
+    c = s2 + hi_29(c);
+    s[2] = lo_29(c);
+    c = s3 + hi_29(c);
+    s[3] = lo_29(c);
+    c = s4 + hi_29(c);
+    s[4] = lo_29(c);
+    c = s5 + hi_29(c);
+    s[5] = lo_29(c);
+    c = s6 + hi_29(c);
+    s[6] = lo_29(c);
+    c = s7 + hi_29(c);
+    s[7] = lo_29(c);
+    s[8] = hi_29(c);
+}
+
+/// Montgomery squaring with 29-bit limbs. This follows mont_mul_9x29, but
+/// row i only adds ar[i] * ar[j] for j >= i, with the cross terms doubled, so
+/// the product takes 45 limb multiplications instead of 81. Every column ends
+/// up with the same total as mont_mul_9x29(ar, ar), and no intermediate value
+/// exceeds that total, so the same lazy carry handling is safe.
+BigInt261 mont_sqr_9x29(
+    BigInt261 *ar,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    uint64_t s[9];
+    mont_sqr_9x29_unreduced(s, ar, p, mu);
+
+    // Conditional reduction
+    BigInt261 res = bigint261_new();
+    if (gt_261(s, p)) {
+        sub_261(res.v, s, p);
+    } else {
+        for (int i = 0; i < 9; i ++) {
+            res.v[i] = s[i];
+        }
+    }
+    return res;
+}
+
+/// Like mont_sqr_9x29, but skips the final compare-and-subtract. If
+/// the inputs are in [0, 2p) and 4p < R, which holds for moduli of up to 253
+/// bits, the output is also in [0, 2p), so it can be fed straight back in.
+/// Call canonicalize_261() at the end of a chain to get a value in [0, p).
+BigInt261 mont_sqr_9x29_lazy(
+    BigInt261 *ar,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    BigInt261 res;
+    mont_sqr_9x29_unreduced(res.v, ar, p, mu);
+    return res;
+}
+
+/// Like mont_sqr_9x29, but with a branch-free final subtraction
+/// (limbs_reduce), as in mont_mul_9x29_ct.
+BigInt261 mont_sqr_9x29_ct(
+    BigInt261 *ar,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    BigInt261 res;
+    mont_sqr_9x29_unreduced(res.v, ar, p, mu);
+    limbs_reduce(res.v, res.v, p->v, 9, 29);
+    return res;
+}
+
 bool gt_270(
     uint64_t* s,
     BigInt270 *p
@@ -160,15 +498,21 @@ void sub_270(
     }
 }
 
-/// See
-/// https://github.com/mitschabaude/montgomery/blob/main/doc/zprize22.md#13-x-30-bit-multiplication
-/// As a side note, there's no point trying to use FMAs in Gregor's method:
-/// i.e. by representing a big integer as an array of f128s, where we store a
-/// 30-bit limb in the lower 64-bit lane. First off, when we compute a product,
-/// we need the higher and lower 30 bits, so we'll have to use Niall's
-/// int_full_product method anyway. Furthermore, we might as well use all 51
-/// bits available to us, so as to reduce the number of loop iterations.
-BigInt270 mont_mul_9x30(
+/// Maps a value in [0, 2p), such as the output of mont_mul_9x30_lazy, to
+/// [0, p).
+BigInt270 canonicalize_270(
+    BigInt270 *a,
+    BigInt270 *p
+) {
+    BigInt270 res;
+    bigint270_reduce(&res, a, p);
+    return res;
+}
+
+/// Computes ar * br * R^-1 mod p into s without the final conditional
+/// subtraction. See mont_mul_9x30_lazy.
+static inline void mont_mul_9x30_unreduced(
+    uint64_t *s,
     BigInt270 *ar,
     BigInt270 *br,
     BigInt270 *p,
@@ -176,8 +520,10 @@ BigInt270 mont_mul_9x30(
 ) {
     //const int nsafe = 8;
     const size_t NUM_LIMBS = 9;
-    uint64_t s[9] = {0};
     uint64_t t, t_lo, qi, c;
+    for (int i = 0; i < 9; i ++) {
+        s[i] = 0;
+    }
 
     for (int i = 0; i < NUM_LIMBS; i ++) {
         t = s[0] + ar->v[i] * br->v[0];
@@ -237,6 +583,24 @@ BigInt270 mont_mul_9x30(
         s[i] = lo_30(c);
         c = hi_30(c);
     }
+}
+
+/// See
+/// https://github.com/mitschabaude/montgomery/blob/main/doc/zprize22.md#13-x-30-bit-multiplication
+/// As a side note, there's no point trying to use FMAs in Gregor's method:
+/// i.e. by representing a big integer as an array of f128s, where we store a
+/// 30-bit limb in the lower 64-bit lane. First off, when we compute a product,
+/// we need the higher and lower 30 bits, so we'll have to use Niall's
+/// int_full_product method anyway. Furthermore, we might as well use all 51
+/// bits available to us, so as to reduce the number of loop iterations.
+BigInt270 mont_mul_9x30(
+    BigInt270 *ar,
+    BigInt270 *br,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    uint64_t s[9];
+    mont_mul_9x30_unreduced(s, ar, br, p, mu);
 
     // Conditional reduction
     BigInt270 res = bigint270_new();
@@ -254,6 +618,303 @@ BigInt270 mont_mul_9x30(
     return res;
 }
 
+/// Like mont_mul_9x30, but skips the final compare-and-subtract. If
+/// the inputs are in [0, 2p) and 4p < R, which holds for moduli of up to 253
+/// bits, the output is also in [0, 2p), so it can be fed straight back in.
+/// Call canonicalize_270() at the end of a chain to get a value in [0, p).
+BigInt270 mont_mul_9x30_lazy(
+    BigInt270 *ar,
+    BigInt270 *br,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 res;
+    mont_mul_9x30_unreduced(res.v, ar, br, p, mu);
+    return res;
+}
+
+/// Like mont_mul_9x30, but with a branch-free final subtraction
+/// (limbs_reduce), so the running time does not depend on whether the result
+/// is above p. The *_batch functions use this.
+BigInt270 mont_mul_9x30_ct(
+    BigInt270 *ar,
+    BigInt270 *br,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 res;
+    mont_mul_9x30_unreduced(res.v, ar, br, p, mu);
+    limbs_reduce(res.v, res.v, p->v, 9, 30);
+    return res;
+}
+
+/// Like mont_mul_9x30_unreduced, but for moduli where p = 1 mod 2^30, so
+/// mu = 2^30 - 1 and the lowest limb of p is 1. Then q = -t mod 2^30, which is a
+/// subtraction and a mask rather than a multiplication, and t + q * p_0 = t + q.
+/// This removes both multiplications from the start of each row, which the
+/// rest of the row depends on.
+static inline void mont_mul_9x30_p1_unreduced(
+    uint64_t *s,
+    BigInt270 *ar,
+    BigInt270 *br,
+    BigInt270 *p
+) {
+    const size_t NUM_LIMBS = 9;
+    uint64_t t, qi, c;
+    for (int i = 0; i < 9; i ++) {
+        s[i] = 0;
+    }
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        t = s[0] + ar->v[i] * br->v[0];
+        qi = lo_30(0 - t);
+        c = hi_30(t + qi);
+
+        t = s[1] + ar->v[i] * br->v[1] + qi * p->v[1];
+        s[0] = t + c;
+        for (int j = 2; j < NUM_LIMBS - 1; j ++) {
+            t = s[j] + ar->v[i] * br->v[j] + qi * p->v[j];
+            s[j - 1] = t;
+        }
+        s[NUM_LIMBS - 2] = ar->v[i] * br->v[NUM_LIMBS - 1] + qi * p->v[NUM_LIMBS - 1];
+    }
+
+    c = 0;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        c = s[i] + c;
+        s[i] = lo_30(c);
+        c = hi_30(c);
+    }
+}
+
+/// Like mont_mul_9x30, but only for moduli where p = 1 mod 2^30, such as the
+/// BLS12-377 scalar field. See mont_mul_9x30_p1_unreduced. MontCtx records
+/// whether this holds, and mont_ctx_mul_9x30 picks this kernel when it does.
+BigInt270 mont_mul_9x30_p1(
+    BigInt270 *ar,
+    BigInt270 *br,
+    BigInt270 *p
+) {
+    BigInt270 res;
+    mont_mul_9x30_p1_unreduced(res.v, ar, br, p);
+    if (gt_270(res.v, p)) {
+        sub_270(res.v, res.v, p);
+    }
+    return res;
+}
+
+/// Computes ar * ar * R^-1 mod p into s without the final conditional
+/// subtraction. See mont_sqr_9x30_lazy.
+///
+/// Every row is written out, with the accumulator in locals, so the products
+/// a[i] * a[j] for j > i are added in the same pass as q * p. With loops over
+/// the part of each row that has them, the compiler did not unroll the rows,
+/// and squaring was slower than mont_mul_9x30(ar, ar).
+static inline void mont_sqr_9x30_unreduced(
+    uint64_t *s,
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    const uint64_t *a = ar->v;
+    const uint64_t *m = p->v;
+    uint64_t t, qi, c, ai2;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // Row 0: s is zero, and a[0]^2 is the only product in the lowest column
+    ai2 = 2 * a[0];
+    t = a[0] * a[0];
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = qi * m[1] + ai2 * a[1] + c;
+    s1 = qi * m[2] + ai2 * a[2];
+    s2 = qi * m[3] + ai2 * a[3];
+    s3 = qi * m[4] + ai2 * a[4];
+    s4 = qi * m[5] + ai2 * a[5];
+    s5 = qi * m[6] + ai2 * a[6];
+    s6 = qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 1. In row i, the columns below i only get q * p, column i gets
+    // a[i]^2, and column j > i gets 2 * a[i] * a[j], shifted down by one limb.
+    ai2 = 2 * a[1];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + a[1] * a[1] + c;
+    s1 = s2 + qi * m[2] + ai2 * a[2];
+    s2 = s3 + qi * m[3] + ai2 * a[3];
+    s3 = s4 + qi * m[4] + ai2 * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 2
+    ai2 = 2 * a[2];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2] + a[2] * a[2];
+    s2 = s3 + qi * m[3] + ai2 * a[3];
+    s3 = s4 + qi * m[4] + ai2 * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 3
+    ai2 = 2 * a[3];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3] + a[3] * a[3];
+    s3 = s4 + qi * m[4] + ai2 * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 4
+    ai2 = 2 * a[4];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4] + a[4] * a[4];
+    s4 = s5 + qi * m[5] + ai2 * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 5
+    ai2 = 2 * a[5];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5] + a[5] * a[5];
+    s5 = s6 + qi * m[6] + ai2 * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 6
+    ai2 = 2 * a[6];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5];
+    s5 = s6 + qi * m[6] + a[6] * a[6];
+    s6 = s7 + qi * m[7] + ai2 * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 7
+    ai2 = 2 * a[7];
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5];
+    s5 = s6 + qi * m[6];
+    s6 = s7 + qi * m[7] + a[7] * a[7];
+    s7 = qi * m[8] + ai2 * a[8];
+
+    // Row 8
+    t = s0;
+    qi = lo_30(mu * lo_30(t));
+    c = hi_30(t + qi * m[0]);
+    s0 = s1 + qi * m[1] + c;
+    s1 = s2 + qi * m[2];
+    s2 = s3 + qi * m[3];
+    s3 = s4 + qi * m[4];
+    s4 = s5 + qi * m[5];
+    s5 = s6 + qi * m[6];
+    s6 = s7 + qi * m[7];
+    s7 = qi * m[8] + a[8] * a[8];
+
+    c = s0;
+    s[0] = lo_30(c);
+    c = s1 + hi_30(c);
+    s[1] = lo_30(c);
+    c = s2 + hi_30(c);
+    s[2] = lo_30(c);
+    c = s3 + hi_30(c);
+    s[3] = lo_30(c);
+    c = s4 + hi_30(c);
+    s[4] = lo_30(c);
+    c = s5 + hi_30(c);
+    s[5] = lo_30(c);
+    c = s6 + hi_30(c);
+    s[6] = lo_30(c);
+    c = s7 + hi_30(c);
+    s[7] = lo_30(c);
+    s[8] = hi_30(c);
+}
+
+/// Montgomery squaring with 30-bit limbs. See mont_sqr_9x29; the lazy carries
+/// are the same as those of mont_mul_9x30 with nsafe == 8.
+BigInt270 mont_sqr_9x30(
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    uint64_t s[9];
+    mont_sqr_9x30_unreduced(s, ar, p, mu);
+
+    // Conditional reduction
+    BigInt270 res = bigint270_new();
+    if (gt_270(s, p)) {
+        sub_270(res.v, s, p);
+    } else {
+        for (int i = 0; i < 9; i ++) {
+            res.v[i] = s[i];
+        }
+    }
+    return res;
+}
+
+/// Like mont_sqr_9x30, but skips the final compare-and-subtract. If
+/// the inputs are in [0, 2p) and 4p < R, which holds for moduli of up to 253
+/// bits, the output is also in [0, 2p), so it can be fed straight back in.
+/// Call canonicalize_270() at the end of a chain to get a value in [0, p).
+BigInt270 mont_sqr_9x30_lazy(
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 res;
+    mont_sqr_9x30_unreduced(res.v, ar, p, mu);
+    return res;
+}
+
+/// Like mont_sqr_9x30, but with a branch-free final subtraction
+/// (limbs_reduce), as in mont_mul_9x30_ct.
+BigInt270 mont_sqr_9x30_ct(
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 res;
+    mont_sqr_9x30_unreduced(res.v, ar, p, mu);
+    limbs_reduce(res.v, res.v, p->v, 9, 30);
+    return res;
+}
+
 /// Compares the most significant limb of val agaist that of p.
 bool msl_is_greater(
     BigIntF255 *val,
@@ -274,6 +935,30 @@ BigIntF255 reduce_bigintf(
     return *val;
 }
 
+/// Branch-free version of reduce_bigintf. The top limbs are compared as
+/// signed integers, which orders them in the same way as comparing them as
+/// doubles, and the comparison is turned into a mask that selects between p
+/// and 0 for the subtraction. mont_mul_cios_f64_simd_batch uses this.
+BigIntF255 reduce_bigintf_ct(
+    BigIntF255 *val,
+    BigIntF255 *p
+) {
+    int64_t val_top, p_top;
+    memcpy(&val_top, &(val->v[4]), sizeof(int64_t));
+    memcpy(&p_top, &(p->v[4]), sizeof(int64_t));
+    uint64_t sub_p = 0 - (uint64_t) (val_top > p_top);
+
+    BigIntF255 res = bigintf_new();
+    uint64_t a_limb, b_limb, s;
+    for (int i = 0; i < 5; i ++) {
+        memcpy(&a_limb, &(val->v[i]), sizeof(uint64_t));
+        memcpy(&b_limb, &(p->v[i]), sizeof(uint64_t));
+        s = a_limb - (b_limb & sub_p);
+        memcpy(&(res.v[i]), &s, sizeof(uint64_t));
+    }
+    return res;
+}
+
 /// TODO: document what this does; it appears to perform carries.
 BigIntF255 resolve_bigintf(BigIntF255 *val) {
     uint64_t B = 51;
@@ -307,12 +992,15 @@ BigIntF255 resolve_bigintf(BigIntF255 *val) {
     return r;
 }
 
-/// Adapted from https://github.com/z-prize/2023-entries/tree/main/prize-2-msm-wasm/prize-2b-twisted-edwards/yrrid-snarkify
-BigIntF255 mont_mul_cios_f64_simd(
+/// Shared body of mont_mul_cios_f64_simd and mont_mul_cios_f64_simd_x2. If
+/// both_lanes is false, only lane 0 is computed correctly and q1 is left as a
+/// constant to save a multiplication.
+static inline BigIntF255 mont_mul_cios_f64_simd_lanes(
     BigIntF255 *ar,
     BigIntF255 *br,
     BigIntF255 *p,
-    uint64_t n0
+    uint64_t n0,
+    bool both_lanes
 ) {
     f128 term, c2, c3, c4, bd[5], lh[5];
     i128 sum[11], c0, c1;
@@ -368,7 +1056,11 @@ BigIntF255 mont_mul_cios_f64_simd(
         }
 
         q0 = i64x2_extract_l(sum[0]) * n0;
-        q1 = 0x4338000000000000L;//i64x2_extract_h(sum[0]) * n0;
+        if (both_lanes) {
+            q1 = i64x2_extract_h(sum[0]) * n0;
+        } else {
+            q1 = 0x4338000000000000L;
+        }
         term = f64x2_sub(
                 i2f(
                     i64x2_add(
@@ -417,27 +1109,188 @@ BigIntF255 mont_mul_cios_f64_simd(
     return res;
 }
 
-/// Amine Mrabet, Nadia El-Mrabet, Ronan Lashermes, Jean-Baptiste Rigaud, Belgacem Bouallegue, et
-/// al.. High-performance Elliptic Curve Cryptography by Using the CIOS Method for Modular
-/// Multiplication. CRiSIS 2016, Sep 2016, Roscoff, France. hal-01383162
-/// https://inria.hal.science/hal-01383162/document, page 4
-/// Also see Acar, 1996.
-/// This is the "classic" CIOS algorithm.
-/// Does not implement the gnark optimisation (https://hackmd.io/@gnark/modular_multiplication),
-/// but that should be useful.
-/// Does not use SIMD instructions.
-BigInt256 mont_mul_cios(
-    BigInt256 *ar,
-    BigInt256 *br,
-    BigInt256 *p,
-    uint64_t* p_for_redc,
+/// Adapted from https://github.com/z-prize/2023-entries/tree/main/prize-2-msm-wasm/prize-2b-twisted-edwards/yrrid-snarkify
+/// Only lane 0 of each limb is used.
+BigIntF255 mont_mul_cios_f64_simd(
+    BigIntF255 *ar,
+    BigIntF255 *br,
+    BigIntF255 *p,
     uint64_t n0
 ) {
-    size_t NUM_LIMBS = 8;
-    size_t B = 32;
-    uint64_t mask = 0xffffffff;
+    return mont_mul_cios_f64_simd_lanes(ar, br, p, n0, false);
+}
 
-    uint64_t t[10] = {0};
+/// Computes two independent Montgomery products per call, one per f128 lane.
+/// ar and br should be packed with bigintf255_pack(), and p should hold the
+/// modulus in both lanes (i.e. bigintf255_pack(&p, &p)). The result is in the
+/// same integer form as the output of mont_mul_cios_f64_simd; use
+/// bigintf255_unpack() followed by reduce_bigintf() and resolve_bigintf() on
+/// each half.
+BigIntF255x2 mont_mul_cios_f64_simd_x2(
+    BigIntF255x2 *ar,
+    BigIntF255x2 *br,
+    BigIntF255x2 *p,
+    uint64_t n0
+) {
+    return mont_mul_cios_f64_simd_lanes(ar, br, p, n0, true);
+}
+
+/// Shared body of mont_sqr_cios_f64_simd and mont_sqr_cios_f64_simd_x2. Row i
+/// only computes ar[i] * ar[j] for j >= i, with the cross terms multiplied by
+/// 2 * ar[i]. 2 * ar[i] * ar[j] is below 2^103, so the FMA split into high and
+/// low halves is still exact. This saves 10 of the 25 high/low product pairs.
+static inline BigIntF255 mont_sqr_cios_f64_simd_lanes(
+    BigIntF255 *ar,
+    BigIntF255 *p,
+    uint64_t n0,
+    bool both_lanes
+) {
+    f128 term, term2, c2, c3, c4, ad[5], lh[5];
+    i128 sum[11], c0, c1;
+    uint64_t q0, q1;
+    const size_t NUM_LIMBS = 5;
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        ad[i] = ar->v[i];
+    }
+
+    // These are the magic numbers from mont_mul_cios_f64_simd, adjusted for
+    // the smaller number of high and low product halves which land in each
+    // column. Each low half adds 0x4338000000000000 and each high half adds
+    // 0x4660000000000000, and sum[k] starts at minus the total for column k.
+    sum[0] = i64x2_splat(0x7990000000000000);
+    sum[1] = i64x2_splat(0xA998000000000000);
+    sum[2] = i64x2_splat(0xDCC8000000000000);
+    sum[3] = i64x2_splat(0x0CD0000000000000);
+    sum[4] = i64x2_splat(0x4000000000000000);
+    sum[5] = i64x2_splat(0x39B0000000000000);
+    sum[6] = i64x2_splat(0x09A8000000000000);
+    sum[7] = i64x2_splat(0xD678000000000000);
+    sum[8] = i64x2_splat(0xA670000000000000);
+    sum[9] = i64x2_splat(0x7340000000000000);
+    sum[10] = i64x2_splat(0x0);
+
+    c0 = i64x2_splat(0x7FFFFFFFFFFFFL);
+    c1 = i64x2_splat(0x4330000000000000L);
+    c2 = i2f(c1);
+    c3 = i2f(i64x2_splat(0x4660000000000000L));
+    c4 = i2f(i64x2_splat(0x4660000000000003L));
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        term = ad[i];
+        term2 = f64x2_add(term, term);
+
+        lh[i] = f64x2_fma(term, ad[i], c3);
+        for (int j = i + 1; j < NUM_LIMBS; j ++) {
+            lh[j] = f64x2_fma(term2, ad[j], c3);
+        }
+
+        for (int j = i; j < NUM_LIMBS; j ++) {
+            sum[j + 1] = i64x2_add(sum[j + 1], f2i(lh[j]));
+        }
+
+        for (int j = i; j < NUM_LIMBS; j ++) {
+            lh[j] = f64x2_sub(c4, lh[j]);
+        }
+
+        lh[i] = f64x2_fma(term, ad[i], lh[i]);
+        for (int j = i + 1; j < NUM_LIMBS; j ++) {
+            lh[j] = f64x2_fma(term2, ad[j], lh[j]);
+        }
+
+        for (int j = i; j < NUM_LIMBS; j ++) {
+            sum[j] = i64x2_add(sum[j], f2i(lh[j]));
+        }
+
+        q0 = i64x2_extract_l(sum[0]) * n0;
+        if (both_lanes) {
+            q1 = i64x2_extract_h(sum[0]) * n0;
+        } else {
+            q1 = 0x4338000000000000L;
+        }
+        term = f64x2_sub(
+                i2f(
+                    i64x2_add(
+                        i64x2_and(
+                            i64x2_make(q0, q1),
+                            c0
+                            ),
+                        c1
+                        )
+                   ),
+                c2
+            );
+
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            lh[j] = f64x2_fma(term, p->v[j], c3);
+        }
+
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            sum[j + 1] = i64x2_add(sum[j + 1], f2i(lh[j]));
+        }
+
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            lh[j] = f64x2_sub(c4, lh[j]);
+        }
+
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            lh[j] = f64x2_fma(term, p->v[j], lh[j]);
+        }
+
+        sum[0] = i64x2_add(sum[0], f2i(lh[0]));
+        sum[1] = i64x2_add(sum[1], f2i(lh[1]));
+        sum[0] = i64x2_add(sum[1], i64x2_shr(sum[0], 51));
+
+        for(int j = 1; j < 4; j ++) {
+            sum[j] = i64x2_add(sum[j + 1], f2i(lh[j + 1]));
+        }
+
+        sum[4] = sum[5];
+        sum[5] = sum[i+6];
+    }
+
+    BigIntF255 res = bigintf_new();
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res.v[i] = sum[i];
+    }
+    return res;
+}
+
+/// Montgomery squaring matched to mont_mul_cios_f64_simd: the input and output
+/// forms are the same, so the result should be passed through
+/// reduce_bigintf() and resolve_bigintf().
+BigIntF255 mont_sqr_cios_f64_simd(
+    BigIntF255 *ar,
+    BigIntF255 *p,
+    uint64_t n0
+) {
+    return mont_sqr_cios_f64_simd_lanes(ar, p, n0, false);
+}
+
+/// Two independent Montgomery squarings, one per lane. See
+/// mont_mul_cios_f64_simd_x2 for the input and output forms.
+BigIntF255x2 mont_sqr_cios_f64_simd_x2(
+    BigIntF255x2 *ar,
+    BigIntF255x2 *p,
+    uint64_t n0
+) {
+    return mont_sqr_cios_f64_simd_lanes(ar, p, n0, true);
+}
+
+/// Computes ar * br * R^-1 mod p into t[0], ..., t[8], without the final
+/// conditional subtraction. t must have room for 10 limbs. See mont_mul_cios.
+static inline void mont_mul_cios_unreduced(
+    uint64_t *t,
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t n0
+) {
+    const size_t NUM_LIMBS = 8;
+    const uint64_t mask = 0xffffffff;
+    for (int i = 0; i < NUM_LIMBS + 2; i ++) {
+        t[i] = 0;
+    }
 
     for (int i = 0; i < NUM_LIMBS; i ++) {
         uint64_t c = 0;
@@ -467,6 +1320,29 @@ BigInt256 mont_mul_cios(
         t[NUM_LIMBS - 1] = lo(cs);
         t[NUM_LIMBS] = t[NUM_LIMBS + 1] + c;
     }
+}
+
+/// Amine Mrabet, Nadia El-Mrabet, Ronan Lashermes, Jean-Baptiste Rigaud, Belgacem Bouallegue, et
+/// al.. High-performance Elliptic Curve Cryptography by Using the CIOS Method for Modular
+/// Multiplication. CRiSIS 2016, Sep 2016, Roscoff, France. hal-01383162
+/// https://inria.hal.science/hal-01383162/document, page 4
+/// Also see Acar, 1996.
+/// This is the "classic" CIOS algorithm.
+/// Does not implement the gnark optimisation (https://hackmd.io/@gnark/modular_multiplication);
+/// see mont_mul_cios_nocarry for that.
+/// Does not use SIMD instructions.
+BigInt256 mont_mul_cios(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t* p_for_redc,
+    uint64_t n0
+) {
+    size_t NUM_LIMBS = 8;
+    size_t B = 32;
+
+    uint64_t t[10];
+    mont_mul_cios_unreduced(t, ar, br, p, n0);
 
     bool t_gt_p = false;
     for (int idx = 0; idx < NUM_LIMBS + 1; idx ++) {
@@ -519,112 +1395,444 @@ BigInt256 mont_mul_cios(
     return res;
 }
 
-/// Algorithm 4 of "Montgomery Arithmetic from a Software Perspective" by Bos and Montgomery
-/// without SIMD opcodes.
-BigInt256 bm17_non_simd_mont_mul(
+/// Like mont_mul_cios, but with a branch-free final subtraction: t - p is
+/// always computed, and the borrow selects between t and t - p with a mask,
+/// instead of scanning for the first limb where t and p differ. The *_batch
+/// functions use this.
+BigInt256 mont_mul_cios_ct(
     BigInt256 *ar,
     BigInt256 *br,
     BigInt256 *p,
-    uint64_t mu
+    uint64_t* p_for_redc,
+    uint64_t n0
 ) {
-    size_t NUM_LIMBS = 8;
-    size_t B = 32;
-    uint64_t mask = 0xffffffff;
-    uint64_t d[8] = {0};
-    uint64_t e[8] = {0};
-    uint64_t mu_b0 = mu * br->v[0];
-    uint64_t q, t0, t1, d0_minus_e0;
+    const size_t NUM_LIMBS = 8;
+    uint64_t t[10];
+    mont_mul_cios_unreduced(t, ar, br, p, n0);
 
-    for (int j = 0; j < NUM_LIMBS; j ++) {
-        d0_minus_e0 = d[0] - e[0];
-        q = (mu_b0 * ar->v[j] + mu * d0_minus_e0) & mask;
-        t0 = (ar->v[j] * br->v[0] + d[0]) >> B;
-        t1 = (q * p->v[0] + e[0]) >> B;
+    uint64_t d[9];
+    uint64_t borrow = 0;
+    uint64_t diff;
+    for (int i = 0; i < NUM_LIMBS + 1; i ++) {
+        diff = t[i] - p_for_redc[i] - borrow;
+        d[i] = lo(diff);
+        borrow = (diff >> 32) & 1;
+    }
 
-        uint64_t p0, p1;
-        for (int i = 1; i < NUM_LIMBS; i ++) {
-            p0 = ar->v[j] * br->v[i] + t0 + d[i];
-            t0 = p0 >> B;
-            d[i - 1] = p0 & mask;
-            p1 = q * p->v[i] + t1 + e[i];
-            t1 = p1 >> B;
-            e[i - 1] = p1 & mask;
-        }
-        d[NUM_LIMBS - 1] = t0;
-        e[NUM_LIMBS - 1] = t1;
+    uint64_t keep_t = 0 - borrow;
+    BigInt256 res;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res.v[i] = (t[i] & keep_t) | (d[i] & ~keep_t);
     }
+    return res;
+}
 
-    BigInt256 d_bigint = bigint_new();
-    BigInt256 e_bigint = bigint_new();
+/// Like mont_mul_cios, but only for moduli where p = 1 mod 2^32, so n0 =
+/// 2^32 - 1 and the lowest limb of p is 1. Then m = -t_0 mod 2^32, which is a
+/// subtraction and a mask rather than a multiplication, and t_0 + m * p_0 =
+/// t_0 + m. As in mont_sqr_cios, the result is less than 2p, so the final
+/// subtraction is done on 256-bit values; this requires p < 2^255.
+/// MontCtx records whether p = 1 mod 2^32, and mont_ctx_mul_cios picks this
+/// kernel when it does.
+BigInt256 mont_mul_cios_p1(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p
+) {
+    const size_t NUM_LIMBS = 8;
+    uint64_t t[10] = {0};
 
     for (int i = 0; i < NUM_LIMBS; i ++) {
-        d_bigint.v[i] = d[i];
-        e_bigint.v[i] = e[i];
-    }
+        uint64_t c = 0;
+        uint64_t cs;
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            cs = t[j] + ar->v[i] * br->v[j] + c;
+            c = hi(cs);
+            t[j] = lo(cs);
+        }
+        cs = t[NUM_LIMBS] + c;
+        c = hi(cs);
+        t[NUM_LIMBS] = lo(cs);
+        t[NUM_LIMBS + 1] = c;
 
-    BigInt256 res;
-    res = bigint_new();
-    if (bigint_gt(&e_bigint, &d_bigint)) {
-        BigInt256 e_minus_d;
-        bigint_sub(&e_minus_d, &e_bigint, &d_bigint);
-        bigint_sub(&res, p, &e_minus_d);
-    } else {
-        bigint_sub(&res, &d_bigint, &e_bigint);
+        uint64_t m = lo(0 - t[0]);
+        c = hi(t[0] + m);
+
+        for (int j = 1; j < NUM_LIMBS; j ++) {
+            cs = t[j] + m * p->v[j] + c;
+            c = hi(cs);
+            t[j - 1] = lo(cs);
+        }
+
+        cs = t[NUM_LIMBS] + c;
+        c = hi(cs);
+        t[NUM_LIMBS - 1] = lo(cs);
+        t[NUM_LIMBS] = t[NUM_LIMBS + 1] + c;
     }
 
+    BigInt256 res = bigint_new();
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res.v[i] = t[i];
+    }
+    if (!bigint_gt(p, &res)) {
+        bigint_sub(&res, &res, p);
+    }
     return res;
 }
 
-/// Algorithm 4 of "Montgomery Arithmetic from a Software Perspective" by Bos and Montgomery
-/// Uses WASM SIMD opcodes.
-/// Counterintuitively, in browsers, this runs slower than the non-SIMD version, likely because the
-/// SIMD opcodes are emulated rather than executed using the native processor's SIMD instructions. 
-/// The performance difference can be seen in benchmarks.
-/// See https://emscripten.org/docs/porting/simd.html#optimization-considerations for a list of
-/// *some* WASM SIMD instructions which do not have equivalent x86 semantics; those which this
-/// function uses probably suffer from the same issue.
-/// Also see:
-/// https://github.com/coreboot/vboot/blob/060efa0cf64d4b7ccbe3e88140c9da5f747355ee/firmware/2lib/2modpow_sse2.c#L113
-/// Note: overflow-checks = false should be set in Cargo.toml under [profile.dev], so the Wrapping
-/// trait does not have to be used.
-BigInt256 bm17_simd_mont_mul(
+/// Computes ar^2 * R^-1 mod p into res, without the final conditional
+/// subtraction, so res is in [0, 2p). See mont_sqr_cios.
+static inline void mont_sqr_cios_unreduced(
+    BigInt256 *res,
     BigInt256 *ar,
-    BigInt256 *br,
     BigInt256 *p,
-    uint64_t mu
+    uint64_t n0
 ) {
     const size_t NUM_LIMBS = 8;
-    uint64_t mask_64 = 0xffffffff;
-    i128 mask = i64x2_make(mask_64, mask_64);
+    uint64_t t[16] = {0};
+    uint64_t c, cs;
 
-    i128 de[8] = {
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-        i64x2_make(0, 0),
-    };
+    // Cross products
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        c = 0;
+        for (int j = i + 1; j < NUM_LIMBS; j ++) {
+            cs = t[i + j] + ar->v[i] * ar->v[j] + c;
+            t[i + j] = lo(cs);
+            c = hi(cs);
+        }
+        t[i + NUM_LIMBS] = c;
+    }
 
-    uint64_t mu_b0 = mu * br->v[0];
+    // Double the cross products and add the squares in a single pass. Each
+    // limb is below 2^32, so 2 * t[i] plus a 32-bit half of a square and a
+    // small carry fits in 64 bits.
+    c = 0;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        uint64_t sq = ar->v[i] * ar->v[i];
+        cs = 2 * t[2 * i] + lo(sq) + c;
+        t[2 * i] = lo(cs);
+        c = hi(cs);
+        cs = 2 * t[2 * i + 1] + hi(sq) + c;
+        t[2 * i + 1] = lo(cs);
+        c = hi(cs);
+    }
 
-    i128 bp[8];
+    // Montgomery reduction. Rather than propagating each row's carry all the
+    // way up, the carry out of t[i + NUM_LIMBS] is held in top and added in
+    // the next row.
+    uint64_t top = 0;
     for (int i = 0; i < NUM_LIMBS; i ++) {
-        bp[i] = i64x2_make(br->v[i], p->v[i]);
+        uint64_t m = (t[i] * n0) & 0xffffffff;
+        c = 0;
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            cs = t[i + j] + m * p->v[j] + c;
+            t[i + j] = lo(cs);
+            c = hi(cs);
+        }
+        cs = t[i + NUM_LIMBS] + c + top;
+        t[i + NUM_LIMBS] = lo(cs);
+        top = hi(cs);
     }
 
-    uint64_t d0, e0, d0_minus_e0, q;
-    i128 aq, t01;
+    // The result is less than 2p < 2^256, so top is zero.
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res->v[i] = t[NUM_LIMBS + i];
+    }
+}
 
-    for (int j = 0; j < NUM_LIMBS; j ++) {
-        // Compute q
-        d0 = i64x2_extract_l(de[0]);
-        e0 = i64x2_extract_h(de[0]);
-        d0_minus_e0 = d0 - e0;
+/// Montgomery squaring with 32-bit limbs. The cross products are computed
+/// once, the 16-limb result is doubled and the squares are added, and then the
+/// product is reduced limb by limb (SOS). This takes 36
+/// limb products for the square instead of 64.
+/// Does not use SIMD instructions.
+BigInt256 mont_sqr_cios(
+    BigInt256 *ar,
+    BigInt256 *p,
+    uint64_t n0
+) {
+    BigInt256 res;
+    mont_sqr_cios_unreduced(&res, ar, p, n0);
 
-        // q = (mub0)aj + mu(d0 - e0) mod 2^32
+    if (!bigint_gt(p, &res)) {
+        bigint_sub(&res, &res, p);
+    }
+    return res;
+}
+
+/// Like mont_sqr_cios, but with a branch-free final subtraction, as in
+/// mont_mul_cios_ct.
+BigInt256 mont_sqr_cios_ct(
+    BigInt256 *ar,
+    BigInt256 *p,
+    uint64_t n0
+) {
+    BigInt256 res;
+    mont_sqr_cios_unreduced(&res, ar, p, n0);
+    limbs_reduce(res.v, res.v, p->v, 8, 32);
+    return res;
+}
+
+/// CIOS with the gnark optimisation
+/// (https://hackmd.io/@gnark/modular_multiplication), for moduli whose top
+/// 32-bit limb is less than 0x7FFFFFFF. The product of a limb of ar with br and
+/// the reduction by m * p are interleaved in a single pass over t, and the
+/// carries out of the top limb of each always fit in one limb together, so
+/// t needs only 8 limbs instead of 10, and the carries into t[8] and t[9] are
+/// not propagated.
+/// Does not use SIMD instructions.
+BigInt256 mont_mul_cios_nocarry(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t n0
+) {
+    const size_t NUM_LIMBS = 8;
+    uint64_t t[8] = {0};
+    uint64_t a, c, cs, m;
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        cs = t[0] + ar->v[i] * br->v[0];
+        a = hi(cs);
+        t[0] = lo(cs);
+        m = (t[0] * n0) & 0xffffffff;
+        c = hi(t[0] + m * p->v[0]);
+
+        for (int j = 1; j < NUM_LIMBS; j ++) {
+            cs = t[j] + ar->v[i] * br->v[j] + a;
+            a = hi(cs);
+            t[j] = lo(cs);
+            cs = t[j] + m * p->v[j] + c;
+            c = hi(cs);
+            t[j - 1] = lo(cs);
+        }
+        t[NUM_LIMBS - 1] = c + a;
+    }
+
+    BigInt256 res = bigint_new();
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res.v[i] = t[i];
+    }
+    if (!bigint_gt(p, &res)) {
+        bigint_sub(&res, &res, p);
+    }
+    return res;
+}
+
+/// Squaring counterpart of mont_mul_cios_nocarry, for moduli whose top 32-bit
+/// limb is less than 0x3FFFFFFF. In row i, the square of limb i is added at
+/// t[i] and the doubled cross products with the limbs above it at t[i + 1],
+/// ..., so each cross product is only computed once. Doubling needs the second
+/// spare bit. The doubled product can be up to 65 bits, so its halves are
+/// doubled separately.
+BigInt256 mont_sqr_cios_nocarry(
+    BigInt256 *ar,
+    BigInt256 *p,
+    uint64_t n0
+) {
+    const size_t NUM_LIMBS = 8;
+    uint64_t t[8] = {0};
+    uint64_t a, c, cs, m, pr;
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        cs = t[i] + ar->v[i] * ar->v[i];
+        c = hi(cs);
+        t[i] = lo(cs);
+        for (int j = i + 1; j < NUM_LIMBS; j ++) {
+            pr = ar->v[i] * ar->v[j];
+            cs = t[j] + 2 * lo(pr) + c;
+            t[j] = lo(cs);
+            c = hi(cs) + 2 * hi(pr);
+        }
+        a = c;
+
+        m = (t[0] * n0) & 0xffffffff;
+        c = hi(t[0] + m * p->v[0]);
+        for (int j = 1; j < NUM_LIMBS; j ++) {
+            cs = t[j] + m * p->v[j] + c;
+            c = hi(cs);
+            t[j - 1] = lo(cs);
+        }
+        t[NUM_LIMBS - 1] = c + a;
+    }
+
+    BigInt256 res = bigint_new();
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res.v[i] = t[i];
+    }
+    if (!bigint_gt(p, &res)) {
+        bigint_sub(&res, &res, p);
+    }
+    return res;
+}
+
+/// Runs the main loop of bm17_non_simd_mont_mul, leaving the result as d - e,
+/// which is in (-p, p).
+static inline void bm17_non_simd_mont_mul_unreduced(
+    uint64_t *d,
+    uint64_t *e,
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    const size_t NUM_LIMBS = 8;
+    const size_t B = 32;
+    const uint64_t mask = 0xffffffff;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        d[i] = 0;
+        e[i] = 0;
+    }
+    uint64_t mu_b0 = mu * br->v[0];
+    uint64_t q, t0, t1, d0_minus_e0;
+
+    for (int j = 0; j < NUM_LIMBS; j ++) {
+        d0_minus_e0 = d[0] - e[0];
+        q = (mu_b0 * ar->v[j] + mu * d0_minus_e0) & mask;
+        t0 = (ar->v[j] * br->v[0] + d[0]) >> B;
+        t1 = (q * p->v[0] + e[0]) >> B;
+
+        uint64_t p0, p1;
+        for (int i = 1; i < NUM_LIMBS; i ++) {
+            p0 = ar->v[j] * br->v[i] + t0 + d[i];
+            t0 = p0 >> B;
+            d[i - 1] = p0 & mask;
+            p1 = q * p->v[i] + t1 + e[i];
+            t1 = p1 >> B;
+            e[i - 1] = p1 & mask;
+        }
+        d[NUM_LIMBS - 1] = t0;
+        e[NUM_LIMBS - 1] = t1;
+    }
+}
+
+/// Algorithm 4 of "Montgomery Arithmetic from a Software Perspective" by Bos and Montgomery
+/// without SIMD opcodes.
+BigInt256 bm17_non_simd_mont_mul(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    size_t NUM_LIMBS = 8;
+    uint64_t d[8];
+    uint64_t e[8];
+    bm17_non_simd_mont_mul_unreduced(d, e, ar, br, p, mu);
+
+    BigInt256 d_bigint = bigint_new();
+    BigInt256 e_bigint = bigint_new();
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        d_bigint.v[i] = d[i];
+        e_bigint.v[i] = e[i];
+    }
+
+    BigInt256 res;
+    res = bigint_new();
+    if (bigint_gt(&e_bigint, &d_bigint)) {
+        BigInt256 e_minus_d;
+        bigint_sub(&e_minus_d, &e_bigint, &d_bigint);
+        bigint_sub(&res, p, &e_minus_d);
+    } else {
+        bigint_sub(&res, &d_bigint, &e_bigint);
+    }
+
+    return res;
+}
+
+/// Like bm17_non_simd_mont_mul, but with a branch-free final step: d - e is
+/// always computed, and p is added back under a mask built from the borrow,
+/// instead of comparing e and d first. The *_batch functions use this.
+BigInt256 bm17_non_simd_mont_mul_ct(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    const int NUM_LIMBS = 8;
+    uint64_t d[8];
+    uint64_t e[8];
+    bm17_non_simd_mont_mul_unreduced(d, e, ar, br, p, mu);
+
+    // d - e is in (-p, p), so limbs_sub_mod adds p back under the borrow mask.
+    BigInt256 res;
+    limbs_sub_mod(res.v, d, e, p->v, NUM_LIMBS, 32);
+    return res;
+}
+
+/// Computes d - e mod p from the lanes of de, where lane 0 of de[i] holds
+/// limb i of d and lane 1 holds limb i of e, as left by the BM17 SIMD kernels.
+static inline BigInt256 bm17_simd_resolve(i128 *de, BigInt256 *p) {
+    const size_t NUM_LIMBS = 8;
+    BigInt256 d = bigint_new();
+    BigInt256 e = bigint_new();
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        d.v[i] = i64x2_extract_l(de[i]);
+        e.v[i] = i64x2_extract_h(de[i]);
+    }
+
+    BigInt256 res;
+    res = bigint_new();
+    if (bigint_gt(&e, &d)) {
+        BigInt256 e_minus_d;
+        bigint_sub(&e_minus_d, &e, &d);
+        bigint_sub(&res, p, &e_minus_d);
+    } else {
+        bigint_sub(&res, &d, &e);
+    }
+
+    return res;
+}
+
+/// Like bm17_simd_resolve, but branch-free, as in bm17_non_simd_mont_mul_ct.
+static inline BigInt256 bm17_simd_resolve_ct(i128 *de, BigInt256 *p) {
+    const int NUM_LIMBS = 8;
+    uint64_t d[8];
+    uint64_t e[8];
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        d[i] = i64x2_extract_l(de[i]);
+        e[i] = i64x2_extract_h(de[i]);
+    }
+
+    BigInt256 res;
+    limbs_sub_mod(res.v, d, e, p->v, NUM_LIMBS, 32);
+    return res;
+}
+
+/// Runs the main loop of bm17_simd_mont_mul, leaving d and e in the lanes of
+/// de for bm17_simd_resolve or bm17_simd_resolve_ct.
+static inline void bm17_simd_mont_mul_unreduced(
+    i128 *de,
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    const size_t NUM_LIMBS = 8;
+    uint64_t mask_64 = 0xffffffff;
+    i128 mask = i64x2_make(mask_64, mask_64);
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        de[i] = i64x2_make(0, 0);
+    }
+
+    uint64_t mu_b0 = mu * br->v[0];
+
+    i128 bp[8];
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        bp[i] = i64x2_make(br->v[i], p->v[i]);
+    }
+
+    uint64_t d0, e0, d0_minus_e0, q;
+    i128 aq, t01;
+
+    for (int j = 0; j < NUM_LIMBS; j ++) {
+        // Compute q
+        d0 = i64x2_extract_l(de[0]);
+        e0 = i64x2_extract_h(de[0]);
+        d0_minus_e0 = d0 - e0;
+
+        // q = (mub0)aj + mu(d0 - e0) mod 2^32
         q = (mu_b0 * ar->v[j] + mu * d0_minus_e0) & mask_64;
 
         // t0 = ajb0 + d0
@@ -660,24 +1868,596 @@ BigInt256 bm17_simd_mont_mul(
         }
         de[NUM_LIMBS - 1] = t01;
     }
+}
 
-    BigInt256 d = bigint_new();
-    BigInt256 e = bigint_new();
+/// Algorithm 4 of "Montgomery Arithmetic from a Software Perspective" by Bos and Montgomery
+/// Uses WASM SIMD opcodes.
+/// Counterintuitively, in browsers, this runs slower than the non-SIMD version, likely because the
+/// SIMD opcodes are emulated rather than executed using the native processor's SIMD instructions. 
+/// The performance difference can be seen in benchmarks.
+/// See https://emscripten.org/docs/porting/simd.html#optimization-considerations for a list of
+/// *some* WASM SIMD instructions which do not have equivalent x86 semantics; those which this
+/// function uses probably suffer from the same issue.
+/// In particular, i64x2.mul has no x86 equivalent below AVX-512. bm17_simd_extmul_mont_mul
+/// avoids it.
+/// Also see:
+/// https://github.com/coreboot/vboot/blob/060efa0cf64d4b7ccbe3e88140c9da5f747355ee/firmware/2lib/2modpow_sse2.c#L113
+/// Note: overflow-checks = false should be set in Cargo.toml under [profile.dev], so the Wrapping
+/// trait does not have to be used.
+BigInt256 bm17_simd_mont_mul(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    i128 de[8];
+    bm17_simd_mont_mul_unreduced(de, ar, br, p, mu);
+    return bm17_simd_resolve(de, p);
+}
+
+/// Like bm17_simd_mont_mul, but with the branch-free bm17_simd_resolve_ct.
+/// The *_batch functions use this.
+BigInt256 bm17_simd_mont_mul_ct(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    i128 de[8];
+    bm17_simd_mont_mul_unreduced(de, ar, br, p, mu);
+    return bm17_simd_resolve_ct(de, p);
+}
+
+/// Runs the main loop of bm17_simd_extmul_mont_mul, leaving d and e in the
+/// lanes of de as bm17_simd_mont_mul_unreduced does.
+static inline void bm17_simd_extmul_mont_mul_unreduced(
+    i128 *de,
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    const size_t NUM_LIMBS = 8;
+    uint64_t mask_64 = 0xffffffff;
+    i128 mask = i64x2_make(mask_64, mask_64);
 
     for (int i = 0; i < NUM_LIMBS; i ++) {
-        d.v[i] = i64x2_extract_l(de[i]);
-        e.v[i] = i64x2_extract_h(de[i]);
+        de[i] = i64x2_make(0, 0);
     }
 
-    BigInt256 res;
-    res = bigint_new();
-    if (bigint_gt(&e, &d)) {
-        BigInt256 e_minus_d;
-        bigint_sub(&e_minus_d, &e, &d);
-        bigint_sub(&res, p, &e_minus_d);
-    } else {
-        bigint_sub(&res, &d, &e);
+    uint64_t mu_b0 = mu * br->v[0];
+
+    i128 bp[4];
+    for (int k = 0; k < NUM_LIMBS / 2; k ++) {
+        bp[k] = i32x4_make(br->v[2 * k], p->v[2 * k], br->v[2 * k + 1], p->v[2 * k + 1]);
+    }
+
+    uint64_t d0, e0, q;
+    i128 aq, t01, p01, prod_l, prod_h;
+
+    for (int j = 0; j < NUM_LIMBS; j ++) {
+        // q = (mub0)aj + mu(d0 - e0) mod 2^32
+        d0 = i64x2_extract_l(de[0]);
+        e0 = i64x2_extract_h(de[0]);
+        q = (mu_b0 * ar->v[j] + mu * (d0 - e0)) & mask_64;
+
+        // (aj, q) in 64-bit lanes is (aj, 0, q, 0) in 32-bit lanes
+        aq = i64x2_make(ar->v[j], q);
+        aq = i32x4_shuffle(aq, aq, 0, 2, 0, 2);
+
+        for (int k = 0; k < NUM_LIMBS / 2; k ++) {
+            prod_l = u64x2_extmul_l(aq, bp[k]);
+            prod_h = u64x2_extmul_h(aq, bp[k]);
+
+            if (k == 0) {
+                // t0 = (ajb0 + d0) / 2^32
+                // t1 = (qp0 + e0) / 2^32
+                t01 = u64x2_shr(i64x2_add(prod_l, de[0]), 32);
+            } else {
+                p01 = i64x2_add(i64x2_add(t01, de[2 * k]), prod_l);
+                t01 = u64x2_shr(p01, 32);
+                de[2 * k - 1] = i128_and(p01, mask);
+            }
+
+            p01 = i64x2_add(i64x2_add(t01, de[2 * k + 1]), prod_h);
+            t01 = u64x2_shr(p01, 32);
+            de[2 * k] = i128_and(p01, mask);
+        }
+        de[NUM_LIMBS - 1] = t01;
+    }
+}
+
+/// Like bm17_simd_mont_mul, but multiplies with i64x2.extmul_low_u32x4 and
+/// i64x2.extmul_high_u32x4 (u64x2_extmul_l and u64x2_extmul_h) instead of
+/// i64x2.mul. Every operand is a 32-bit limb, so the 32 x 32 -> 64-bit
+/// multiplication is enough, and unlike i64x2.mul it maps to pmuludq on x86.
+///
+/// Each vector in bp holds two limbs of b and p, as (b_2k, p_2k, b_2k+1,
+/// p_2k+1) in 32-bit lanes, and aq holds (a_j, q, a_j, q), so extmul_l gives
+/// (a_j * b_2k, q * p_2k) and extmul_h gives (a_j * b_2k+1, q * p_2k+1). The
+/// carries and the accumulator de are as in bm17_simd_mont_mul.
+BigInt256 bm17_simd_extmul_mont_mul(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    i128 de[8];
+    bm17_simd_extmul_mont_mul_unreduced(de, ar, br, p, mu);
+    return bm17_simd_resolve(de, p);
+}
+
+/// Like bm17_simd_extmul_mont_mul, but with the branch-free
+/// bm17_simd_resolve_ct. The *_batch functions use this.
+BigInt256 bm17_simd_extmul_mont_mul_ct(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    i128 de[8];
+    bm17_simd_extmul_mont_mul_unreduced(de, ar, br, p, mu);
+    return bm17_simd_resolve_ct(de, p);
+}
+
+/// Four elements with 8 limbs of 32 bits, transposed: v[i] holds limb i of
+/// each element, one element per 32-bit lane.
+typedef struct {
+    i128 v[8];
+} BigInt256x4;
+
+/// Constants for mont_mul_x4, splatted across every lane.
+typedef struct {
+    /// The limbs of p in each 32-bit lane, for u64x2_extmul_l and _h
+    i128 p[8];
+    /// The limbs of p in each 64-bit lane, for the final subtraction
+    i128 p_wide[8];
+    /// -p^-1 mod 2^32 in each 32-bit lane
+    i128 n0;
+} MontParamsX4;
+
+/// Transposes the four elements a[0..3] into result.
+void bigint256_to_bigint256x4(BigInt256x4 *result, const BigInt256 *a) {
+    for (int i = 0; i < 8; i ++) {
+        result->v[i] = i32x4_make(a[0].v[i], a[1].v[i], a[2].v[i], a[3].v[i]);
+    }
+}
+
+/// Transposes a back into the four elements result[0..3].
+void bigint256x4_to_bigint256(BigInt256 *result, const BigInt256x4 *a) {
+    for (int i = 0; i < 8; i ++) {
+        result[0].v[i] = u32x4_extract(a->v[i], 0);
+        result[1].v[i] = u32x4_extract(a->v[i], 1);
+        result[2].v[i] = u32x4_extract(a->v[i], 2);
+        result[3].v[i] = u32x4_extract(a->v[i], 3);
+    }
+}
+
+void mont_x4_params_init(MontParamsX4 *mp, const BigInt256 *p, uint64_t n0) {
+    for (int i = 0; i < 8; i ++) {
+        mp->p[i] = i32x4_splat(p->v[i]);
+        mp->p_wide[i] = i64x2_splat(p->v[i]);
+    }
+    mp->n0 = i32x4_splat(n0);
+}
+
+/// Computes four independent Montgomery products ar * br * 2^-256 mod p, one
+/// per 32-bit lane, with CIOS as in mont_mul_cios_ct.
+///
+/// Unlike the BM17 kernels, which spread one product over two 64-bit lanes,
+/// every lane does the same work, so there is no shuffling within a product.
+/// The products of limbs in lanes 0 and 1 come from u64x2_extmul_l and those
+/// in lanes 2 and 3 from u64x2_extmul_h, so the accumulator t is kept as two
+/// halves, t_l and t_h, with one 32-bit limb per 64-bit lane. Lanes 0 and 2 of
+/// t_l[0] and t_h[0] are shuffled together to compute m for all four lanes
+/// with one i32x4_mul. The final subtraction is branch-free, so the lanes
+/// never diverge.
+BigInt256x4 mont_mul_x4(
+    const BigInt256x4 *ar,
+    const BigInt256x4 *br,
+    const MontParamsX4 *mp
+) {
+    const size_t NUM_LIMBS = 8;
+    const i128 mask = i64x2_splat(0xffffffff);
+    const i128 zero = i64x2_splat(0);
+
+    i128 t_l[10], t_h[10];
+    for (int i = 0; i < NUM_LIMBS + 2; i ++) {
+        t_l[i] = zero;
+        t_h[i] = zero;
+    }
+
+    i128 b, m, s_l, s_h, c_l, c_h;
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        // t += a * b_i
+        b = br->v[i];
+        c_l = zero;
+        c_h = zero;
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            s_l = i64x2_add(i64x2_add(t_l[j], u64x2_extmul_l(ar->v[j], b)), c_l);
+            s_h = i64x2_add(i64x2_add(t_h[j], u64x2_extmul_h(ar->v[j], b)), c_h);
+            t_l[j] = i128_and(s_l, mask);
+            t_h[j] = i128_and(s_h, mask);
+            c_l = u64x2_shr(s_l, 32);
+            c_h = u64x2_shr(s_h, 32);
+        }
+        s_l = i64x2_add(t_l[NUM_LIMBS], c_l);
+        s_h = i64x2_add(t_h[NUM_LIMBS], c_h);
+        t_l[NUM_LIMBS] = i128_and(s_l, mask);
+        t_h[NUM_LIMBS] = i128_and(s_h, mask);
+        t_l[NUM_LIMBS + 1] = u64x2_shr(s_l, 32);
+        t_h[NUM_LIMBS + 1] = u64x2_shr(s_h, 32);
+
+        // m = t_0 * n0 mod 2^32
+        m = i32x4_mul(i32x4_shuffle(t_l[0], t_h[0], 0, 2, 4, 6), mp->n0);
+
+        // t = (t + m * p) / 2^32
+        s_l = i64x2_add(t_l[0], u64x2_extmul_l(m, mp->p[0]));
+        s_h = i64x2_add(t_h[0], u64x2_extmul_h(m, mp->p[0]));
+        c_l = u64x2_shr(s_l, 32);
+        c_h = u64x2_shr(s_h, 32);
+        for (int j = 1; j < NUM_LIMBS; j ++) {
+            s_l = i64x2_add(i64x2_add(t_l[j], u64x2_extmul_l(m, mp->p[j])), c_l);
+            s_h = i64x2_add(i64x2_add(t_h[j], u64x2_extmul_h(m, mp->p[j])), c_h);
+            t_l[j - 1] = i128_and(s_l, mask);
+            t_h[j - 1] = i128_and(s_h, mask);
+            c_l = u64x2_shr(s_l, 32);
+            c_h = u64x2_shr(s_h, 32);
+        }
+        s_l = i64x2_add(t_l[NUM_LIMBS], c_l);
+        s_h = i64x2_add(t_h[NUM_LIMBS], c_h);
+        t_l[NUM_LIMBS - 1] = i128_and(s_l, mask);
+        t_h[NUM_LIMBS - 1] = i128_and(s_h, mask);
+        t_l[NUM_LIMBS] = i64x2_add(t_l[NUM_LIMBS + 1], u64x2_shr(s_l, 32));
+        t_h[NUM_LIMBS] = i64x2_add(t_h[NUM_LIMBS + 1], u64x2_shr(s_h, 32));
     }
 
+    // d = t - p, and keep t in the lanes where this borrows
+    i128 d_l[8], d_h[8];
+    i128 borrow_l = zero, borrow_h = zero;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        s_l = i64x2_sub(i64x2_sub(t_l[i], mp->p_wide[i]), borrow_l);
+        s_h = i64x2_sub(i64x2_sub(t_h[i], mp->p_wide[i]), borrow_h);
+        d_l[i] = i128_and(s_l, mask);
+        d_h[i] = i128_and(s_h, mask);
+        borrow_l = u64x2_shr(s_l, 63);
+        borrow_h = u64x2_shr(s_h, 63);
+    }
+    borrow_l = u64x2_shr(i64x2_sub(t_l[NUM_LIMBS], borrow_l), 63);
+    borrow_h = u64x2_shr(i64x2_sub(t_h[NUM_LIMBS], borrow_h), 63);
+    i128 keep_t_l = i64x2_sub(zero, borrow_l);
+    i128 keep_t_h = i64x2_sub(zero, borrow_h);
+
+    BigInt256x4 res;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        s_l = i128_select(t_l[i], d_l[i], keep_t_l);
+        s_h = i128_select(t_h[i], d_h[i], keep_t_h);
+        res.v[i] = i32x4_shuffle(s_l, s_h, 0, 2, 4, 6);
+    }
+    return res;
+}
+
+/// Batched Montgomery multiplication. Each *_batch function computes
+/// out[k] = a[k] * b[k] * R^-1 mod p for k in [0, n) with a fixed modulus. The
+/// modulus is copied to the stack once and the single-element kernel is
+/// inlined into the loop, so the per-call overhead and struct copies are
+/// amortised over the whole batch. out may not alias a or b.
+/// The final subtraction is branch-free (the *_ct kernels and
+/// reduce_bigintf_ct), so the loop body has no data-dependent branches and
+/// the time taken does not depend on the inputs.
+
+void mont_mul_9x29_batch(
+    BigInt261 * restrict out,
+    BigInt261 * restrict a,
+    BigInt261 * restrict b,
+    size_t n,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    BigInt261 p_local = *p;
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = mont_mul_9x29_ct(&a[k], &b[k], &p_local, mu);
+    }
+}
+
+void mont_mul_9x30_batch(
+    BigInt270 * restrict out,
+    BigInt270 * restrict a,
+    BigInt270 * restrict b,
+    size_t n,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 p_local = *p;
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = mont_mul_9x30_ct(&a[k], &b[k], &p_local, mu);
+    }
+}
+
+void mont_mul_cios_batch(
+    BigInt256 * restrict out,
+    BigInt256 * restrict a,
+    BigInt256 * restrict b,
+    size_t n,
+    BigInt256 *p,
+    uint64_t* p_for_redc,
+    uint64_t n0
+) {
+    BigInt256 p_local = *p;
+    uint64_t p_for_redc_local[9];
+    for (int i = 0; i < 9; i ++) {
+        p_for_redc_local[i] = p_for_redc[i];
+    }
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = mont_mul_cios_ct(&a[k], &b[k], &p_local, p_for_redc_local, n0);
+    }
+}
+
+void bm17_non_simd_mont_mul_batch(
+    BigInt256 * restrict out,
+    BigInt256 * restrict a,
+    BigInt256 * restrict b,
+    size_t n,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    BigInt256 p_local = *p;
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = bm17_non_simd_mont_mul_ct(&a[k], &b[k], &p_local, mu);
+    }
+}
+
+void bm17_simd_mont_mul_batch(
+    BigInt256 * restrict out,
+    BigInt256 * restrict a,
+    BigInt256 * restrict b,
+    size_t n,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    BigInt256 p_local = *p;
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = bm17_simd_mont_mul_ct(&a[k], &b[k], &p_local, mu);
+    }
+}
+
+void bm17_simd_extmul_mont_mul_batch(
+    BigInt256 * restrict out,
+    BigInt256 * restrict a,
+    BigInt256 * restrict b,
+    size_t n,
+    BigInt256 *p,
+    uint64_t mu
+) {
+    BigInt256 p_local = *p;
+    for (size_t k = 0; k < n; k ++) {
+        out[k] = bm17_simd_extmul_mont_mul_ct(&a[k], &b[k], &p_local, mu);
+    }
+}
+
+/// Elements are processed four at a time with mont_mul_x4. The last n mod 4
+/// are padded with zeros.
+void mont_mul_x4_batch(
+    BigInt256 * restrict out,
+    BigInt256 * restrict a,
+    BigInt256 * restrict b,
+    size_t n,
+    BigInt256 *p,
+    uint64_t n0
+) {
+    MontParamsX4 mp;
+    mont_x4_params_init(&mp, p, n0);
+    BigInt256x4 a4, b4, r4;
+
+    size_t k = 0;
+    for (; k + 3 < n; k += 4) {
+        bigint256_to_bigint256x4(&a4, &a[k]);
+        bigint256_to_bigint256x4(&b4, &b[k]);
+        r4 = mont_mul_x4(&a4, &b4, &mp);
+        bigint256x4_to_bigint256(&out[k], &r4);
+    }
+
+    if (k < n) {
+        BigInt256 a_tail[4] = {0}, b_tail[4] = {0}, r_tail[4];
+        for (size_t i = 0; k + i < n; i ++) {
+            a_tail[i] = a[k + i];
+            b_tail[i] = b[k + i];
+        }
+        bigint256_to_bigint256x4(&a4, a_tail);
+        bigint256_to_bigint256x4(&b4, b_tail);
+        r4 = mont_mul_x4(&a4, &b4, &mp);
+        bigint256x4_to_bigint256(r_tail, &r4);
+        for (size_t i = 0; k + i < n; i ++) {
+            out[k + i] = r_tail[i];
+        }
+    }
+}
+
+/// Unlike mont_mul_cios_f64_simd, the outputs are reduced with p_for_redc and
+/// resolved back into double form, so they can be fed straight back in as
+/// inputs. Elements are processed two at a time with
+/// mont_mul_cios_f64_simd_x2.
+void mont_mul_cios_f64_simd_batch(
+    BigIntF255 * restrict out,
+    BigIntF255 * restrict a,
+    BigIntF255 * restrict b,
+    size_t n,
+    BigIntF255 *p,
+    BigIntF255 *p_for_redc,
+    uint64_t n0
+) {
+    BigIntF255x2 p2 = bigintf255_pack(p, p);
+    BigIntF255 p_for_redc_local = *p_for_redc;
+    BigIntF255x2 a2, b2, r2;
+    BigIntF255 r0, r1;
+
+    size_t k = 0;
+    for (; k + 1 < n; k += 2) {
+        a2 = bigintf255_pack(&a[k], &a[k + 1]);
+        b2 = bigintf255_pack(&b[k], &b[k + 1]);
+        r2 = mont_mul_cios_f64_simd_x2(&a2, &b2, &p2, n0);
+        bigintf255_unpack(&r2, &r0, &r1);
+        r0 = reduce_bigintf_ct(&r0, &p_for_redc_local);
+        r1 = reduce_bigintf_ct(&r1, &p_for_redc_local);
+        out[k] = resolve_bigintf(&r0);
+        out[k + 1] = resolve_bigintf(&r1);
+    }
+
+    if (k < n) {
+        BigIntF255 p_local = *p;
+        r0 = mont_mul_cios_f64_simd(&a[k], &b[k], &p_local, n0);
+        r0 = reduce_bigintf_ct(&r0, &p_for_redc_local);
+        out[k] = resolve_bigintf(&r0);
+    }
+}
+
+/// The number of terms that mont_dot_9x30 accumulates before each Montgomery
+/// reduction. The sum of 2^16 products of values in [0, p) is below
+/// 2^16 * p^2, which is below R * p for p < 2^254, so a single reduction
+/// brings it below 2p.
+#define MONT_DOT_9X30_BLOCK 65536
+
+/// Adds the double-width product a * b to the accumulator of mont_dot_9x30.
+/// Column k of the product is a sum of up to 9 limb products, so it is below
+/// 9 * 2^60 and only just fits in 64 bits. It is split: the low 30 bits are
+/// added to acc[k] and the rest to acc[k + 1]. Each word grows by less than
+/// 2^35 per term, so none overflows within a block, and the columns are only
+/// carried once per block. The columns are written out, so that each is summed
+/// in a local rather than in an array that is cleared for every term.
+static inline void mont_dot_9x30_acc(
+    uint64_t *acc,
+    const uint64_t *a,
+    const uint64_t *b
+) {
+    uint64_t col;
+    col = a[0] * b[0];
+    acc[0] += lo_30(col);
+    acc[1] += hi_30(col);
+    col = a[0] * b[1] + a[1] * b[0];
+    acc[1] += lo_30(col);
+    acc[2] += hi_30(col);
+    col = a[0] * b[2] + a[1] * b[1] + a[2] * b[0];
+    acc[2] += lo_30(col);
+    acc[3] += hi_30(col);
+    col = a[0] * b[3] + a[1] * b[2] + a[2] * b[1] + a[3] * b[0];
+    acc[3] += lo_30(col);
+    acc[4] += hi_30(col);
+    col = a[0] * b[4] + a[1] * b[3] + a[2] * b[2] + a[3] * b[1] + a[4] * b[0];
+    acc[4] += lo_30(col);
+    acc[5] += hi_30(col);
+    col = a[0] * b[5] + a[1] * b[4] + a[2] * b[3] + a[3] * b[2] + a[4] * b[1]
+        + a[5] * b[0];
+    acc[5] += lo_30(col);
+    acc[6] += hi_30(col);
+    col = a[0] * b[6] + a[1] * b[5] + a[2] * b[4] + a[3] * b[3] + a[4] * b[2]
+        + a[5] * b[1] + a[6] * b[0];
+    acc[6] += lo_30(col);
+    acc[7] += hi_30(col);
+    col = a[0] * b[7] + a[1] * b[6] + a[2] * b[5] + a[3] * b[4] + a[4] * b[3]
+        + a[5] * b[2] + a[6] * b[1] + a[7] * b[0];
+    acc[7] += lo_30(col);
+    acc[8] += hi_30(col);
+    col = a[0] * b[8] + a[1] * b[7] + a[2] * b[6] + a[3] * b[5] + a[4] * b[4]
+        + a[5] * b[3] + a[6] * b[2] + a[7] * b[1] + a[8] * b[0];
+    acc[8] += lo_30(col);
+    acc[9] += hi_30(col);
+    col = a[1] * b[8] + a[2] * b[7] + a[3] * b[6] + a[4] * b[5] + a[5] * b[4]
+        + a[6] * b[3] + a[7] * b[2] + a[8] * b[1];
+    acc[9] += lo_30(col);
+    acc[10] += hi_30(col);
+    col = a[2] * b[8] + a[3] * b[7] + a[4] * b[6] + a[5] * b[5] + a[6] * b[4]
+        + a[7] * b[3] + a[8] * b[2];
+    acc[10] += lo_30(col);
+    acc[11] += hi_30(col);
+    col = a[3] * b[8] + a[4] * b[7] + a[5] * b[6] + a[6] * b[5] + a[7] * b[4]
+        + a[8] * b[3];
+    acc[11] += lo_30(col);
+    acc[12] += hi_30(col);
+    col = a[4] * b[8] + a[5] * b[7] + a[6] * b[6] + a[7] * b[5] + a[8] * b[4];
+    acc[12] += lo_30(col);
+    acc[13] += hi_30(col);
+    col = a[5] * b[8] + a[6] * b[7] + a[7] * b[6] + a[8] * b[5];
+    acc[13] += lo_30(col);
+    acc[14] += hi_30(col);
+    col = a[6] * b[8] + a[7] * b[7] + a[8] * b[6];
+    acc[14] += lo_30(col);
+    acc[15] += hi_30(col);
+    col = a[7] * b[8] + a[8] * b[7];
+    acc[15] += lo_30(col);
+    acc[16] += hi_30(col);
+    col = a[8] * b[8];
+    acc[16] += lo_30(col);
+    acc[17] += hi_30(col);
+}
+
+/// Carries the accumulator of mont_dot_9x30 into 18 limbs, and reduces them
+/// with one Montgomery reduction. As in mont_mul_9x30, only the carry out of
+/// the lowest limb is propagated in each row. Returns the sum times R^-1,
+/// in [0, p).
+static inline BigInt270 mont_dot_9x30_reduce(
+    uint64_t *acc,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    const int NUM_LIMBS = 9;
+    uint64_t t[18];
+    uint64_t c = 0;
+    for (int k = 0; k < 2 * NUM_LIMBS; k ++) {
+        c += acc[k];
+        t[k] = lo_30(c);
+        c = hi_30(c);
+    }
+
+    uint64_t q;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        q = lo_30(t[i] * mu);
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            t[i + j] += q * p->v[j];
+        }
+        t[i + 1] += hi_30(t[i]);
+    }
+
+    BigInt270 res;
+    c = 0;
+    for (int j = 0; j < NUM_LIMBS; j ++) {
+        c += t[NUM_LIMBS + j];
+        res.v[j] = lo_30(c);
+        c = hi_30(c);
+    }
+    limbs_reduce(res.v, res.v, p->v, 9, 30);
+    return res;
+}
+
+/// Computes the sum of a[k] * b[k] * R^-1 mod p for k in [0, n), for a[k] and
+/// b[k] in [0, p). If the inputs are in Montgomery form, so is the result,
+/// which is the same as adding up the outputs of mont_mul_9x30.
+///
+/// Rather than a Montgomery multiplication per term, the double-width
+/// products are added up in the spare bits of the 64-bit words (see
+/// mont_dot_9x30_acc) and reduced once per MONT_DOT_9X30_BLOCK terms.
+BigInt270 mont_dot_9x30(
+    BigInt270 *a,
+    BigInt270 *b,
+    size_t n,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 p_local = *p;
+    BigInt270 res = bigint270_new();
+    BigInt270 block_sum;
+    uint64_t acc[18];
+
+    for (size_t start = 0; start < n; start += MONT_DOT_9X30_BLOCK) {
+        size_t end = n - start < MONT_DOT_9X30_BLOCK ? n : start + MONT_DOT_9X30_BLOCK;
+        for (int k = 0; k < 18; k ++) {
+            acc[k] = 0;
+        }
+        for (size_t k = start; k < end; k ++) {
+            mont_dot_9x30_acc(acc, a[k].v, b[k].v);
+        }
+        block_sum = mont_dot_9x30_reduce(acc, &p_local, mu);
+        bigint270_add_mod(&res, &res, &block_sum, &p_local);
+    }
     return res;
 }
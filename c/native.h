@@ -0,0 +1,258 @@
+#pragma once
+
+#include "./bigint.h"
+#include <stdint.h>
+
+// Native Montgomery arithmetic with 4 x 64-bit limbs.
+//
+// The other kernels in this directory target WebAssembly, where the widest
+// multiplication is 64 x 64 -> 64 bits, so they use limbs of at most 32 bits.
+// On 64-bit hosts, unsigned __int128 gives the full 128-bit product of two
+// 64-bit limbs in one or two instructions (mul or mulx on x86-64, mul and
+// umulh on AArch64), so 4 limbs of 64 bits need 16 limb products per
+// multiplication instead of 64. This is the usual native baseline, and gives
+// the WASM kernels an upper bound to compare against.
+//
+// This header only needs bigint.h, and not simd.h, so it builds without
+// -DWASM. See the native targets in the Makefile.
+//
+// Done:
+// - CIOS Montgomery multiplication and squaring with 64-bit limbs
+// - Modular addition and subtraction with 64-bit limbs
+
+#if !defined(__SIZEOF_INT128__)
+#error native.h needs a compiler with unsigned __int128.
+#endif
+
+typedef unsigned __int128 uint128_t;
+
+// 4 x 64-bit limbs in little-endian form.
+typedef struct {
+    uint64_t v[4];
+} BigInt_4_64;
+
+/// Converts a from 8 limbs of 32 bits to 4 limbs of 64 bits.
+void bigint256_to_bigint_4_64(BigInt_4_64 *result, const BigInt256 *a) {
+    for (int i = 0; i < 4; i ++) {
+        result->v[i] = a->v[2 * i] | (a->v[2 * i + 1] << 32);
+    }
+}
+
+/// Converts a from 4 limbs of 64 bits to 8 limbs of 32 bits.
+void bigint_4_64_to_bigint256(BigInt256 *result, const BigInt_4_64 *a) {
+    for (int i = 0; i < 4; i ++) {
+        result->v[2 * i] = a->v[i] & 0xffffffff;
+        result->v[2 * i + 1] = a->v[i] >> 32;
+    }
+}
+
+/// Parses a 64-character big-endian hex string. Returns 0 on success and -1
+/// otherwise, as hex_to_bigint256 does.
+int hex_to_bigint_4_64(const char *hex_str, BigInt_4_64 *val) {
+    BigInt256 v;
+    if (hex_to_bigint256(hex_str, &v) != 0) {
+        return -1;
+    }
+    bigint256_to_bigint_4_64(val, &v);
+    return 0;
+}
+
+bool bigint_4_64_eq(const BigInt_4_64 *a, const BigInt_4_64 *b) {
+    return ((a->v[0] ^ b->v[0]) | (a->v[1] ^ b->v[1]) |
+            (a->v[2] ^ b->v[2]) | (a->v[3] ^ b->v[3])) == 0;
+}
+
+/// Constants for the 4 x 64-bit kernels.
+typedef struct {
+    BigInt_4_64 p;
+    /// R^2 mod p, with R = 2^256, for conversion into Montgomery form
+    BigInt_4_64 r2;
+    /// -p^-1 mod 2^64
+    uint64_t n0;
+} MontParams4x64;
+
+/// Computes the constants in mp for the modulus p. Returns 0 on success, and
+/// -1 if bigint_is_valid_modulus rejects p.
+int mont_4x64_init(MontParams4x64 *mp, const BigInt256 *p) {
+    if (!bigint_is_valid_modulus(p)) {
+        return -1;
+    }
+    bigint256_to_bigint_4_64(&mp->p, p);
+    mp->n0 = 0 - inv_mod_2_64(mp->p.v[0]);
+
+    // R^2 mod p = 2^512 mod p
+    BigInt256 r2 = bigint_pow2_mod(512, p);
+    bigint256_to_bigint_4_64(&mp->r2, &r2);
+    return 0;
+}
+
+/// Returns t - p if the 5-limb value t is at least p, and t otherwise, without
+/// a branch. t must be below 2p.
+static inline BigInt_4_64 mont_4x64_reduce(const uint64_t *t, const BigInt_4_64 *p) {
+    BigInt_4_64 res, d;
+    uint128_t diff;
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i ++) {
+        diff = (uint128_t) t[i] - p->v[i] - borrow;
+        d.v[i] = (uint64_t) diff;
+        borrow = (uint64_t) (diff >> 64) & 1;
+    }
+    // t >= p unless the subtraction borrowed out of the top limb of t
+    uint64_t keep_t = 0 - (uint64_t) (borrow > t[4]);
+    for (int i = 0; i < 4; i ++) {
+        res.v[i] = (t[i] & keep_t) | (d.v[i] & ~keep_t);
+    }
+    return res;
+}
+
+/// Montgomery multiplication with 4 x 64-bit limbs (CIOS, as in
+/// mont_mul_cios). Computes ar * br * 2^-256 mod p for ar and br in [0, p).
+BigInt_4_64 mont_mul_4x64(
+    const BigInt_4_64 *ar,
+    const BigInt_4_64 *br,
+    const BigInt_4_64 *p,
+    uint64_t n0
+) {
+    uint64_t t[6] = {0};
+    uint128_t uv;
+    uint64_t c, m;
+
+    for (int i = 0; i < 4; i ++) {
+        c = 0;
+        for (int j = 0; j < 4; j ++) {
+            uv = (uint128_t) ar->v[j] * br->v[i] + t[j] + c;
+            t[j] = (uint64_t) uv;
+            c = (uint64_t) (uv >> 64);
+        }
+        uv = (uint128_t) t[4] + c;
+        t[4] = (uint64_t) uv;
+        t[5] = (uint64_t) (uv >> 64);
+
+        m = t[0] * n0;
+        uv = (uint128_t) m * p->v[0] + t[0];
+        c = (uint64_t) (uv >> 64);
+        for (int j = 1; j < 4; j ++) {
+            uv = (uint128_t) m * p->v[j] + t[j] + c;
+            t[j - 1] = (uint64_t) uv;
+            c = (uint64_t) (uv >> 64);
+        }
+        uv = (uint128_t) t[4] + c;
+        t[3] = (uint64_t) uv;
+        t[4] = t[5] + (uint64_t) (uv >> 64);
+    }
+
+    return mont_4x64_reduce(t, p);
+}
+
+/// Montgomery squaring with 4 x 64-bit limbs. The 8-limb square is computed
+/// first, with the 6 cross products computed once and doubled, so it takes 10
+/// limb products instead of 16, and is then reduced one limb at a time (SOS).
+/// The reduction still takes 16, so natively this is only about as fast as
+/// mont_mul_4x64(ar, ar).
+BigInt_4_64 mont_sqr_4x64(
+    const BigInt_4_64 *ar,
+    const BigInt_4_64 *p,
+    uint64_t n0
+) {
+    const uint64_t *a = ar->v;
+    uint64_t r[8] = {0};
+    uint128_t uv;
+    uint64_t c, m;
+
+    // Cross products a[i] * a[j] for i < j, one row at a time
+    uv = (uint128_t) a[0] * a[1];
+    r[1] = (uint64_t) uv;
+    uv = (uint128_t) a[0] * a[2] + (uint64_t) (uv >> 64);
+    r[2] = (uint64_t) uv;
+    uv = (uint128_t) a[0] * a[3] + (uint64_t) (uv >> 64);
+    r[3] = (uint64_t) uv;
+    r[4] = (uint64_t) (uv >> 64);
+
+    uv = (uint128_t) a[1] * a[2] + r[3];
+    r[3] = (uint64_t) uv;
+    uv = (uint128_t) a[1] * a[3] + r[4] + (uint64_t) (uv >> 64);
+    r[4] = (uint64_t) uv;
+    r[5] = (uint64_t) (uv >> 64);
+
+    uv = (uint128_t) a[2] * a[3] + r[5];
+    r[5] = (uint64_t) uv;
+    r[6] = (uint64_t) (uv >> 64);
+
+    // Double them, and add the squares a[i]^2
+    r[7] = r[6] >> 63;
+    for (int k = 6; k > 0; k --) {
+        r[k] = (r[k] << 1) | (r[k - 1] >> 63);
+    }
+    r[0] <<= 1;
+    c = 0;
+    for (int i = 0; i < 4; i ++) {
+        uv = (uint128_t) a[i] * a[i] + r[2 * i] + c;
+        r[2 * i] = (uint64_t) uv;
+        uv = (uint128_t) r[2 * i + 1] + (uint64_t) (uv >> 64);
+        r[2 * i + 1] = (uint64_t) uv;
+        c = (uint64_t) (uv >> 64);
+    }
+
+    // Montgomery reduction of the 8-limb square. top holds the carry out of
+    // the top limb, which is added in with the next row.
+    uint64_t top = 0;
+    for (int i = 0; i < 4; i ++) {
+        m = r[i] * n0;
+        c = 0;
+        for (int j = 0; j < 4; j ++) {
+            uv = (uint128_t) m * p->v[j] + r[i + j] + c;
+            r[i + j] = (uint64_t) uv;
+            c = (uint64_t) (uv >> 64);
+        }
+        uv = (uint128_t) r[i + 4] + c + top;
+        r[i + 4] = (uint64_t) uv;
+        top = (uint64_t) (uv >> 64);
+    }
+
+    uint64_t t[5] = {r[4], r[5], r[6], r[7], top};
+    return mont_4x64_reduce(t, p);
+}
+
+/// Computes a + b mod p for a and b in [0, p).
+BigInt_4_64 bigint_4_64_add_mod(
+    const BigInt_4_64 *a,
+    const BigInt_4_64 *b,
+    const BigInt_4_64 *p
+) {
+    uint64_t t[5];
+    uint128_t uv;
+    uint64_t c = 0;
+    for (int i = 0; i < 4; i ++) {
+        uv = (uint128_t) a->v[i] + b->v[i] + c;
+        t[i] = (uint64_t) uv;
+        c = (uint64_t) (uv >> 64);
+    }
+    t[4] = c;
+    return mont_4x64_reduce(t, p);
+}
+
+/// Computes a - b mod p for a and b in [0, p). p is added back with a mask if
+/// the subtraction borrows, rather than with a branch.
+BigInt_4_64 bigint_4_64_sub_mod(
+    const BigInt_4_64 *a,
+    const BigInt_4_64 *b,
+    const BigInt_4_64 *p
+) {
+    BigInt_4_64 res;
+    uint128_t uv;
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i ++) {
+        uv = (uint128_t) a->v[i] - b->v[i] - borrow;
+        res.v[i] = (uint64_t) uv;
+        borrow = (uint64_t) (uv >> 64) & 1;
+    }
+
+    uint64_t mask = 0 - borrow;
+    uint64_t c = 0;
+    for (int i = 0; i < 4; i ++) {
+        uv = (uint128_t) res.v[i] + (p->v[i] & mask) + c;
+        res.v[i] = (uint64_t) uv;
+        c = (uint64_t) (uv >> 64);
+    }
+    return res;
+}
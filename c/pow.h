@@ -0,0 +1,401 @@
+#pragma once
+
+#include "./mont.h"
+#include <stdint.h>
+
+// Modular exponentiation of Montgomery-form values.
+//
+// Done:
+// - Sliding-window exponentiation for the 29-bit, 30-bit and 32-bit kernels
+// - Constant-time fixed-window exponentiation for the same kernels
+// - Interpreters for addition chains generated by scripts/gen_addchain.py
+
+/// The width of the sliding window in the mont_pow_* functions. The table holds
+/// the 2^(POW_WINDOW - 1) odd powers of the base.
+#define POW_WINDOW 4
+
+/// The width of the fixed window in the mont_pow_*_ct functions. The table
+/// holds all 2^POW_CT_WINDOW powers of the base.
+#define POW_CT_WINDOW 4
+
+/// Returns bit i of the 256-bit exponent e.
+static inline uint64_t exp_bit(BigInt256 *e, int i) {
+    return (e->v[i >> 5] >> (i & 31)) & 1;
+}
+
+/// Returns the number of bits in e, ignoring leading zeroes.
+static inline int exp_bit_length(BigInt256 *e) {
+    for (int i = 255; i >= 0; i --) {
+        if (exp_bit(e, i)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/// Returns the POW_CT_WINDOW-bit digit at index d of e.
+static inline uint64_t exp_digit(BigInt256 *e, int d) {
+    int bit = d * POW_CT_WINDOW;
+    return (e->v[bit >> 5] >> (bit & 31)) & ((1 << POW_CT_WINDOW) - 1);
+}
+
+/// Finds the next sliding window of e, ending at bit i, which must be set.
+/// Returns the lowest bit of the window, which is always set, and stores the
+/// window's value in val.
+static inline int exp_window(BigInt256 *e, int i, uint64_t *val) {
+    int j = i - POW_WINDOW + 1;
+    if (j < 0) {
+        j = 0;
+    }
+    while (!exp_bit(e, j)) {
+        j ++;
+    }
+    *val = 0;
+    for (int k = i; k >= j; k --) {
+        *val = (*val << 1) | exp_bit(e, k);
+    }
+    return j;
+}
+
+/// Returns all ones if a == b, and 0 otherwise.
+static inline uint64_t eq_mask(uint64_t a, uint64_t b) {
+    uint64_t x = a ^ b;
+    return ((x | (0 - x)) >> 63) - 1;
+}
+
+/// Computes ar^e in Montgomery form with the 30-bit kernel, using a
+/// left-to-right sliding window. one must be the Montgomery form of 1
+/// (R mod p). The sequence of operations depends on e, so e must be public.
+/// With POW_WINDOW = 4 a 253-bit exponent costs about 252 squarings and 58
+/// multiplications.
+BigInt270 mont_pow_9x30(
+    BigInt270 *ar,
+    BigInt256 *e,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *one
+) {
+    // table[k] = ar^(2k + 1)
+    BigInt270 table[1 << (POW_WINDOW - 1)];
+    BigInt270 ar2 = mont_sqr_9x30(ar, p, mu);
+    table[0] = *ar;
+    for (int k = 1; k < (1 << (POW_WINDOW - 1)); k ++) {
+        table[k] = mont_mul_9x30(&table[k - 1], &ar2, p, mu);
+    }
+
+    BigInt270 res = *one;
+    bool started = false;
+    int i = exp_bit_length(e) - 1;
+    while (i >= 0) {
+        if (!exp_bit(e, i)) {
+            res = mont_sqr_9x30(&res, p, mu);
+            i --;
+            continue;
+        }
+        uint64_t val;
+        int j = exp_window(e, i, &val);
+        if (started) {
+            for (int k = j; k <= i; k ++) {
+                res = mont_sqr_9x30(&res, p, mu);
+            }
+            res = mont_mul_9x30(&res, &table[val >> 1], p, mu);
+        } else {
+            res = table[val >> 1];
+            started = true;
+        }
+        i = j - 1;
+    }
+    return res;
+}
+
+/// Computes ar^e in Montgomery form with the 30-bit kernel, in constant time
+/// with respect to e. All 256 bits of e are processed in fixed windows of
+/// POW_CT_WINDOW bits, and each table entry is read with a masked scan rather
+/// than an index. Every step uses mont_mul_9x30_ct or mont_sqr_9x30_ct, whose
+/// final subtraction does not branch on the running value, which depends on
+/// e. one must be the Montgomery form of 1.
+BigInt270 mont_pow_9x30_ct(
+    BigInt270 *ar,
+    BigInt256 *e,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *one
+) {
+    // table[k] = ar^k
+    BigInt270 table[1 << POW_CT_WINDOW];
+    table[0] = *one;
+    table[1] = *ar;
+    for (int k = 2; k < (1 << POW_CT_WINDOW); k ++) {
+        table[k] = mont_mul_9x30_ct(&table[k - 1], ar, p, mu);
+    }
+
+    BigInt270 res = *one;
+    BigInt270 x;
+    for (int d = 256 / POW_CT_WINDOW - 1; d >= 0; d --) {
+        for (int k = 0; k < POW_CT_WINDOW; k ++) {
+            res = mont_sqr_9x30_ct(&res, p, mu);
+        }
+        uint64_t digit = exp_digit(e, d);
+        x = table[0];
+        for (int k = 1; k < (1 << POW_CT_WINDOW); k ++) {
+            limbs_select(x.v, x.v, table[k].v, eq_mask(digit, k), 9);
+        }
+        res = mont_mul_9x30_ct(&res, &x, p, mu);
+    }
+    return res;
+}
+
+/// Like mont_pow_9x30, but with the 29-bit kernel.
+BigInt261 mont_pow_9x29(
+    BigInt261 *ar,
+    BigInt256 *e,
+    BigInt261 *p,
+    uint64_t mu,
+    BigInt261 *one
+) {
+    BigInt261 table[1 << (POW_WINDOW - 1)];
+    BigInt261 ar2 = mont_sqr_9x29(ar, p, mu);
+    table[0] = *ar;
+    for (int k = 1; k < (1 << (POW_WINDOW - 1)); k ++) {
+        table[k] = mont_mul_9x29(&table[k - 1], &ar2, p, mu);
+    }
+
+    BigInt261 res = *one;
+    bool started = false;
+    int i = exp_bit_length(e) - 1;
+    while (i >= 0) {
+        if (!exp_bit(e, i)) {
+            res = mont_sqr_9x29(&res, p, mu);
+            i --;
+            continue;
+        }
+        uint64_t val;
+        int j = exp_window(e, i, &val);
+        if (started) {
+            for (int k = j; k <= i; k ++) {
+                res = mont_sqr_9x29(&res, p, mu);
+            }
+            res = mont_mul_9x29(&res, &table[val >> 1], p, mu);
+        } else {
+            res = table[val >> 1];
+            started = true;
+        }
+        i = j - 1;
+    }
+    return res;
+}
+
+/// Like mont_pow_9x30_ct, but with the 29-bit kernel.
+BigInt261 mont_pow_9x29_ct(
+    BigInt261 *ar,
+    BigInt256 *e,
+    BigInt261 *p,
+    uint64_t mu,
+    BigInt261 *one
+) {
+    BigInt261 table[1 << POW_CT_WINDOW];
+    table[0] = *one;
+    table[1] = *ar;
+    for (int k = 2; k < (1 << POW_CT_WINDOW); k ++) {
+        table[k] = mont_mul_9x29_ct(&table[k - 1], ar, p, mu);
+    }
+
+    BigInt261 res = *one;
+    BigInt261 x;
+    for (int d = 256 / POW_CT_WINDOW - 1; d >= 0; d --) {
+        for (int k = 0; k < POW_CT_WINDOW; k ++) {
+            res = mont_sqr_9x29_ct(&res, p, mu);
+        }
+        uint64_t digit = exp_digit(e, d);
+        x = table[0];
+        for (int k = 1; k < (1 << POW_CT_WINDOW); k ++) {
+            limbs_select(x.v, x.v, table[k].v, eq_mask(digit, k), 9);
+        }
+        res = mont_mul_9x29_ct(&res, &x, p, mu);
+    }
+    return res;
+}
+
+/// Like mont_pow_9x30, but with the 32-bit CIOS kernel. p, p_for_redc and n0
+/// are as for mont_mul_cios.
+BigInt256 mont_pow_cios(
+    BigInt256 *ar,
+    BigInt256 *e,
+    BigInt256 *p,
+    uint64_t *p_for_redc,
+    uint64_t n0,
+    BigInt256 *one
+) {
+    BigInt256 table[1 << (POW_WINDOW - 1)];
+    BigInt256 ar2 = mont_sqr_cios(ar, p, n0);
+    table[0] = *ar;
+    for (int k = 1; k < (1 << (POW_WINDOW - 1)); k ++) {
+        table[k] = mont_mul_cios(&table[k - 1], &ar2, p, p_for_redc, n0);
+    }
+
+    BigInt256 res = *one;
+    bool started = false;
+    int i = exp_bit_length(e) - 1;
+    while (i >= 0) {
+        if (!exp_bit(e, i)) {
+            res = mont_sqr_cios(&res, p, n0);
+            i --;
+            continue;
+        }
+        uint64_t val;
+        int j = exp_window(e, i, &val);
+        if (started) {
+            for (int k = j; k <= i; k ++) {
+                res = mont_sqr_cios(&res, p, n0);
+            }
+            res = mont_mul_cios(&res, &table[val >> 1], p, p_for_redc, n0);
+        } else {
+            res = table[val >> 1];
+            started = true;
+        }
+        i = j - 1;
+    }
+    return res;
+}
+
+/// Like mont_pow_9x30_ct, but with the 32-bit CIOS kernel.
+BigInt256 mont_pow_cios_ct(
+    BigInt256 *ar,
+    BigInt256 *e,
+    BigInt256 *p,
+    uint64_t *p_for_redc,
+    uint64_t n0,
+    BigInt256 *one
+) {
+    BigInt256 table[1 << POW_CT_WINDOW];
+    table[0] = *one;
+    table[1] = *ar;
+    for (int k = 2; k < (1 << POW_CT_WINDOW); k ++) {
+        table[k] = mont_mul_cios_ct(&table[k - 1], ar, p, p_for_redc, n0);
+    }
+
+    BigInt256 res = *one;
+    BigInt256 x;
+    for (int d = 256 / POW_CT_WINDOW - 1; d >= 0; d --) {
+        for (int k = 0; k < POW_CT_WINDOW; k ++) {
+            res = mont_sqr_cios_ct(&res, p, n0);
+        }
+        uint64_t digit = exp_digit(e, d);
+        x = table[0];
+        for (int k = 1; k < (1 << POW_CT_WINDOW); k ++) {
+            limbs_select(x.v, x.v, table[k].v, eq_mask(digit, k), 8);
+        }
+        res = mont_mul_cios_ct(&res, &x, p, p_for_redc, n0);
+    }
+    return res;
+}
+
+/// Addition chains for fixed exponents, such as p - 2 and (p - 1) / 2, are
+/// generated at build time by scripts/gen_addchain.py (see `make chains`) as
+/// arrays of AddChainStep. Each step reads and writes numbered registers, and
+/// register 0 holds the base at the start:
+/// - ADDCHAIN_MUL sets r[dst] = r[a] * r[b].
+/// - ADDCHAIN_SQR sets r[dst] = r[a]^(2^n). With n = 0 it copies r[a].
+/// The result is left in register `result`.
+#define ADDCHAIN_MUL 0
+#define ADDCHAIN_SQR 1
+
+/// The most registers that a generated chain may use.
+#define ADDCHAIN_MAX_REGS 66
+
+typedef struct {
+    uint8_t op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    uint16_t n;
+} AddChainStep;
+
+typedef struct {
+    const AddChainStep *steps;
+    size_t len;
+    int num_regs;
+    int result;
+} AddChain;
+
+/// Computes ar^e in Montgomery form with the 30-bit kernel, where e is the
+/// exponent that the addition chain was generated for. The sequence of
+/// operations is fixed by the chain, and the branch-free _ct kernels are used,
+/// so this runs in constant time.
+BigInt270 mont_pow_chain_9x30(
+    BigInt270 *ar,
+    const AddChain *chain,
+    BigInt270 *p,
+    uint64_t mu
+) {
+    BigInt270 r[ADDCHAIN_MAX_REGS];
+    r[0] = *ar;
+    for (size_t s = 0; s < chain->len; s ++) {
+        const AddChainStep *step = &chain->steps[s];
+        if (step->op == ADDCHAIN_MUL && step->a == step->b) {
+            r[step->dst] = mont_sqr_9x30_ct(&r[step->a], p, mu);
+        } else if (step->op == ADDCHAIN_MUL) {
+            r[step->dst] = mont_mul_9x30_ct(&r[step->a], &r[step->b], p, mu);
+        } else {
+            BigInt270 x = r[step->a];
+            for (int k = 0; k < step->n; k ++) {
+                x = mont_sqr_9x30_ct(&x, p, mu);
+            }
+            r[step->dst] = x;
+        }
+    }
+    return r[chain->result];
+}
+
+/// Like mont_pow_chain_9x30, but with the 29-bit kernel.
+BigInt261 mont_pow_chain_9x29(
+    BigInt261 *ar,
+    const AddChain *chain,
+    BigInt261 *p,
+    uint64_t mu
+) {
+    BigInt261 r[ADDCHAIN_MAX_REGS];
+    r[0] = *ar;
+    for (size_t s = 0; s < chain->len; s ++) {
+        const AddChainStep *step = &chain->steps[s];
+        if (step->op == ADDCHAIN_MUL && step->a == step->b) {
+            r[step->dst] = mont_sqr_9x29_ct(&r[step->a], p, mu);
+        } else if (step->op == ADDCHAIN_MUL) {
+            r[step->dst] = mont_mul_9x29_ct(&r[step->a], &r[step->b], p, mu);
+        } else {
+            BigInt261 x = r[step->a];
+            for (int k = 0; k < step->n; k ++) {
+                x = mont_sqr_9x29_ct(&x, p, mu);
+            }
+            r[step->dst] = x;
+        }
+    }
+    return r[chain->result];
+}
+
+/// Like mont_pow_chain_9x30, but with the 32-bit CIOS kernel.
+BigInt256 mont_pow_chain_cios(
+    BigInt256 *ar,
+    const AddChain *chain,
+    BigInt256 *p,
+    uint64_t *p_for_redc,
+    uint64_t n0
+) {
+    BigInt256 r[ADDCHAIN_MAX_REGS];
+    r[0] = *ar;
+    for (size_t s = 0; s < chain->len; s ++) {
+        const AddChainStep *step = &chain->steps[s];
+        if (step->op == ADDCHAIN_MUL && step->a == step->b) {
+            r[step->dst] = mont_sqr_cios_ct(&r[step->a], p, n0);
+        } else if (step->op == ADDCHAIN_MUL) {
+            r[step->dst] = mont_mul_cios_ct(&r[step->a], &r[step->b], p, p_for_redc, n0);
+        } else {
+            BigInt256 x = r[step->a];
+            for (int k = 0; k < step->n; k ++) {
+                x = mont_sqr_cios_ct(&x, p, n0);
+            }
+            r[step->dst] = x;
+        }
+    }
+    return r[chain->result];
+}
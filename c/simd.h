@@ -64,6 +64,63 @@ i128 i128_and(i128 a, i128 b) {
     return wasm_v128_and(a, b);
 }
 
+i128 i32x4_make(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    return wasm_u32x4_make(a, b, c, d);
+}
+
+/*
+ * Multiplies the unsigned 32-bit lanes 0 and 1 of a and b into two 64-bit
+ * lanes, with i64x2.extmul_low_u32x4. Unlike i64x2.mul, which V8 lowers to a
+ * sequence of several instructions on x86, this is a pmuludq after shuffles
+ * of its inputs, and the product is exact.
+ */
+i128 u64x2_extmul_l(i128 a, i128 b) {
+    return wasm_u64x2_extmul_low_u32x4(a, b);
+}
+
+/*
+ * Like u64x2_extmul_l, but multiplies the unsigned 32-bit lanes 2 and 3.
+ */
+i128 u64x2_extmul_h(i128 a, i128 b) {
+    return wasm_u64x2_extmul_high_u32x4(a, b);
+}
+
+/*
+ * Returns the 32-bit lanes c0, c1, c2 and c3 of the concatenation of a and b,
+ * where lanes 0 to 3 are from a and lanes 4 to 7 are from b. The lane indices
+ * must be constants, so this is a macro.
+ */
+#define i32x4_shuffle(a, b, c0, c1, c2, c3) wasm_i32x4_shuffle(a, b, c0, c1, c2, c3)
+
+/*
+ * Returns the given 32-bit lane of a. The lane index must be a constant, so
+ * this is a macro.
+ */
+#define u32x4_extract(a, i) wasm_u32x4_extract_lane(a, i)
+
+i128 i32x4_splat(uint32_t a) {
+    return wasm_u32x4_splat(a);
+}
+
+/*
+ * Multiplies the 32-bit lanes of a and b, and keeps the low 32 bits of each
+ * product (pmulld on x86).
+ */
+i128 i32x4_mul(i128 a, i128 b) {
+    return wasm_i32x4_mul(a, b);
+}
+
+i128 i64x2_sub(i128 a, i128 b) {
+    return wasm_i64x2_sub(a, b);
+}
+
+/*
+ * Returns the bits of a where mask is set, and the bits of b elsewhere.
+ */
+i128 i128_select(i128 a, i128 b, i128 mask) {
+    return wasm_v128_bitselect(a, b, mask);
+}
+
 /*
  * Fused-multiply-add with relaxed SIMD. Returns a * b + c where the
  * multiplication is performed with infinite precision, and rounding occurs
@@ -79,6 +136,11 @@ inline f128 f64x2_sub(f128 a, f128 b) {
     return wasm_f64x2_sub(a, b);
 }
 
+f128 f64x2_add(f128 a, f128 b);
+inline f128 f64x2_add(f128 a, f128 b) {
+    return wasm_f64x2_add(a, b);
+}
+
 /*
  * Returns the first (index 0) 64-bit value in the given i128.
  */
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "./mont.h"
+#include <stdint.h>
+
+// Montgomery multiplication for sparse moduli.
+//
+// Many moduli used in practice have limbs that are 0 or 1. The BLS12-377
+// scalar field modulus has a low limb of 1 in every limb width, and moduli
+// of the form c * 2^k + 1 have runs of zero limbs. The kernels in mont.h still
+// compute q * p_j for every limb. The kernels here take a MontSparse, which
+// classifies the limbs of p once, and skip the product when p_j is 0, or
+// replace it with an addition of q when p_j is 1.
+//
+// The branch on the kind of each limb costs about as much as the products it
+// saves, so these kernels are not faster than the ones in mont.h (see
+// docs/src/code_sparse.md). For a modulus that is known at build time,
+// scripts/gen_mont.py drops the zero limbs from the generated code instead.
+//
+// Done:
+// - Sparse variants of mont_mul_cios, bm17_non_simd_mont_mul, mont_mul_9x30
+//   and mont_mul_9x29
+
+#define MONT_LIMB_ZERO 0
+#define MONT_LIMB_ONE 1
+#define MONT_LIMB_FULL 2
+
+/// The limbs of a modulus, classified by mont_sparse_init.
+typedef struct {
+    size_t num_limbs;
+    /// MONT_LIMB_ZERO, MONT_LIMB_ONE or MONT_LIMB_FULL for each limb of p
+    uint8_t kind[9];
+    /// The indices of the limbs from 1 upwards whose kind is MONT_LIMB_FULL,
+    /// and of those whose kind is MONT_LIMB_ONE. Limb 0 is always handled on
+    /// its own, as it determines the first carry.
+    uint8_t full[9];
+    size_t num_full;
+    uint8_t one[9];
+    size_t num_one;
+} MontSparse;
+
+/// Classifies the num_limbs limbs of p, where num_limbs is at most 9.
+void mont_sparse_init(MontSparse *sp, const uint64_t *p, size_t num_limbs) {
+    sp->num_limbs = num_limbs;
+    sp->num_full = 0;
+    sp->num_one = 0;
+    for (size_t j = 0; j < num_limbs; j ++) {
+        if (p[j] == 0) {
+            sp->kind[j] = MONT_LIMB_ZERO;
+        } else if (p[j] == 1) {
+            sp->kind[j] = MONT_LIMB_ONE;
+        } else {
+            sp->kind[j] = MONT_LIMB_FULL;
+        }
+
+        if (j == 0) {
+            continue;
+        }
+        if (sp->kind[j] == MONT_LIMB_FULL) {
+            sp->full[sp->num_full ++] = j;
+        } else if (sp->kind[j] == MONT_LIMB_ONE) {
+            sp->one[sp->num_one ++] = j;
+        }
+    }
+}
+
+/// Returns the number of products q * p_j that the sparse kernels skip in
+/// each Montgomery multiplication: one per row for each limb of p that is 0
+/// or 1.
+size_t mont_sparse_skipped_muls(MontSparse *sp) {
+    size_t num_full = sp->num_full + (sp->kind[0] == MONT_LIMB_FULL);
+    return sp->num_limbs * (sp->num_limbs - num_full);
+}
+
+/// Returns q * p_j, without a multiplication if p_j is 0 or 1. The branch
+/// takes the same path in every row, so it is well predicted.
+static inline uint64_t mont_sparse_mul_limb(
+    MontSparse *sp,
+    size_t j,
+    uint64_t q,
+    uint64_t p_j
+) {
+    if (sp->kind[j] == MONT_LIMB_FULL) {
+        return q * p_j;
+    }
+    // MONT_LIMB_ONE is 1 and MONT_LIMB_ZERO is 0, so this is q or 0.
+    return q & (0 - (uint64_t) sp->kind[j]);
+}
+
+/// Like mont_mul_cios, but skips the products q * p_j where p_j is 0 or 1.
+/// As in mont_sqr_cios, the result is less than 2p, so the final subtraction
+/// is done on 256-bit values. This requires p < 2^255, and does not need
+/// p_for_redc.
+BigInt256 mont_mul_cios_sparse(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t n0,
+    MontSparse *sp
+) {
+    const size_t NUM_LIMBS = 8;
+    uint64_t t[10] = {0};
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        uint64_t c = 0;
+        uint64_t cs;
+        for (int j = 0; j < NUM_LIMBS; j ++) {
+            cs = t[j] + ar->v[i] * br->v[j] + c;
+            c = hi(cs);
+            t[j] = lo(cs);
+        }
+        cs = t[NUM_LIMBS] + c;
+        c = hi(cs);
+        t[NUM_LIMBS] = lo(cs);
+        t[NUM_LIMBS + 1] = c;
+
+        uint64_t m = (t[0] * n0) & 0xffffffff;
+        cs = t[0] + mont_sparse_mul_limb(sp, 0, m, p->v[0]);
+        c = hi(cs);
+
+        for (int j = 1; j < NUM_LIMBS; j ++) {
+            cs = t[j] + mont_sparse_mul_limb(sp, j, m, p->v[j]) + c;
+            c = hi(cs);
+            t[j - 1] = lo(cs);
+        }
+
+        cs = t[NUM_LIMBS] + c;
+        c = hi(cs);
+        t[NUM_LIMBS - 1] = lo(cs);
+        t[NUM_LIMBS] = t[NUM_LIMBS + 1] + c;
+    }
+
+    BigInt256 res = bigint_new();
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        res.v[i] = t[i];
+    }
+    if (!bigint_gt(p, &res)) {
+        bigint_sub(&res, &res, p);
+    }
+    return res;
+}
+
+/// Like bm17_non_simd_mont_mul, but skips the products q * p_i where p_i is 0
+/// or 1.
+BigInt256 bm17_non_simd_mont_mul_sparse(
+    BigInt256 *ar,
+    BigInt256 *br,
+    BigInt256 *p,
+    uint64_t mu,
+    MontSparse *sp
+) {
+    const size_t NUM_LIMBS = 8;
+    const size_t B = 32;
+    const uint64_t mask = 0xffffffff;
+    uint64_t d[8] = {0};
+    uint64_t e[8] = {0};
+    uint64_t mu_b0 = mu * br->v[0];
+    uint64_t q, t0, t1, d0_minus_e0;
+
+    for (int j = 0; j < NUM_LIMBS; j ++) {
+        d0_minus_e0 = d[0] - e[0];
+        q = (mu_b0 * ar->v[j] + mu * d0_minus_e0) & mask;
+        t0 = (ar->v[j] * br->v[0] + d[0]) >> B;
+        t1 = (mont_sparse_mul_limb(sp, 0, q, p->v[0]) + e[0]) >> B;
+
+        uint64_t p0, p1;
+        for (int i = 1; i < NUM_LIMBS; i ++) {
+            p0 = ar->v[j] * br->v[i] + t0 + d[i];
+            t0 = p0 >> B;
+            d[i - 1] = p0 & mask;
+            p1 = mont_sparse_mul_limb(sp, i, q, p->v[i]) + t1 + e[i];
+            t1 = p1 >> B;
+            e[i - 1] = p1 & mask;
+        }
+        d[NUM_LIMBS - 1] = t0;
+        e[NUM_LIMBS - 1] = t1;
+    }
+
+    BigInt256 d_bigint = bigint_new();
+    BigInt256 e_bigint = bigint_new();
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        d_bigint.v[i] = d[i];
+        e_bigint.v[i] = e[i];
+    }
+
+    BigInt256 res = bigint_new();
+    if (bigint_gt(&e_bigint, &d_bigint)) {
+        BigInt256 e_minus_d;
+        bigint_sub(&e_minus_d, &e_bigint, &d_bigint);
+        bigint_sub(&res, p, &e_minus_d);
+    } else {
+        bigint_sub(&res, &d_bigint, &e_bigint);
+    }
+    return res;
+}
+
+/// The body of mont_mul_9x30_sparse and mont_mul_9x29_sparse, which only
+/// differ in the limb width w. As in mont_mul_9x30_unreduced, only the carry
+/// out of limb 0 is propagated within a row, so the products q * p_j can be
+/// added in any order. They are added from the lists in sp, after the
+/// products of the inputs.
+static inline void mont_mul_9xw_sparse_unreduced(
+    uint64_t *s,
+    const uint64_t *a,
+    const uint64_t *b,
+    const uint64_t *p,
+    uint64_t mu,
+    int w,
+    MontSparse *sp
+) {
+    const size_t NUM_LIMBS = 9;
+    const uint64_t mask = (1ULL << w) - 1;
+    uint64_t t, qi, c;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        s[i] = 0;
+    }
+
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        t = s[0] + a[i] * b[0];
+        qi = (mu * (t & mask)) & mask;
+        c = (t + mont_sparse_mul_limb(sp, 0, qi, p[0])) >> w;
+
+        for (int j = 1; j < NUM_LIMBS - 1; j ++) {
+            s[j - 1] = s[j] + a[i] * b[j];
+        }
+        s[NUM_LIMBS - 2] = a[i] * b[NUM_LIMBS - 1];
+        s[NUM_LIMBS - 1] = 0;
+        s[0] += c;
+
+        for (size_t k = 0; k < sp->num_full; k ++) {
+            size_t j = sp->full[k];
+            s[j - 1] += qi * p[j];
+        }
+        for (size_t k = 0; k < sp->num_one; k ++) {
+            s[sp->one[k] - 1] += qi;
+        }
+    }
+
+    c = 0;
+    for (int i = 0; i < NUM_LIMBS; i ++) {
+        c = s[i] + c;
+        s[i] = c & mask;
+        c = c >> w;
+    }
+}
+
+/// Like mont_mul_9x30, but skips the products q * p_j where p_j is 0 or 1.
+BigInt270 mont_mul_9x30_sparse(
+    BigInt270 *ar,
+    BigInt270 *br,
+    BigInt270 *p,
+    uint64_t mu,
+    MontSparse *sp
+) {
+    BigInt270 res;
+    mont_mul_9xw_sparse_unreduced(res.v, ar->v, br->v, p->v, mu, 30, sp);
+    if (gt_270(res.v, p)) {
+        uint64_t r[9];
+        sub_270(r, res.v, p);
+        for (int i = 0; i < 9; i ++) {
+            res.v[i] = r[i];
+        }
+    }
+    return res;
+}
+
+/// Like mont_mul_9x29, but skips the products q * p_j where p_j is 0 or 1.
+BigInt261 mont_mul_9x29_sparse(
+    BigInt261 *ar,
+    BigInt261 *br,
+    BigInt261 *p,
+    uint64_t mu,
+    MontSparse *sp
+) {
+    BigInt261 res;
+    mont_mul_9xw_sparse_unreduced(res.v, ar->v, br->v, p->v, mu, 29, sp);
+    if (gt_261(res.v, p)) {
+        uint64_t r[9];
+        sub_261(r, res.v, p);
+        for (int i = 0; i < 9; i ++) {
+            res.v[i] = r[i];
+        }
+    }
+    return res;
+}
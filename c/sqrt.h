@@ -0,0 +1,411 @@
+#pragma once
+
+#include "./inv.h"
+#include "./pow.h"
+#include <stdint.h>
+
+// Square roots and quadratic residuosity in prime fields, for Montgomery-form
+// values with 30-bit limbs.
+//
+// The square root is Tonelli-Shanks with the discrete logarithm in the 2-Sylow
+// subgroup computed from precomputed tables of roots of unity, as in Sarkar,
+// "Computing square roots faster than the Tonelli-Shanks/Bernstein algorithm"
+// (https://eprint.iacr.org/2020/1407). For a 2-adicity of s and a window of
+// w bits, this takes about s squarings and (s / w)^2 / 2 multiplications on top
+// of the exponentiation, instead of up to s^2 / 2 squarings.
+//
+// The Legendre symbol uses the variable-time "posdivsteps" variant of safegcd
+// from libsecp256k1
+// (https://github.com/bitcoin-core/secp256k1/blob/master/doc/safegcd_implementation.md),
+// which costs about as much as an inversion rather than an exponentiation.
+//
+// Done:
+// - Legendre symbol and is_square with divsteps
+// - Table-based Tonelli-Shanks square root
+
+/// The width of the discrete logarithm window. The tables in SqrtCtx9x30 hold
+/// 2^SQRT_WINDOW entries each.
+#define SQRT_WINDOW 6
+
+/// The most windows that the discrete logarithm may need. This allows a
+/// 2-adicity of up to SQRT_MAX_DIGITS * SQRT_WINDOW + 1.
+#define SQRT_MAX_DIGITS 8
+
+/// The size of the hash table that maps roots of unity to their logarithms.
+#define SQRT_HASH_SIZE (4 << SQRT_WINDOW)
+
+/// The number of batches of 30 posdivsteps that legendre_9x30 runs before it
+/// falls back to Euler's criterion. Posdivsteps converge more slowly than
+/// divsteps: random 253-bit inputs take about 740 of them, and rarely more than
+/// 840, so 960 leaves a margin.
+#define LEGENDRE_ITERATIONS 32
+
+/// Precomputed values for square roots modulo p. Write p - 1 = 2^s * t with t
+/// odd, and let g = z^t for a non-residue z, so that g generates the subgroup
+/// of order 2^s. All elements are in Montgomery form. This struct holds about
+/// 75 KB of tables, so allocate it on the heap or statically.
+typedef struct {
+    BigInt270 p;
+    uint64_t mu;
+    BigInt270 one;
+
+    // The 2-adicity of p, and (t - 1) / 2
+    int s;
+    BigInt256 t_minus_1_over_2;
+
+    // An optional addition chain for (t - 1) / 2, or NULL
+    const AddChain *chain;
+
+    // The discrete logarithm of an element of order 2^(s - 1) is split into
+    // num_digits windows of `window` bits each, except for the top window,
+    // which has top_width bits.
+    int window;
+    int num_digits;
+    int top_width;
+
+    // roots[k] = zeta^k, where zeta = g^(2^(s - window)), and roots_hash maps
+    // a root to k + 1 (with 0 meaning empty) by linear probing.
+    BigInt270 roots[1 << SQRT_WINDOW];
+    uint8_t roots_hash[SQRT_HASH_SIZE];
+
+    // lo[i][d] = g^(-d * 2^(i * window))
+    BigInt270 lo[SQRT_MAX_DIGITS][1 << SQRT_WINDOW];
+
+    // hi[m][d] = g^(-d * 2^(s - m * window)), for m >= 2
+    BigInt270 hi[SQRT_MAX_DIGITS][1 << SQRT_WINDOW];
+} SqrtCtx9x30;
+
+/// Runs 30 posdivsteps on the low bits of f and g, and returns the new eta.
+/// Unlike divsteps_30, this only ever adds f to g, so f and g stay positive,
+/// and it tracks the sign of the Jacobi symbol (g | f) in the bottom bit of
+/// jacp. f0 and g0 must hold at least 32 bits, as the sign depends on bits
+/// beyond the 30 that are consumed. Runs in variable time.
+static inline int32_t posdivsteps_30(
+    int32_t eta,
+    uint32_t f0,
+    uint32_t g0,
+    DivstepMatrix *t,
+    int *jacp
+) {
+    uint32_t u = 1, v = 0, q = 0, r = 1;
+    uint32_t f = f0, g = g0, m, w;
+    int i = 30, limit, zeros;
+    int jac = *jacp;
+
+    while (true) {
+        // Divide g by 2 as many times as possible, up to i. The sentinel bit
+        // stops the count at i.
+        zeros = __builtin_ctz(g | (UINT32_MAX << i));
+        g >>= zeros;
+        u <<= zeros;
+        v <<= zeros;
+        eta -= zeros;
+        i -= zeros;
+        // (2 | f) = -1 if f is 3 or 5 mod 8.
+        jac ^= (zeros & ((f >> 1) ^ (f >> 2)));
+        if (i == 0) {
+            break;
+        }
+
+        // If eta is negative, swap f and g. By quadratic reciprocity, the
+        // sign flips if both are 3 mod 4.
+        if (eta < 0) {
+            uint32_t tmp;
+            eta = -eta;
+            jac ^= ((f & g) >> 1);
+            tmp = f; f = g; g = tmp;
+            tmp = u; u = q; q = tmp;
+            tmp = v; v = r; r = tmp;
+        }
+
+        // Add the multiple of f to g that clears its bottom min(eta + 1, i, 6)
+        // bits. f * (f * f - 2) is -f^-1 mod 64.
+        limit = ((int)eta + 1) > i ? i : ((int)eta + 1);
+        m = (UINT32_MAX >> (32 - limit)) & 63U;
+        w = (f * g * (f * f - 2)) & m;
+        g += f * w;
+        q += u * w;
+        r += v * w;
+    }
+
+    t->u = (int32_t)u;
+    t->v = (int32_t)v;
+    t->q = (int32_t)q;
+    t->r = (int32_t)r;
+    *jacp = jac;
+    return eta;
+}
+
+/// Returns the Legendre symbol (x | p): 1 if x is a non-zero square mod p, -1
+/// if it is not a square, and 0 if it is 0. As R is an even power of 2, this
+/// is the same for x and its Montgomery form. Uses posdivsteps in variable
+/// time, and falls back to Euler's criterion, x^((p - 1) / 2), if they have not
+/// converged after LEGENDRE_ITERATIONS batches. mu and one are only used for
+/// the fallback.
+int legendre_9x30(
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *one
+) {
+    if (limbs_zero_mask(ar->v, 9)) {
+        return 0;
+    }
+
+    BigIntS270 f = bigint270_to_signed(p);
+    BigIntS270 g = bigint270_to_signed(ar);
+    DivstepMatrix t;
+    int32_t eta = -1;
+    int jac = 0;
+
+    for (int k = 0; k < LEGENDRE_ITERATIONS; k ++) {
+        eta = posdivsteps_30(
+            eta,
+            (uint32_t)f.v[0] | ((uint32_t)f.v[1] << 30),
+            (uint32_t)g.v[0] | ((uint32_t)g.v[1] << 30),
+            &t,
+            &jac
+        );
+        update_fg_30(&f, &g, &t);
+
+        // Once f = 1, (g | f) = 1, so the sign is all that is left.
+        if (f.v[0] == 1) {
+            int32_t rest = 0;
+            for (int i = 1; i < 9; i ++) {
+                rest |= f.v[i];
+            }
+            if (rest == 0) {
+                return 1 - 2 * (jac & 1);
+            }
+        }
+    }
+
+    // (p - 1) / 2
+    BigInt256 e;
+    BigInt270 pm1 = *p;
+    pm1.v[0] -= 1;
+    bigint270_to_bigint256_shr(&e, &pm1, 1);
+    BigInt270 x = mont_pow_9x30(ar, &e, p, mu, one);
+    return memcmp(&x, one, sizeof(BigInt270)) == 0 ? 1 : -1;
+}
+
+/// Returns true if ar is a square mod p, including 0.
+bool is_square_9x30(
+    BigInt270 *ar,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *one
+) {
+    return legendre_9x30(ar, p, mu, one) >= 0;
+}
+
+/// Returns the index of x in ctx->roots, or -1 if x is not a power of zeta.
+static inline int sqrt_dlog_lookup(SqrtCtx9x30 *ctx, BigInt270 *x) {
+    uint32_t h = (uint32_t)(x->v[0] ^ (x->v[0] >> 13) ^ x->v[1]) & (SQRT_HASH_SIZE - 1);
+    while (ctx->roots_hash[h] != 0) {
+        int k = ctx->roots_hash[h] - 1;
+        if (memcmp(&ctx->roots[k], x, sizeof(BigInt270)) == 0) {
+            return k;
+        }
+        h = (h + 1) & (SQRT_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+/// Computes the values in ctx for the modulus p. one must be the Montgomery
+/// form of 1, and chain, if not NULL, must be an addition chain for
+/// (t - 1) / 2 (addchain_<name>_t_minus_1_over_2 from scripts/gen_addchain.py).
+/// Returns 0 on success, and -1 if the 2-adicity of p is too large for the
+/// tables or no small non-residue was found.
+int sqrt_ctx_9x30_init(
+    SqrtCtx9x30 *ctx,
+    BigInt270 *p,
+    uint64_t mu,
+    BigInt270 *one,
+    const AddChain *chain
+) {
+    ctx->p = *p;
+    ctx->mu = mu;
+    ctx->one = *one;
+    ctx->chain = chain;
+
+    // p - 1 = 2^s * t
+    BigInt270 pm1 = *p;
+    pm1.v[0] -= 1;
+    int s = 0;
+    while (((pm1.v[s / 30] >> (s % 30)) & 1) == 0) {
+        s ++;
+    }
+    ctx->s = s;
+    bigint270_to_bigint256_shr(&ctx->t_minus_1_over_2, &pm1, s + 1);
+
+    // Split the s - 1 bits of the logarithm into windows.
+    int n = s - 1;
+    int w = n < SQRT_WINDOW ? n : SQRT_WINDOW;
+    int l = w == 0 ? 0 : (n + w - 1) / w;
+    if (l > SQRT_MAX_DIGITS) {
+        return -1;
+    }
+    ctx->window = w;
+    ctx->num_digits = l;
+    ctx->top_width = n - (l - 1) * w;
+
+    // Find a non-residue z among 2, 3, 4, ...
+    BigInt270 z = *one;
+    int found = 0;
+    for (int k = 2; k < 1000 && !found; k ++) {
+        bigint270_add_mod(&z, &z, one, p);
+        found = legendre_9x30(&z, p, mu, one) == -1;
+    }
+    if (!found) {
+        return -1;
+    }
+
+    // g = z^t = z^(2 * ((t - 1) / 2) + 1), and g^-1 = g^(2^s - 1)
+    BigInt270 g = mont_pow_9x30(&z, &ctx->t_minus_1_over_2, p, mu, one);
+    g = mont_sqr_9x30(&g, p, mu);
+    g = mont_mul_9x30(&g, &z, p, mu);
+    BigInt270 g_inv = g;
+    for (int k = 1; k < s; k ++) {
+        g_inv = mont_sqr_9x30(&g_inv, p, mu);
+        g_inv = mont_mul_9x30(&g_inv, &g, p, mu);
+    }
+
+    // zeta = g^(2^(s - w)) has order 2^w.
+    BigInt270 zeta = g;
+    for (int k = 0; k < s - w; k ++) {
+        zeta = mont_sqr_9x30(&zeta, p, mu);
+    }
+    memset(ctx->roots_hash, 0, sizeof(ctx->roots_hash));
+    ctx->roots[0] = *one;
+    for (int k = 0; k < (1 << w); k ++) {
+        if (k > 0) {
+            ctx->roots[k] = mont_mul_9x30(&ctx->roots[k - 1], &zeta, p, mu);
+        }
+        BigInt270 *x = &ctx->roots[k];
+        uint32_t h = (uint32_t)(x->v[0] ^ (x->v[0] >> 13) ^ x->v[1]) & (SQRT_HASH_SIZE - 1);
+        while (ctx->roots_hash[h] != 0) {
+            h = (h + 1) & (SQRT_HASH_SIZE - 1);
+        }
+        ctx->roots_hash[h] = k + 1;
+    }
+
+    // lo[i][d] = g^(-d * 2^(i * w))
+    BigInt270 base = g_inv;
+    for (int i = 0; i < l; i ++) {
+        ctx->lo[i][0] = *one;
+        for (int d = 1; d < (1 << w); d ++) {
+            ctx->lo[i][d] = mont_mul_9x30(&ctx->lo[i][d - 1], &base, p, mu);
+        }
+        for (int k = 0; k < w; k ++) {
+            base = mont_sqr_9x30(&base, p, mu);
+        }
+    }
+
+    // hi[m][d] = g^(-d * 2^(s - m * w))
+    for (int m = 2; m < l; m ++) {
+        base = g_inv;
+        for (int k = 0; k < s - m * w; k ++) {
+            base = mont_sqr_9x30(&base, p, mu);
+        }
+        ctx->hi[m][0] = *one;
+        for (int d = 1; d < (1 << w); d ++) {
+            ctx->hi[m][d] = mont_mul_9x30(&ctx->hi[m][d - 1], &base, p, mu);
+        }
+    }
+    return 0;
+}
+
+/// Computes a square root of ar mod p in Montgomery form, and stores it in
+/// res. Returns false, and leaves res unchanged, if ar is not a square. Which
+/// of the two roots is returned is not specified. Runs in variable time.
+///
+/// With u = a^((t + 1) / 2) and v = a^t, u^2 = a * v, and v = g^(2f) for some
+/// f of s - 1 bits if a is a square. The digits of f are found from the
+/// bottom up: each one is the logarithm, looked up in ctx->roots, of a power
+/// of v with the contribution of the lower digits removed using ctx->hi. The
+/// root is then u * g^-f, which is assembled from ctx->lo.
+bool mont_sqrt_9x30(
+    BigInt270 *res,
+    BigInt270 *ar,
+    SqrtCtx9x30 *ctx
+) {
+    BigInt270 p = ctx->p;
+    uint64_t mu = ctx->mu;
+
+    if (limbs_zero_mask(ar->v, 9)) {
+        *res = *ar;
+        return true;
+    }
+
+    // x = a^((t - 1) / 2), u = a^((t + 1) / 2) and v = a^t
+    BigInt270 x;
+    if (ctx->chain != NULL) {
+        x = mont_pow_chain_9x30(ar, ctx->chain, &p, mu);
+    } else {
+        x = mont_pow_9x30(ar, &ctx->t_minus_1_over_2, &p, mu, &ctx->one);
+    }
+    BigInt270 u = mont_mul_9x30(ar, &x, &p, mu);
+    BigInt270 v = mont_mul_9x30(&u, &x, &p, mu);
+
+    int w = ctx->window;
+    int l = ctx->num_digits;
+    int top = ctx->top_width;
+
+    if (l == 0) {
+        // s = 1, so a is a square if and only if v = 1.
+        if (memcmp(&v, &ctx->one, sizeof(BigInt270)) != 0) {
+            return false;
+        }
+        *res = u;
+        return true;
+    }
+
+    // v_pow[j] = v^(2^(s - 1 - (j + 1) * w)), for j < l - 1
+    BigInt270 v_pow[SQRT_MAX_DIGITS];
+    if (l > 1) {
+        BigInt270 y = v;
+        for (int k = 0; k < top; k ++) {
+            y = mont_sqr_9x30(&y, &p, mu);
+        }
+        v_pow[l - 2] = y;
+        for (int j = l - 3; j >= 0; j --) {
+            for (int k = 0; k < w; k ++) {
+                y = mont_sqr_9x30(&y, &p, mu);
+            }
+            v_pow[j] = y;
+        }
+    }
+
+    // Every digit but the top one
+    int digits[SQRT_MAX_DIGITS];
+    for (int j = 0; j < l - 1; j ++) {
+        BigInt270 y = v_pow[j];
+        for (int i = 0; i < j; i ++) {
+            y = mont_mul_9x30(&y, &ctx->hi[j + 1 - i][digits[i]], &p, mu);
+        }
+        int k = sqrt_dlog_lookup(ctx, &y);
+        if (k < 0) {
+            return false;
+        }
+        digits[j] = k;
+    }
+
+    // c = g^-f_low, so v * c^2 = g^(2 * f_top * 2^((l - 1) * w)) is a power of
+    // zeta^(2^(w - top)).
+    BigInt270 c = ctx->one;
+    for (int i = 0; i < l - 1; i ++) {
+        c = mont_mul_9x30(&c, &ctx->lo[i][digits[i]], &p, mu);
+    }
+    BigInt270 y = mont_sqr_9x30(&c, &p, mu);
+    y = mont_mul_9x30(&y, &v, &p, mu);
+    int k = sqrt_dlog_lookup(ctx, &y);
+    if (k < 0 || (k & ((1 << (w - top)) - 1)) != 0) {
+        return false;
+    }
+    int d_top = k >> (w - top);
+
+    BigInt270 r = mont_mul_9x30(&u, &c, &p, mu);
+    *res = mont_mul_9x30(&r, &ctx->lo[l - 1][d_top], &p, mu);
+    return true;
+}
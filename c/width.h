@@ -0,0 +1,333 @@
+#pragma once
+
+#include "./mont.h"
+#include <stdint.h>
+
+// Montgomery multiplication and squaring for every limb width from 26 to 32
+// bits.
+//
+// mont_mul_9x29 and mont_mul_9x30 each hard-code a limb width, and with it
+// how often the accumulator has to be carried: with w-bit limbs, a uint64_t
+// can absorb about 2^(63 - 2w) limb products before it overflows, so narrower
+// limbs need fewer carries but more limbs. The kernels here take the width as
+// a parameter, and derive the number of limbs and the carry schedule from it:
+// - For w <= 31, each row adds its products to the accumulator without
+//   carrying, as in mont_mul_9x30, and the accumulator is normalised after
+//   every mont_width_rows(w, 2) rows. Below 30 bits that is never needed
+//   before the end, at 30 bits it is needed once, and at 31 bits after every
+//   second row.
+// - At w = 32, a * b[j] + q * p[j] can overflow 64 bits, so the two products
+//   are carried separately, as in mont_mul_cios.
+//
+// MONT_WIDTH_KERNELS stamps out mont_mul_<n>x<w>_limbs and
+// mont_sqr_<n>x<w>_limbs for a width, with n and w as constants, so that the
+// compiler can unroll each one. mont_width_kernels lists them all, and
+// benchmarks/bench_width.c times each one, so the width can be picked from
+// data for a given modulus and engine.
+//
+// Done:
+// - Montgomery multiplication and squaring with 26- to 32-bit limbs
+
+#define MONT_WIDTH_MIN 26
+#define MONT_WIDTH_MAX 32
+#define MONT_WIDTH_MAX_LIMBS 10
+
+/// A modulus in limbs of w bits, with the constants that the kernels here
+/// need.
+typedef struct {
+    int n;
+    int w;
+    uint64_t p[MONT_WIDTH_MAX_LIMBS];
+    /// R^2 mod p, with R = 2^(n * w), for conversion into Montgomery form
+    uint64_t r2[MONT_WIDTH_MAX_LIMBS];
+    /// -p^-1 mod 2^w
+    uint64_t mu;
+} MontWidthParams;
+
+/// Returns the number of limbs of w bits used for moduli below 2^254. This is
+/// the smallest n with n * w >= 256, so 4p < R and the inputs to the kernels
+/// can be in [0, 2p).
+static inline int mont_width_num_limbs(int w) {
+    return (256 + w - 1) / w;
+}
+
+/// Stores the low n * w bits of a in n limbs of w bits.
+static inline void mont_width_from_bigint256(uint64_t *res, const BigInt256 *a, int n, int w) {
+    for (int i = 0; i < n; i ++) {
+        res[i] = 0;
+    }
+    for (int bit = 0; bit < 256 && bit < n * w; bit ++) {
+        uint64_t b = (a->v[bit / 32] >> (bit % 32)) & 1;
+        res[bit / w] |= b << (bit % w);
+    }
+}
+
+/// Stores the low 256 bits of the value in the n limbs of w bits of a.
+static inline void mont_width_to_bigint256(BigInt256 *res, const uint64_t *a, int n, int w) {
+    *res = bigint_new();
+    for (int bit = 0; bit < 256 && bit < n * w; bit ++) {
+        uint64_t b = (a[bit / w] >> (bit % w)) & 1;
+        res->v[bit / 32] |= b << (bit % 32);
+    }
+}
+
+/// Computes the constants in mp for the modulus p and limb width w. Returns
+/// 0 on success, and -1 if w is out of range or bigint_is_valid_modulus
+/// rejects p.
+int mont_width_params_init(MontWidthParams *mp, const BigInt256 *p, int w) {
+    if (w < MONT_WIDTH_MIN || w > MONT_WIDTH_MAX || !bigint_is_valid_modulus(p)) {
+        return -1;
+    }
+
+    int n = mont_width_num_limbs(w);
+    mp->n = n;
+    mp->w = w;
+    mont_width_from_bigint256(mp->p, p, n, w);
+
+    mp->mu = (0 - inv_mod_2_64(p->v[0])) & ((1ULL << w) - 1);
+
+    // R^2 mod p = 2^(2 * n * w) mod p
+    BigInt256 r2 = bigint_pow2_mod(2 * n * w, p);
+    mont_width_from_bigint256(mp->r2, &r2, n, w);
+    return 0;
+}
+
+/// Returns the number of rows that the kernels can add to the accumulator
+/// between normalisations, if each row adds at most terms products of two
+/// w-bit limbs to each limb. A normalised limb is below 2^w, and the carry
+/// out of the lowest column is below 2^(64 - w), and both must still fit.
+/// Returns 0 if a single row could overflow 64 bits.
+static inline uint64_t mont_width_rows(int w, uint64_t terms) {
+    uint64_t m = (1ULL << w) - 1;
+    uint64_t sq = m * m;
+    if (sq > UINT64_MAX / terms) {
+        return 0;
+    }
+    uint64_t slack = (1ULL << w) + (1ULL << (64 - w));
+    return (UINT64_MAX - slack) / (terms * sq);
+}
+
+/// Carries each of the lowest n - 1 limbs of s into the next, leaving them
+/// below 2^w. The top limb is left as it is, plus the carry.
+static inline void mont_width_normalise(uint64_t *s, int n, int w) {
+    const uint64_t mask = (1ULL << w) - 1;
+    uint64_t c = 0;
+    for (int k = 0; k < n - 1; k ++) {
+        c += s[k];
+        s[k] = c & mask;
+        c >>= w;
+    }
+    s[n - 1] += c;
+}
+
+/// Stores s - p in res if s >= p, and s otherwise, without a branch.
+static inline void mont_width_reduce(uint64_t *res, const uint64_t *s, const uint64_t *p, int n, int w) {
+    uint64_t d[MONT_WIDTH_MAX_LIMBS];
+    uint64_t borrow = limbs_sub(d, s, p, n, w);
+    limbs_select(res, d, s, 0 - borrow, n);
+}
+
+/// Computes a * b * R^-1 mod p into s without the final conditional
+/// subtraction, with n limbs of w bits.
+static inline void mont_width_mul_unreduced(
+    uint64_t *s,
+    const uint64_t *a,
+    const uint64_t *b,
+    const uint64_t *p,
+    uint64_t mu,
+    int n,
+    int w
+) {
+    const uint64_t mask = (1ULL << w) - 1;
+    const uint64_t rows = mont_width_rows(w, 2);
+    uint64_t t, qi, c, c2;
+    for (int i = 0; i < n; i ++) {
+        s[i] = 0;
+    }
+
+    if (rows == 0) {
+        // 32-bit limbs: carry a * b[j] and q * p[j] separately
+        for (int i = 0; i < n; i ++) {
+            c = s[0] + a[i] * b[0];
+            t = c & mask;
+            c >>= w;
+            qi = (mu * t) & mask;
+            c2 = (t + qi * p[0]) >> w;
+            for (int j = 1; j < n; j ++) {
+                c = s[j] + a[i] * b[j] + c;
+                t = c & mask;
+                c >>= w;
+                c2 = t + qi * p[j] + c2;
+                s[j - 1] = c2 & mask;
+                c2 >>= w;
+            }
+            s[n - 1] = c + c2;
+        }
+        return;
+    }
+
+    uint64_t since = 0;
+    for (int i = 0; i < n; i ++) {
+        t = s[0] + a[i] * b[0];
+        qi = (mu * (t & mask)) & mask;
+        c = (t + qi * p[0]) >> w;
+        for (int j = 1; j < n; j ++) {
+            s[j - 1] = s[j] + a[i] * b[j] + qi * p[j];
+        }
+        s[0] += c;
+        s[n - 1] = 0;
+
+        since ++;
+        if (since == rows) {
+            mont_width_normalise(s, n, w);
+            since = 0;
+        }
+    }
+    mont_width_normalise(s, n, w);
+}
+
+/// Computes a * a * R^-1 mod p into s without the final conditional
+/// subtraction. Row i adds a[i] * a[j] only for j >= i, with the cross terms
+/// doubled, as in mont_sqr_9x30, so each row can add up to three products to
+/// a limb, and the accumulator is normalised more often than in
+/// mont_width_mul_unreduced. At 32 bits, where the doubled products do not
+/// fit, this is a multiplication.
+static inline void mont_width_sqr_unreduced(
+    uint64_t *s,
+    const uint64_t *a,
+    const uint64_t *p,
+    uint64_t mu,
+    int n,
+    int w
+) {
+    const uint64_t mask = (1ULL << w) - 1;
+    const uint64_t rows = mont_width_rows(w, 3);
+    uint64_t t, qi, c, ai, ai2;
+
+    if (rows == 0) {
+        mont_width_mul_unreduced(s, a, a, p, mu, n, w);
+        return;
+    }
+
+    for (int i = 0; i < n; i ++) {
+        s[i] = 0;
+    }
+
+    uint64_t since = 0;
+    for (int i = 0; i < n; i ++) {
+        ai = a[i];
+        ai2 = 2 * ai;
+
+        // Only row 0 has a product term in the lowest column
+        t = s[0];
+        if (i == 0) {
+            t += ai * ai;
+        }
+        qi = (mu * (t & mask)) & mask;
+        c = (t + qi * p[0]) >> w;
+
+        s[0] = s[1] + qi * p[1] + c;
+        for (int j = 2; j < n; j ++) {
+            s[j - 1] = s[j] + qi * p[j];
+        }
+        s[n - 1] = 0;
+
+        // Add a[i]^2 and 2 * a[i] * a[j] for j > i, shifted down by one limb
+        // like the rest of the row.
+        if (i > 0) {
+            s[i - 1] += ai * ai;
+        }
+        for (int j = i + 1; j < n; j ++) {
+            s[j - 1] += ai2 * a[j];
+        }
+
+        since ++;
+        if (since == rows) {
+            mont_width_normalise(s, n, w);
+            since = 0;
+        }
+    }
+    mont_width_normalise(s, n, w);
+}
+
+/// Montgomery multiplication with n limbs of w bits, for a and b in [0, p).
+/// The output is in [0, p).
+static inline void mont_width_mul(
+    uint64_t *res,
+    const uint64_t *a,
+    const uint64_t *b,
+    const uint64_t *p,
+    uint64_t mu,
+    int n,
+    int w
+) {
+    uint64_t s[MONT_WIDTH_MAX_LIMBS];
+    mont_width_mul_unreduced(s, a, b, p, mu, n, w);
+    mont_width_reduce(res, s, p, n, w);
+}
+
+/// Montgomery squaring with n limbs of w bits, for a in [0, p). The output is
+/// in [0, p).
+static inline void mont_width_sqr(
+    uint64_t *res,
+    const uint64_t *a,
+    const uint64_t *p,
+    uint64_t mu,
+    int n,
+    int w
+) {
+    uint64_t s[MONT_WIDTH_MAX_LIMBS];
+    mont_width_sqr_unreduced(s, a, p, mu, n, w);
+    mont_width_reduce(res, s, p, n, w);
+}
+
+typedef void (*MontWidthMulFn)(uint64_t *, const uint64_t *, const uint64_t *, const uint64_t *, uint64_t);
+typedef void (*MontWidthSqrFn)(uint64_t *, const uint64_t *, const uint64_t *, uint64_t);
+
+/// Defines mont_mul_<N>x<W>_limbs and mont_sqr_<N>x<W>_limbs, which call
+/// mont_width_mul and mont_width_sqr with N and W as constants.
+#define MONT_WIDTH_KERNELS(N, W) \
+    void mont_mul_##N##x##W##_limbs( \
+        uint64_t *res, \
+        const uint64_t *a, \
+        const uint64_t *b, \
+        const uint64_t *p, \
+        uint64_t mu \
+    ) { \
+        mont_width_mul(res, a, b, p, mu, N, W); \
+    } \
+    void mont_sqr_##N##x##W##_limbs( \
+        uint64_t *res, \
+        const uint64_t *a, \
+        const uint64_t *p, \
+        uint64_t mu \
+    ) { \
+        mont_width_sqr(res, a, p, mu, N, W); \
+    }
+
+MONT_WIDTH_KERNELS(10, 26)
+MONT_WIDTH_KERNELS(10, 27)
+MONT_WIDTH_KERNELS(10, 28)
+MONT_WIDTH_KERNELS(9, 29)
+MONT_WIDTH_KERNELS(9, 30)
+MONT_WIDTH_KERNELS(9, 31)
+MONT_WIDTH_KERNELS(8, 32)
+
+/// The kernels above, one per width from MONT_WIDTH_MIN to MONT_WIDTH_MAX.
+typedef struct {
+    int n;
+    int w;
+    MontWidthMulFn mul;
+    MontWidthSqrFn sqr;
+} MontWidthKernel;
+
+const MontWidthKernel mont_width_kernels[] = {
+    {10, 26, mont_mul_10x26_limbs, mont_sqr_10x26_limbs},
+    {10, 27, mont_mul_10x27_limbs, mont_sqr_10x27_limbs},
+    {10, 28, mont_mul_10x28_limbs, mont_sqr_10x28_limbs},
+    {9, 29, mont_mul_9x29_limbs, mont_sqr_9x29_limbs},
+    {9, 30, mont_mul_9x30_limbs, mont_sqr_9x30_limbs},
+    {9, 31, mont_mul_9x31_limbs, mont_sqr_9x31_limbs},
+    {8, 32, mont_mul_8x32_limbs, mont_sqr_8x32_limbs},
+};
+const size_t NUM_MONT_WIDTH_KERNELS = 7;
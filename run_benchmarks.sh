@@ -14,3 +14,8 @@ run_benchmark "$benchmark_dir/bench_fma.js"
 run_benchmark "$benchmark_dir/bench_simd_mul.js"
 run_benchmark "$benchmark_dir/bench_mul.js"
 run_benchmark "$benchmark_dir/bench_mont_mul.js"
+run_benchmark "$benchmark_dir/bench_inv.js"
+run_benchmark "$benchmark_dir/bench_sqrt.js"
+run_benchmark "$benchmark_dir/bench_fixed.js"
+run_benchmark "$benchmark_dir/bench_mul_wide.js"
+run_benchmark "$benchmark_dir/bench_width.js"
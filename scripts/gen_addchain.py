@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""
+Generates addition chains for the fixed exponents used with a prime modulus p
+(p - 2 for inversion, (p - 1) / 2 for the Legendre symbol, and (t - 1) / 2 for
+square roots, where p - 1 = 2^s * t with t odd), and writes them to stdout as a C header of AddChainStep arrays for the
+mont_pow_chain_* functions in c/pow.h.
+
+Usage: gen_addchain.py <name> <modulus in hex>
+
+Each chain is a sliding-window chain: a table of odd powers of the base,
+followed by runs of squarings and a multiplication by a table entry for each
+window. The window width is chosen per exponent to minimise the total number of
+operations, so long runs of zeroes (such as the low bits of p - 1) cost only
+squarings. Every chain is checked by evaluating it on exponents before it is
+written out.
+"""
+
+import sys
+
+ADDCHAIN_MUL = 0
+ADDCHAIN_SQR = 1
+
+# Must match ADDCHAIN_MAX_REGS in c/pow.h
+MAX_REGS = 66
+MAX_WINDOW = 6
+
+
+def sliding_window_chain(e, k):
+    """
+    Returns (steps, num_regs, result) for an addition chain that computes x^e,
+    using a sliding window of width k. Register 0 holds x.
+    """
+    assert e > 0
+
+    # Split e into windows, each given as (value, width, zeroes after it).
+    bits = bin(e)[2:]
+    windows = []
+    i = 0
+    while i < len(bits):
+        j = min(i + k, len(bits))
+        while bits[j - 1] == '0':
+            j -= 1
+        val = int(bits[i:j], 2)
+        width = j - i
+        i = j
+        zeroes = 0
+        while i < len(bits) and bits[i] == '0':
+            zeroes += 1
+            i += 1
+        windows.append((val, width, zeroes))
+
+    # odd[v] is the register that holds x^v. Only odd powers up to the largest
+    # window value are computed.
+    steps = []
+    odd = {1: 0}
+    num_regs = 1
+    top = max(w[0] for w in windows)
+    if top > 1:
+        x2 = num_regs
+        num_regs += 1
+        steps.append((ADDCHAIN_MUL, x2, 0, 0, 0))
+        for v in range(3, top + 1, 2):
+            odd[v] = num_regs
+            steps.append((ADDCHAIN_MUL, num_regs, odd[v - 2], x2, 0))
+            num_regs += 1
+
+    acc = num_regs
+    num_regs += 1
+
+    cur = odd[windows[0][0]]
+    pending = windows[0][2]
+    for val, width, zeroes in windows[1:]:
+        steps.append((ADDCHAIN_SQR, acc, cur, 0, pending + width))
+        steps.append((ADDCHAIN_MUL, acc, acc, odd[val], 0))
+        cur = acc
+        pending = zeroes
+
+    if pending > 0 or cur != acc:
+        steps.append((ADDCHAIN_SQR, acc, cur, 0, pending))
+
+    return steps, num_regs, acc
+
+
+def cost(steps):
+    """
+    Returns the number of squarings and multiplications in a chain.
+    """
+    sqrs = sum(s[4] for s in steps if s[0] == ADDCHAIN_SQR)
+    muls = sum(1 for s in steps if s[0] == ADDCHAIN_MUL)
+    return sqrs, muls
+
+
+def evaluate(steps, num_regs, result):
+    """
+    Returns the exponent that a chain computes.
+    """
+    r = [None] * num_regs
+    r[0] = 1
+    for op, dst, a, b, n in steps:
+        if op == ADDCHAIN_MUL:
+            r[dst] = r[a] + r[b]
+        else:
+            r[dst] = r[a] << n
+    return r[result]
+
+
+def best_chain(e):
+    best = None
+    for k in range(1, MAX_WINDOW + 1):
+        steps, num_regs, result = sliding_window_chain(e, k)
+        assert evaluate(steps, num_regs, result) == e
+        assert num_regs <= MAX_REGS
+        total = sum(cost(steps))
+        if best is None or total < best[0]:
+            best = (total, k, steps, num_regs, result)
+    return best[1:]
+
+
+def emit(name, label, description, e):
+    k, steps, num_regs, result = best_chain(e)
+    sqrs, muls = cost(steps)
+    ident = 'addchain_{}_{}'.format(name, label)
+    ops = {ADDCHAIN_MUL: 'ADDCHAIN_MUL', ADDCHAIN_SQR: 'ADDCHAIN_SQR'}
+
+    out = []
+    out.append('// x^({}) = x^0x{:x}'.format(description, e))
+    out.append('// {}-bit sliding window: {} squarings and {} multiplications.'.format(k, sqrs, muls))
+    out.append('static const AddChainStep {}_steps[] = {{'.format(ident))
+    for op, dst, a, b, n in steps:
+        out.append('    {{ {}, {}, {}, {}, {} }},'.format(ops[op], dst, a, b, n))
+    out.append('};')
+    out.append('static const AddChain {} = {{ {}_steps, {}, {}, {} }};'.format(
+        ident, ident, len(steps), num_regs, result))
+    return '\n'.join(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write('Usage: {} <name> <modulus in hex>\n'.format(sys.argv[0]))
+        sys.exit(1)
+
+    name = sys.argv[1]
+    p = int(sys.argv[2], 16)
+    assert p % 2 == 1 and p.bit_length() <= 256
+
+    # p - 1 = 2^s * t, with t odd
+    s = 0
+    while ((p - 1) >> s) & 1 == 0:
+        s += 1
+    t = (p - 1) >> s
+
+    exponents = [
+        ('p_minus_2', 'p - 2', p - 2),
+        ('p_minus_1_over_2', '(p - 1) / 2', (p - 1) // 2),
+        ('t_minus_1_over_2', '(t - 1) / 2, where p - 1 = 2^{} * t'.format(s), (t - 1) // 2),
+    ]
+
+    print('// Generated by scripts/gen_addchain.py. Do not edit.')
+    print('// Modulus: 0x{:x}'.format(p))
+    print()
+    print('#include "../pow.h"')
+    for label, description, e in exponents:
+        print()
+        print(emit(name, label, description, e))
+
+
+if __name__ == '__main__':
+    main()
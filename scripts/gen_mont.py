@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+Generates a Montgomery multiplication kernel that is specialised to a single
+prime modulus p and limb width w, and writes it to stdout as a C header.
+
+Usage: gen_mont.py <name> <modulus in hex> <limb width>
+
+The kernel follows mont_mul_9x30 in c/mont.h (Mitscha-Baude's reduced-carry
+variant of CIOS), but:
+- every loop is fully unrolled, and the accumulator is held in local variables;
+- every limb of p, and mu = -p^-1 mod 2^w, is an immediate. Products with limbs
+  of p that are 0 are dropped, and products with limbs that are 1 become
+  additions. If mu = 2^w - 1, q is computed with a negation;
+- carries are only propagated where a limb of the accumulator could otherwise
+  overflow 64 bits. mont_mul_9x30 does this with a fixed nsafe, the number of
+  pairs of products that fit in 64 bits; here the points are chosen from
+  bounds that use the actual limbs of p, so there are often fewer of them.
+
+The number of limbs n is the smallest for which 2p < R = 2^(n * w). Inputs must
+be in [0, p), and the output is in [0, p).
+
+The header always defines
+    void mont_mul_<n>x<w>_<name>_limbs(uint64_t *res, const uint64_t *a, const uint64_t *b)
+on arrays of n limbs. If there is a BigInt type for the layout (9 x 29 bits
+is BigInt261, and 9 x 30 bits is BigInt270), it also defines a wrapper with the
+same arguments as the generic kernel, minus p and mu, e.g.
+    BigInt270 mont_mul_9x30_<name>(BigInt270 *ar, BigInt270 *br)
+
+Before the header is written, the straight-line code is run on random and
+extreme inputs, to check both the result and that no intermediate value
+overflows 64 bits.
+"""
+
+import random
+import sys
+
+# Limb layouts that have a BigInt type in c/bigint.h
+TYPES = {
+    (9, 29): 'BigInt261',
+    (9, 30): 'BigInt270',
+}
+
+NUM_CHECKS = 2000
+
+
+def build(p, w):
+    """
+    Returns (n, mu, num_carries, statements) for the unrolled kernel. Each
+    statement is a (variable, expression) pair, where the expression is valid
+    in both C and Python. The statements leave the unreduced result in s0, ...,
+    s{n-1}, with each limb normalised to w bits.
+
+    An upper bound is kept for every limb of the accumulator, using the actual
+    limbs of p, and the fact that the top limbs of the inputs are at most the
+    top limb of p. A limb is only split into its low w bits and a carry when
+    leaving it unnormalised could overflow 64 bits in the next row.
+    """
+    n = -(-(p.bit_length() + 1) // w)
+    mask = (1 << w) - 1
+    limit = 1 << 64
+    max_carry = limit >> w
+    mu = (-pow(p, -1, 1 << w)) % (1 << w)
+    pl = [(p >> (w * j)) & mask for j in range(n)]
+    # Upper bounds for the limbs of the inputs, which are less than p
+    amax = [mask] * (n - 1) + [pl[n - 1]]
+
+    def times_p(j):
+        if pl[j] == 0:
+            return None
+        if pl[j] == 1:
+            return 'q'
+        return 'q * 0x{:x}'.format(pl[j])
+
+    def growth(j):
+        # The most that a row can add to limb j of the accumulator
+        return max(amax) * amax[j] + mask * pl[j] + max_carry
+
+    st = []
+    num_carries = 0
+    # Upper bounds for s0, ..., s{n-1}. A bound of 0 means the limb is zero,
+    # so it is left out of the expressions.
+    sb = [0] * n
+
+    for i in range(n):
+        terms = [] if sb[0] == 0 else ['s0']
+        terms.append('a[{}] * b[0]'.format(i))
+        st.append(('t', ' + '.join(terms)))
+        tb = sb[0] + amax[i] * amax[0] + mask * pl[0]
+        assert tb < limit
+        if mu == mask:
+            st.append(('q', '(0 - t) & 0x{:x}'.format(mask)))
+        else:
+            st.append(('q', '(t * 0x{:x}) & 0x{:x}'.format(mu, mask)))
+        qp = times_p(0)
+        st.append(('c', '(t + {}) >> {}'.format(qp, w) if qp else 't >> {}'.format(w)))
+        cb = tb >> w
+        carry = True
+
+        new_sb = [0] * n
+        for j in range(1, n):
+            terms = [] if sb[j] == 0 else ['s{}'.format(j)]
+            terms.append('a[{}] * b[{}]'.format(i, j))
+            qp = times_p(j)
+            if qp:
+                terms.append(qp)
+            tb = sb[j] + amax[i] * amax[j] + mask * pl[j]
+            if carry:
+                terms.append('c')
+                tb += cb
+            assert tb < limit
+            carry = False
+
+            dst = 's{}'.format(j - 1)
+            if tb + growth(j - 1) >= limit:
+                num_carries += 1
+                st.append(('t', ' + '.join(terms)))
+                st.append((dst, 't & 0x{:x}'.format(mask)))
+                st.append(('c', 't >> {}'.format(w)))
+                new_sb[j - 1] = mask
+                cb = tb >> w
+                carry = True
+            else:
+                st.append((dst, ' + '.join(terms)))
+                new_sb[j - 1] = tb
+
+        if carry:
+            # The carry out of the top limb becomes the new top limb.
+            st.append(('s{}'.format(n - 1), 'c'))
+            new_sb[n - 1] = cb
+        sb = new_sb
+
+    # Normalise every limb to w bits.
+    st.append(('c', 's0 >> {}'.format(w)))
+    st.append(('s0', 's0 & 0x{:x}'.format(mask)))
+    for k in range(1, n):
+        src = 'c' if sb[k] == 0 else 's{} + c'.format(k)
+        st.append(('t', src))
+        st.append(('s{}'.format(k), 't & 0x{:x}'.format(mask)))
+        if k < n - 1:
+            st.append(('c', 't >> {}'.format(w)))
+    return n, mu, num_carries, st
+
+
+def run(st, n, w, x, y):
+    """
+    Runs the statements on x and y, and returns the unreduced result. Asserts
+    that every value fits in 64 bits.
+    """
+    mask = (1 << w) - 1
+    env = {
+        'a': [(x >> (w * i)) & mask for i in range(n)],
+        'b': [(y >> (w * i)) & mask for i in range(n)],
+    }
+    for k in range(n):
+        env['s{}'.format(k)] = 0
+    for var, expr in st:
+        val = eval(expr, {}, env)
+        assert 0 <= val < (1 << 64), 'overflow in {} = {}'.format(var, expr)
+        env[var] = val
+    return sum(env['s{}'.format(k)] << (w * k) for k in range(n))
+
+
+def check(p, w, n, st):
+    r_inv = pow(1 << (n * w), -1, p)
+    rng = random.Random(p ^ w)
+    inputs = [(p - 1, p - 1), (0, 0), (1, p - 1), (p - 1, 1)]
+    inputs += [(rng.randrange(p), rng.randrange(p)) for _ in range(NUM_CHECKS)]
+    for x, y in inputs:
+        res = run(st, n, w, x, y)
+        assert res < 2 * p
+        if res >= p:
+            res -= p
+        assert res == x * y * r_inv % p
+
+
+def emit(name, p, w):
+    n, mu, num_carries, st = build(p, w)
+    check(p, w, n, st)
+    mask = (1 << w) - 1
+    pl = [(p >> (w * j)) & mask for j in range(n)]
+    ident = 'mont_mul_{}x{}_{}'.format(n, w, name)
+
+    out = []
+    out.append('// Generated by scripts/gen_mont.py. Do not edit.')
+    out.append('// Modulus: 0x{:x}'.format(p))
+    out.append('// {} limbs of {} bits, R = 2^{}, mu = 0x{:x}'.format(n, w, n * w, mu))
+    out.append('// {} intermediate carries in {} rows'.format(num_carries, n))
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('#include "../mont.h"')
+    out.append('')
+    out.append('/// Computes a * b * R^-1 mod p, where p is the modulus above, for a and b')
+    out.append('/// in [0, p). Each of a, b and res holds {} limbs of {} bits.'.format(n, w))
+    out.append('static inline void {}_limbs(uint64_t *res, const uint64_t *a, const uint64_t *b) {{'.format(ident))
+    out.append('    uint64_t t, q, c;')
+    out.append('    uint64_t {};'.format(', '.join('s{}'.format(k) for k in range(n))))
+    out.append('')
+    for var, expr in st:
+        out.append('    {} = {};'.format(var, expr))
+    out.append('')
+    out.append('    // Subtract p if the result is at least p.')
+    out.append('    uint64_t d[{}];'.format(n))
+    out.append('    uint64_t borrow = 0;')
+    for k in range(n):
+        out.append('    t = s{} - 0x{:x} - borrow;'.format(k, pl[k]))
+        out.append('    d[{}] = t & 0x{:x};'.format(k, mask))
+        out.append('    borrow = t >> 63;')
+    out.append('    uint64_t keep_s = 0 - borrow;')
+    for k in range(n):
+        out.append('    res[{k}] = (s{k} & keep_s) | (d[{k}] & ~keep_s);'.format(k=k))
+    out.append('}')
+
+    if (n, w) in TYPES:
+        ty = TYPES[(n, w)]
+        out.append('')
+        out.append('/// Like mont_mul_{}x{}, but specialised to the modulus above.'.format(n, w))
+        out.append('{} {}({} *ar, {} *br) {{'.format(ty, ident, ty, ty))
+        out.append('    {} res;'.format(ty))
+        out.append('    {}_limbs(res.v, ar->v, br->v);'.format(ident))
+        out.append('    return res;')
+        out.append('}')
+    return '\n'.join(out)
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.stderr.write('Usage: {} <name> <modulus in hex> <limb width>\n'.format(sys.argv[0]))
+        sys.exit(1)
+
+    name = sys.argv[1]
+    p = int(sys.argv[2], 16)
+    w = int(sys.argv[3])
+    assert p % 2 == 1 and p > 2
+    assert 16 <= w <= 31, 'the limb width must be between 16 and 31 bits'
+    print(emit(name, p, w))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,97 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/ctx.h"
+#include "../c/barrett.h"
+
+const size_t NUM_TESTS = 1024;
+
+char** get_mont_test_data();
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+
+// The largest prime below 2^254, for which 4p only just fits in 256 bits
+char* p254_hex = "3fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff0b";
+
+MU_TEST(test_barrett_ctx_init) {
+    BarrettCtx ctx;
+    mu_check(barrett_ctx_init_hex(&ctx, p_hex) == 0);
+
+    // floor(2^512 / p) and floor(2^540 / p)
+    uint64_t mu_32[9] = {
+        0x479e7a85, 0x48130845, 0x5a78963d, 0x428602e3, 0xaa01523f,
+        0x3947927e, 0x02cb27b9, 0xb65247b1, 0xd
+    };
+    uint64_t mu_30[10] = {
+        0x10f6b1fe, 0x11e79ea1, 0x08130845, 0x29e258f5, 0x28602e35,
+        0x00548fd0, 0x07927eaa, 0x2c9ee4e5, 0x247b102c, 0x36d94
+    };
+    for (int i = 0; i < 9; i ++) {
+        mu_check(ctx.w32.mu[i] == mu_32[i]);
+    }
+    for (int i = 0; i < 10; i ++) {
+        mu_check(ctx.w30.mu[i] == mu_30[i]);
+    }
+
+    char* even_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000000";
+    char* large_hex = "42ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    mu_check(barrett_ctx_init_hex(&ctx, even_hex) == -1);
+    mu_check(barrett_ctx_init_hex(&ctx, large_hex) == -1);
+    mu_check(barrett_ctx_init_hex(&ctx, p254_hex) == 0);
+}
+
+/// Checks barrett_mul_8x32 and barrett_mul_9x30 against a Montgomery
+/// multiplication followed by one by R^2, which gives a * b mod p for
+/// canonical a and b.
+void do_barrett_mul_test(char* modulus_hex) {
+    char** hex_strs = get_mont_test_data();
+    MontCtx mont;
+    BarrettCtx ctx;
+    mu_check(mont_ctx_init_hex(&mont, modulus_hex) == 0);
+    mu_check(barrett_ctx_init_hex(&ctx, modulus_hex) == 0);
+    MontParamsCios *cios = &mont.cios;
+
+    BigInt256 a, b, expected, res;
+    BigInt270 a_270, b_270, res_270, expected_270;
+    for (int i = 0; i < NUM_TESTS + 1; i++) {
+        if (i < NUM_TESTS) {
+            mu_check(hex_to_bigint256(hex_strs[i * 3], &a) == 0);
+            mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &b) == 0);
+            bigint_reduce(&a, &a, &cios->p);
+            bigint_reduce(&b, &b, &cios->p);
+        } else {
+            // (p - 1) * (p - 1)
+            BigInt256 one = bigint_new();
+            one.v[0] = 1;
+            bigint_sub(&a, &cios->p, &one);
+            b = a;
+        }
+
+        expected = mont_mul_cios(&a, &b, &cios->p, cios->p_for_redc, cios->n0);
+        expected = mont_mul_cios(&expected, &cios->r2, &cios->p, cios->p_for_redc, cios->n0);
+
+        res = barrett_mul_8x32(&a, &b, &ctx.w32);
+        mu_check(bigint_eq(&res, &expected));
+
+        bigint256_to_bigint270(&a_270, &a);
+        bigint256_to_bigint270(&b_270, &b);
+        bigint256_to_bigint270(&expected_270, &expected);
+        res_270 = barrett_mul_9x30(&a_270, &b_270, &ctx.w30);
+        mu_check(memcmp(&res_270, &expected_270, sizeof(BigInt270)) == 0);
+    }
+}
+
+MU_TEST(test_barrett_mul) {
+    do_barrett_mul_test(p_hex);
+    do_barrett_mul_test(p254_hex);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_barrett_ctx_init);
+    MU_RUN_TEST(test_barrett_mul);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
@@ -1,5 +1,6 @@
 #include "minunit.h"
 #include "../c/bigint.h"
+#include "../c/bigintf.h"
 
 // Inline WASM using __asm__ in C code
 int add(int a, int b) {
@@ -223,6 +224,338 @@ MU_TEST(test_bigint_sub_3) {
     mu_check(do_test_bigint_sub(lhs_hex, rhs_hex, expected) == 0);
 }
 
+// Each row holds a, b, a + b, a - b, -a, 2a and a / 2, all modulo mod_test_p_hex
+const char *mod_test_p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+const char *mod_test_2p_hex = "2556cabd34594aacc1689a3cb86f6002b354edfda00000021423000000000002";
+const char *mod_test_vectors[][7] = {
+    {
+        "02e219ea27ac435a7a97c643656412a9b8a1abcd1a6916c74da4f9fc3c6da5d7",
+        "00d20a4ded6f0b09f165c8ce36e2f24b43000de01b2ed40ed3addccb2c33be0a",
+        "03b42438151b4e646bfd8f119c4704f4fba1b9ad3597ead62152d6c768a163e1",
+        "02100f9c3a3d38508931fd752e81205e75a19decff3a42b879f71d311039e7cd",
+        "0fc94b74728061fbe61c86daf6d39d57a108cb31b596e939bc6c8603c3925a2a",
+        "05c433d44f5886b4f52f8c86cac825537143579a34d22d8e9b49f3f878db4bae",
+        "0ac6bfa460ec74586da609b0e0cde15589261165f5348b642bdb3cfe1e36d2ec"
+    },
+    {
+        "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000000",
+        "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a117fffffffffff",
+        "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a117ffffffffffe",
+        "0000000000000000000000000000000000000000000000000000000000000001",
+        "0000000000000000000000000000000000000000000000000000000000000001",
+        "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a117fffffffffff",
+        "0955b2af4d1652ab305a268f2e1bd800acd53b7f680000008508c00000000000"
+    },
+    {
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "0000000000000000000000000000000000000000000000000000000000000000"
+    },
+};
+const size_t NUM_MOD_TEST_VECTORS = 3;
+
+int check_bigint_hex(const BigInt256 *x, const char *expected) {
+    char *hex = bigint_to_hex(x);
+    int result = strcmp(hex, expected);
+    free(hex);
+    return result;
+}
+
+MU_TEST(test_bigint_mod_ops) {
+    BigInt256 p, p2, a, b, a_wide, b_wide, res;
+    hex_to_bigint256(mod_test_p_hex, &p);
+    hex_to_bigint256(mod_test_2p_hex, &p2);
+
+    for (int i = 0; i < NUM_MOD_TEST_VECTORS; i ++) {
+        const char **v = mod_test_vectors[i];
+        hex_to_bigint256(v[0], &a);
+        hex_to_bigint256(v[1], &b);
+
+        bigint_add_mod(&res, &a, &b, &p);
+        mu_check(check_bigint_hex(&res, v[2]) == 0);
+        bigint_sub_mod(&res, &a, &b, &p);
+        mu_check(check_bigint_hex(&res, v[3]) == 0);
+        bigint_neg_mod(&res, &a, &p);
+        mu_check(check_bigint_hex(&res, v[4]) == 0);
+        bigint_double_mod(&res, &a, &p);
+        mu_check(check_bigint_hex(&res, v[5]) == 0);
+        bigint_halve_mod(&res, &a, &p);
+        mu_check(check_bigint_hex(&res, v[6]) == 0);
+
+        // Lazy variants on inputs in [p, 2p)
+        bigint_add_lazy(&a_wide, &a, &p);
+        bigint_add_lazy(&b_wide, &b, &p);
+        bigint_add_lazy(&res, &a_wide, &b_wide);
+        bigint_reduce(&res, &res, &p2);
+        bigint_reduce(&res, &res, &p);
+        mu_check(check_bigint_hex(&res, v[2]) == 0);
+        bigint_sub_lazy(&res, &a_wide, &b_wide, &p2);
+        bigint_reduce(&res, &res, &p2);
+        bigint_reduce(&res, &res, &p);
+        mu_check(check_bigint_hex(&res, v[3]) == 0);
+    }
+}
+
+MU_TEST(test_bigint261_mod_ops) {
+    BigInt261 p, p2, a, b, a_wide, b_wide, res;
+    hex_to_bigint261(mod_test_p_hex, &p);
+    hex_to_bigint261(mod_test_2p_hex, &p2);
+
+    for (int i = 0; i < NUM_MOD_TEST_VECTORS; i ++) {
+        const char **v = mod_test_vectors[i];
+        hex_to_bigint261(v[0], &a);
+        hex_to_bigint261(v[1], &b);
+
+        bigint261_add_mod(&res, &a, &b, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[2]) == 0);
+        bigint261_sub_mod(&res, &a, &b, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[3]) == 0);
+        bigint261_neg_mod(&res, &a, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[4]) == 0);
+        bigint261_double_mod(&res, &a, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[5]) == 0);
+        bigint261_halve_mod(&res, &a, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[6]) == 0);
+
+        bigint261_add_lazy(&a_wide, &a, &p);
+        bigint261_add_lazy(&b_wide, &b, &p);
+        bigint261_add_lazy(&res, &a_wide, &b_wide);
+        bigint261_reduce(&res, &res, &p2);
+        bigint261_reduce(&res, &res, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[2]) == 0);
+        bigint261_sub_lazy(&res, &a_wide, &b_wide, &p2);
+        bigint261_reduce(&res, &res, &p2);
+        bigint261_reduce(&res, &res, &p);
+        mu_check(strcmp(bigint261_to_hex(&res), v[3]) == 0);
+    }
+}
+
+MU_TEST(test_bigint270_mod_ops) {
+    BigInt270 p, p2, a, b, a_wide, b_wide, res;
+    hex_to_bigint270(mod_test_p_hex, &p);
+    hex_to_bigint270(mod_test_2p_hex, &p2);
+
+    for (int i = 0; i < NUM_MOD_TEST_VECTORS; i ++) {
+        const char **v = mod_test_vectors[i];
+        hex_to_bigint270(v[0], &a);
+        hex_to_bigint270(v[1], &b);
+
+        bigint270_add_mod(&res, &a, &b, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[2]) == 0);
+        bigint270_sub_mod(&res, &a, &b, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[3]) == 0);
+        bigint270_neg_mod(&res, &a, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[4]) == 0);
+        bigint270_double_mod(&res, &a, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[5]) == 0);
+        bigint270_halve_mod(&res, &a, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[6]) == 0);
+
+        bigint270_add_lazy(&a_wide, &a, &p);
+        bigint270_add_lazy(&b_wide, &b, &p);
+        bigint270_add_lazy(&res, &a_wide, &b_wide);
+        bigint270_reduce(&res, &res, &p2);
+        bigint270_reduce(&res, &res, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[2]) == 0);
+        bigint270_sub_lazy(&res, &a_wide, &b_wide, &p2);
+        bigint270_reduce(&res, &res, &p2);
+        bigint270_reduce(&res, &res, &p);
+        mu_check(strcmp(bigint270_to_hex(&res), v[3]) == 0);
+    }
+}
+
+MU_TEST(test_bigintf255_mod_ops) {
+    BigIntF255 p, p2, a, b, a_wide, b_wide, res;
+    char res_hex[65];
+    hex_to_bigintf255(mod_test_p_hex, &p);
+    hex_to_bigintf255(mod_test_2p_hex, &p2);
+
+    for (int i = 0; i < NUM_MOD_TEST_VECTORS; i ++) {
+        const char **v = mod_test_vectors[i];
+        hex_to_bigintf255(v[0], &a);
+        hex_to_bigintf255(v[1], &b);
+
+        bigintf255_add_mod(&res, &a, &b, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[2]) == 0);
+        bigintf255_sub_mod(&res, &a, &b, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[3]) == 0);
+        bigintf255_neg_mod(&res, &a, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[4]) == 0);
+        bigintf255_double_mod(&res, &a, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[5]) == 0);
+        bigintf255_halve_mod(&res, &a, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[6]) == 0);
+
+        bigintf255_add_lazy(&a_wide, &a, &p);
+        bigintf255_add_lazy(&b_wide, &b, &p);
+        bigintf255_add_lazy(&res, &a_wide, &b_wide);
+        bigintf255_reduce(&res, &res, &p2);
+        bigintf255_reduce(&res, &res, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[2]) == 0);
+        bigintf255_sub_lazy(&res, &a_wide, &b_wide, &p2);
+        bigintf255_reduce(&res, &res, &p2);
+        bigintf255_reduce(&res, &res, &p);
+        bigintf255_to_hex(&res, res_hex);
+        mu_check(strcmp(res_hex, v[3]) == 0);
+    }
+}
+
+// Small multipliers, including the largest that *_mul_small_mod accepts
+const uint64_t mul_small_ks[] = {0, 1, 2, 3, 4, 8, 11, 12345, 0xfffff};
+const size_t NUM_MUL_SMALL_KS = 9;
+
+// Checks *_mul_small_mod against k * a computed by doubling and adding.
+MU_TEST(test_mul_small_mod) {
+    BigInt256 p, a, expected, res;
+    BigInt261 p_261, a_261, expected_261, res_261;
+    BigInt270 p_270, a_270, expected_270, res_270;
+    BigIntF255 p_f, a_f, expected_f, res_f;
+    char expected_hex[65], res_hex[65];
+    hex_to_bigint256(mod_test_p_hex, &p);
+    hex_to_bigint261(mod_test_p_hex, &p_261);
+    hex_to_bigint270(mod_test_p_hex, &p_270);
+    hex_to_bigintf255(mod_test_p_hex, &p_f);
+
+    for (int i = 0; i < NUM_MOD_TEST_VECTORS; i ++) {
+        for (int j = 0; j < 2; j ++) {
+            const char *a_hex = mod_test_vectors[i][j];
+            hex_to_bigint256(a_hex, &a);
+            hex_to_bigint261(a_hex, &a_261);
+            hex_to_bigint270(a_hex, &a_270);
+            hex_to_bigintf255(a_hex, &a_f);
+
+            for (int m = 0; m < NUM_MUL_SMALL_KS; m ++) {
+                uint64_t k = mul_small_ks[m];
+                expected = bigint_new();
+                expected_261 = bigint261_new();
+                expected_270 = bigint270_new();
+                expected_f = bigintf_new();
+                for (int b = 19; b >= 0; b --) {
+                    bigint_double_mod(&expected, &expected, &p);
+                    bigint261_double_mod(&expected_261, &expected_261, &p_261);
+                    bigint270_double_mod(&expected_270, &expected_270, &p_270);
+                    bigintf255_double_mod(&expected_f, &expected_f, &p_f);
+                    if ((k >> b) & 1) {
+                        bigint_add_mod(&expected, &expected, &a, &p);
+                        bigint261_add_mod(&expected_261, &expected_261, &a_261, &p_261);
+                        bigint270_add_mod(&expected_270, &expected_270, &a_270, &p_270);
+                        bigintf255_add_mod(&expected_f, &expected_f, &a_f, &p_f);
+                    }
+                }
+
+                bigint_mul_small_mod(&res, &a, k, &p);
+                mu_check(bigint_eq(&res, &expected));
+                bigint261_mul_small_mod(&res_261, &a_261, k, &p_261);
+                mu_check(memcmp(&res_261, &expected_261, sizeof(BigInt261)) == 0);
+                bigint270_mul_small_mod(&res_270, &a_270, k, &p_270);
+                mu_check(memcmp(&res_270, &expected_270, sizeof(BigInt270)) == 0);
+                bigintf255_mul_small_mod(&res_f, &a_f, k, &p_f);
+                bigintf255_to_hex(&res_f, res_hex);
+                bigintf255_to_hex(&expected_f, expected_hex);
+                mu_check(strcmp(res_hex, expected_hex) == 0);
+            }
+        }
+    }
+}
+
+// Each row holds a, b and the 512-bit product a * b
+const char *mul_wide_test_vectors[][3] = {
+    {
+        "02e219ea27ac435a7a97c643656412a9b8a1abcd1a6916c74da4f9fc3c6da5d7",
+        "00d20a4ded6f0b09f165c8ce36e2f24b43000de01b2ed40ed3addccb2c33be0a",
+        "00025d96f7c60e70c0b40259d3e437b703eac8b60d34f5f4fdcb2e2934e4f847"
+        "4e7f67501ff73ed23911b813a4b1efe6b2ea0cea94f0f4bc0e602089bb330c66"
+    },
+    {
+        "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000000",
+        "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a117fffffffffff",
+        "015c8d01e2340781d717de29c19c3ec58ea773345678f4e61fdebb41483a709d"
+        "467327c816f9d56ae6d1347970debfffbadde8336ffffffef5ee800000000000"
+    },
+    {
+        "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+        "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+        "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+        "0000000000000000000000000000000000000000000000000000000000000001"
+    },
+};
+const size_t NUM_MUL_WIDE_TEST_VECTORS = 3;
+
+// Regroups n_in limbs of w_in bits into n_out limbs of w_out bits.
+void regroup_limbs(uint64_t *out, int n_out, int w_out, const uint64_t *in, int n_in, int w_in) {
+    for (int i = 0; i < n_out; i ++) {
+        out[i] = 0;
+    }
+    for (int bit = 0; bit < n_in * w_in && bit < n_out * w_out; bit ++) {
+        uint64_t b = (in[bit / w_in] >> (bit % w_in)) & 1;
+        out[bit / w_out] |= b << (bit % w_out);
+    }
+}
+
+MU_TEST(test_mul_wide) {
+    BigInt256 a, b, lo, hi;
+    BigInt270 a_270, b_270;
+    BigInt512 res;
+    BigInt540 res_270;
+    uint64_t expected_270[18];
+    char hi_hex[65] = {0};
+    for (int i = 0; i < NUM_MUL_WIDE_TEST_VECTORS; i ++) {
+        const char **v = mul_wide_test_vectors[i];
+        mu_check(hex_to_bigint256(v[0], &a) == 0);
+        mu_check(hex_to_bigint256(v[1], &b) == 0);
+        memcpy(hi_hex, v[2], 64);
+        mu_check(hex_to_bigint256(hi_hex, &hi) == 0);
+        mu_check(hex_to_bigint256(v[2] + 64, &lo) == 0);
+
+        bigint_mul_wide(&res, &a, &b);
+        mu_check(memcmp(res.v, lo.v, sizeof(lo.v)) == 0);
+        mu_check(memcmp(&res.v[8], hi.v, sizeof(hi.v)) == 0);
+
+        bigint256_to_bigint270(&a_270, &a);
+        bigint256_to_bigint270(&b_270, &b);
+        bigint270_mul_wide(&res_270, &a_270, &b_270);
+        regroup_limbs(expected_270, 18, 30, res.v, 16, 32);
+        mu_check(memcmp(res_270.v, expected_270, sizeof(expected_270)) == 0);
+    }
+}
+
+// Checks limbs_mul_karatsuba against limbs_mul_schoolbook for every limb count
+// from 4 to LIMBS_MUL_MAX, in each limb width, on pseudorandom limbs and on
+// limbs with every bit set, which give the largest carries.
+MU_TEST(test_mul_karatsuba) {
+    const int widths[] = {16, 20, 29, 30, 32};
+    uint64_t a[LIMBS_MUL_MAX], b[LIMBS_MUL_MAX];
+    uint64_t res_s[2 * LIMBS_MUL_MAX], res_k[2 * LIMBS_MUL_MAX];
+    uint64_t x = 1;
+    for (int wi = 0; wi < 5; wi ++) {
+        int w = widths[wi];
+        uint64_t mask = (1ULL << w) - 1;
+        for (int n = 4; n <= LIMBS_MUL_MAX; n ++) {
+            for (int t = 0; t < 17; t ++) {
+                for (int i = 0; i < n; i ++) {
+                    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                    a[i] = t == 16 ? mask : (x >> 24) & mask;
+                    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                    b[i] = t == 16 ? mask : (x >> 24) & mask;
+                }
+                limbs_mul_schoolbook(res_s, a, b, n, w);
+                limbs_mul_karatsuba(res_k, a, b, n, w);
+                mu_check(memcmp(res_s, res_k, 2 * n * sizeof(uint64_t)) == 0);
+            }
+        }
+    }
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(test_asm_add);
     MU_RUN_TEST(test_asm_sub);
@@ -234,6 +567,13 @@ MU_TEST_SUITE(test_suite) {
 	MU_RUN_TEST(test_bigint_to_hex);
 	MU_RUN_TEST(test_hex_to_bigint);
 	MU_RUN_TEST(test_bigint_rand);
+	MU_RUN_TEST(test_bigint_mod_ops);
+	MU_RUN_TEST(test_bigint261_mod_ops);
+	MU_RUN_TEST(test_bigint270_mod_ops);
+	MU_RUN_TEST(test_bigintf255_mod_ops);
+	MU_RUN_TEST(test_mul_small_mod);
+	MU_RUN_TEST(test_mul_wide);
+	MU_RUN_TEST(test_mul_karatsuba);
 }
 
 int main(int argc, char *argv[]) {
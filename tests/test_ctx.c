@@ -0,0 +1,247 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/ctx.h"
+
+const size_t NUM_TESTS = 256;
+
+char** get_mont_test_data();
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+
+MU_TEST(test_mont_ctx_init) {
+    MontCtx ctx;
+    mu_check(mont_ctx_init_hex(&ctx, p_hex) == 0);
+
+    // The constants that the tests and benchmarks hard-code for this modulus
+    mu_check(ctx.w29.mu == 536870911);
+    mu_check(ctx.w30.mu == 1073741823);
+    mu_check(ctx.cios.n0 == 4294967295);
+    mu_check(ctx.cios.mu_bm17 == 1);
+    mu_check(ctx.f64.n0 == 422212465065983);
+    mu_check(ctx.w29.p_is_1_mod_limb);
+    mu_check(ctx.w30.p_is_1_mod_limb);
+    mu_check(ctx.cios.p_is_1_mod_limb);
+    mu_check(ctx.cios.mul_nocarry);
+    mu_check(ctx.cios.sqr_nocarry);
+
+    char* hex;
+    hex = bigint261_to_hex(&ctx.w29.r);
+    mu_check(strcmp(hex, "0ec09024379d1e368b840e0e38b8ddb0965868081ffffe38c60efffffffffe4a") == 0);
+    hex = bigint270_to_hex(&ctx.w30.r);
+    mu_check(strcmp(hex, "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c") == 0);
+    hex = bigint270_to_hex(&ctx.w30.r3);
+    mu_check(strcmp(hex, "03fda000539b9f03b5b23d888ba00b45b60b180f86657ef4e685aeb681854b2b") == 0);
+    hex = bigint_to_hex(&ctx.cios.r);
+    mu_check(strcmp(hex, "0d4bda322bbb9a9d16d81575512c0fee7257f50f6ffffff27d1c7ffffffffff3") == 0);
+    free(hex);
+    hex = bigint_to_hex(&ctx.cios.r3);
+    mu_check(strcmp(hex, "0601dfa555c48ddab1e55ef6f1c9d713624d23ffae2716996a4295c90f65454c") == 0);
+    free(hex);
+
+    uint64_t p_for_redc_limbs[5] = {
+        0x1800000000001, 0x7DA0000002142, 0x0DEC00566A9DB, 0x2AB305A268F2E, 0x12AB655E9A2CA
+    };
+    for (int i = 0; i < 5; i ++) {
+        uint64_t limb;
+        memcpy(&limb, &(ctx.f64.p_for_redc.v[i]), sizeof(uint64_t));
+        mu_check(limb == p_for_redc_limbs[i]);
+    }
+
+    // 4p = 2p + 2p = 2p + p + p
+    BigInt256 x;
+    bigint_add(&x, &ctx.cios.p2, &ctx.cios.p2);
+    mu_check(bigint_eq(&x, &ctx.cios.p4));
+    BigInt270 y;
+    bigint270_add(&y, &ctx.w30.p2, &ctx.w30.p);
+    bigint270_add(&y, &y, &ctx.w30.p);
+    mu_check(memcmp(&y, &ctx.w30.p4, sizeof(BigInt270)) == 0);
+
+    // Invalid moduli
+    char* even_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000000";
+    char* large_hex = "42ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* one_hex = "0000000000000000000000000000000000000000000000000000000000000001";
+    mu_check(mont_ctx_init_hex(&ctx, even_hex) == -1);
+    mu_check(mont_ctx_init_hex(&ctx, large_hex) == -1);
+    mu_check(mont_ctx_init_hex(&ctx, one_hex) == -1);
+
+    // The largest prime below 2^254 only has one spare bit for squaring.
+    char* p254_hex = "3fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff0b";
+    mu_check(mont_ctx_init_hex(&ctx, p254_hex) == 0);
+    mu_check(ctx.cios.mul_nocarry);
+    mu_check(!ctx.cios.sqr_nocarry);
+    mu_check(mont_ctx_init_hex(&ctx, "12ab") == -1);
+}
+
+BigIntF255 f64_mont_mul(BigIntF255 *a, BigIntF255 *b, MontParamsF64 *f64) {
+    BigIntF255 res = mont_mul_cios_f64_simd(a, b, &f64->p, f64->n0);
+    res = reduce_bigintf(&res, &f64->p_for_redc);
+    return resolve_bigintf(&res);
+}
+
+/// Checks that every kernel computes the same a * b mod p with the constants
+/// from ctx, converting into Montgomery form with r2 and back out with 1.
+void do_mont_ctx_kernel_test(MontCtx *ctx) {
+    char** hex_strs = get_mont_test_data();
+    BigInt256 plain_one = bigint_new();
+    plain_one.v[0] = 1;
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        char* a_hex = hex_strs[i * 3];
+        char* b_hex = hex_strs[i * 3 + 1];
+        char* hex;
+
+        // 32-bit limbs
+        MontParamsCios *cios = &ctx->cios;
+        BigInt256 a, b, ab, expected;
+        mu_check(hex_to_bigint256(a_hex, &a) == 0);
+        mu_check(hex_to_bigint256(b_hex, &b) == 0);
+        a = mont_mul_cios(&a, &cios->r2, &cios->p, cios->p_for_redc, cios->n0);
+        b = mont_mul_cios(&b, &cios->r2, &cios->p, cios->p_for_redc, cios->n0);
+        ab = mont_mul_cios(&a, &b, &cios->p, cios->p_for_redc, cios->n0);
+        BigInt256 ab_bm17 = bm17_non_simd_mont_mul(&a, &b, &cios->p, cios->mu_bm17);
+        mu_check(bigint_eq(&ab, &ab_bm17));
+        BigInt256 ab_ctx = mont_ctx_mul_cios(ctx, &a, &b);
+        mu_check(bigint_eq(&ab, &ab_ctx));
+        BigInt256 aa = mont_sqr_cios(&a, &cios->p, cios->n0);
+        BigInt256 aa_ctx = mont_ctx_sqr_cios(ctx, &a);
+        mu_check(bigint_eq(&aa, &aa_ctx));
+        expected = mont_mul_cios(&ab, &plain_one, &cios->p, cios->p_for_redc, cios->n0);
+        mu_check(!bigint_gt(&expected, &cios->p));
+
+        // 30-bit limbs
+        MontParams9x30 *w30 = &ctx->w30;
+        BigInt270 a_270, b_270, ab_270, one_270 = bigint270_new();
+        one_270.v[0] = 1;
+        mu_check(hex_to_bigint270(a_hex, &a_270) == 0);
+        mu_check(hex_to_bigint270(b_hex, &b_270) == 0);
+        a_270 = mont_mul_9x30(&a_270, &w30->r2, &w30->p, w30->mu);
+        b_270 = mont_mul_9x30(&b_270, &w30->r2, &w30->p, w30->mu);
+        ab_270 = mont_mul_9x30(&a_270, &b_270, &w30->p, w30->mu);
+        BigInt270 ab_270_ctx = mont_ctx_mul_9x30(ctx, &a_270, &b_270);
+        mu_check(memcmp(&ab_270, &ab_270_ctx, sizeof(BigInt270)) == 0);
+        ab_270 = mont_mul_9x30(&ab_270, &one_270, &w30->p, w30->mu);
+        hex = bigint270_to_hex(&ab_270);
+        mu_check(hex_to_bigint256(hex, &ab) == 0);
+        mu_check(bigint_eq(&ab, &expected));
+
+        // 29-bit limbs
+        MontParams9x29 *w29 = &ctx->w29;
+        BigInt261 a_261, b_261, ab_261, one_261 = bigint261_new();
+        one_261.v[0] = 1;
+        mu_check(hex_to_bigint261(a_hex, &a_261) == 0);
+        mu_check(hex_to_bigint261(b_hex, &b_261) == 0);
+        a_261 = mont_mul_9x29(&a_261, &w29->r2, &w29->p, w29->mu);
+        b_261 = mont_mul_9x29(&b_261, &w29->r2, &w29->p, w29->mu);
+        ab_261 = mont_mul_9x29(&a_261, &b_261, &w29->p, w29->mu);
+        BigInt261 ab_261_ctx = mont_ctx_mul_9x29(ctx, &a_261, &b_261);
+        mu_check(memcmp(&ab_261, &ab_261_ctx, sizeof(BigInt261)) == 0);
+        ab_261 = mont_mul_9x29(&ab_261, &one_261, &w29->p, w29->mu);
+        hex = bigint261_to_hex(&ab_261);
+        mu_check(hex_to_bigint256(hex, &ab) == 0);
+        mu_check(bigint_eq(&ab, &expected));
+
+        // 51-bit limbs in doubles. reduce_bigintf only compares the top limbs,
+        // so the result may still need one subtraction of p.
+        MontParamsF64 *f64 = &ctx->f64;
+        BigIntF255 a_f, b_f, ab_f, one_f = bigintf_new();
+        one_f.v[0] = f64x2_make(1, 0);
+        mu_check(hex_to_bigintf255(a_hex, &a_f) == 0);
+        mu_check(hex_to_bigintf255(b_hex, &b_f) == 0);
+        a_f = f64_mont_mul(&a_f, &f64->r2, f64);
+        b_f = f64_mont_mul(&b_f, &f64->r2, f64);
+        ab_f = f64_mont_mul(&a_f, &b_f, f64);
+        ab_f = f64_mont_mul(&ab_f, &one_f, f64);
+        hex = malloc(65 * sizeof(char));
+        bigintf255_to_hex(&ab_f, hex);
+        mu_check(hex_to_bigint256(hex, &ab) == 0);
+        bigint_reduce(&ab, &ab, &cios->p);
+        mu_check(bigint_eq(&ab, &expected));
+        free(hex);
+    }
+}
+
+MU_TEST(test_mont_ctx_kernels) {
+    MontCtx ctx;
+    mu_check(mont_ctx_init_hex(&ctx, p_hex) == 0);
+    do_mont_ctx_kernel_test(&ctx);
+
+    // The BN254 scalar field, which is not 1 mod 2^32
+    char* bn254_hex = "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001";
+    mu_check(mont_ctx_init_hex(&ctx, bn254_hex) == 0);
+    mu_check(ctx.cios.mu_bm17 != 1);
+    mu_check(!ctx.w29.p_is_1_mod_limb);
+    mu_check(!ctx.w30.p_is_1_mod_limb);
+    mu_check(!ctx.cios.p_is_1_mod_limb);
+    do_mont_ctx_kernel_test(&ctx);
+}
+
+MU_TEST(test_mont_ctx_reduce_wide) {
+    MontCtx ctx;
+    mu_check(mont_ctx_init_hex(&ctx, p_hex) == 0);
+
+    // Each input and the big-endian integer that it encodes, mod p
+    uint8_t inputs[4][64];
+    for (int i = 0; i < 64; i ++) {
+        inputs[0][i] = i;
+        inputs[1][i] = 0xff;
+        inputs[2][i] = i < 32 ? 0 : 0xff;
+        inputs[3][i] = i == 31 ? 1 : 0;
+    }
+    char* expected_hex[4] = {
+        "08d15d320f244573bde32eca387de1e590ccefb25639247092837dc17cf321b2",
+        "011fdae7eff1c939a7cc008fe5dc8593cc2c27b58860591f25d577bab861857a",
+        "0d4bda322bbb9a9d16d81575512c0fee7257f50f6ffffff27d1c7ffffffffff2",
+        "0d4bda322bbb9a9d16d81575512c0fee7257f50f6ffffff27d1c7ffffffffff3"
+    };
+
+    for (int i = 0; i < 4; i ++) {
+        char* hex;
+
+        BigInt256 one = bigint_new();
+        one.v[0] = 1;
+        BigInt256 x = mont_ctx_reduce_wide_cios(&ctx, inputs[i]);
+        x = mont_mul_cios(&x, &one, &ctx.cios.p, ctx.cios.p_for_redc, ctx.cios.n0);
+        hex = bigint_to_hex(&x);
+        mu_check(strcmp(hex, expected_hex[i]) == 0);
+        free(hex);
+
+        BigInt270 one_270 = bigint270_new();
+        one_270.v[0] = 1;
+        BigInt270 x_270 = mont_ctx_reduce_wide_9x30(&ctx, inputs[i]);
+        x_270 = mont_mul_9x30(&x_270, &one_270, &ctx.w30.p, ctx.w30.mu);
+        hex = bigint270_to_hex(&x_270);
+        mu_check(strcmp(hex, expected_hex[i]) == 0);
+
+        BigInt261 one_261 = bigint261_new();
+        one_261.v[0] = 1;
+        BigInt261 x_261 = mont_ctx_reduce_wide_9x29(&ctx, inputs[i]);
+        x_261 = mont_mul_9x29(&x_261, &one_261, &ctx.w29.p, ctx.w29.mu);
+        hex = bigint261_to_hex(&x_261);
+        mu_check(strcmp(hex, expected_hex[i]) == 0);
+
+        BigIntF255 one_f = bigintf_new();
+        one_f.v[0] = f64x2_make(1, 0);
+        BigIntF255 x_f = mont_ctx_reduce_wide_f64(&ctx, inputs[i]);
+        x_f = f64_mont_mul(&x_f, &one_f, &ctx.f64);
+        hex = malloc(65 * sizeof(char));
+        bigintf255_to_hex(&x_f, hex);
+        mu_check(hex_to_bigint256(hex, &x) == 0);
+        bigint_reduce(&x, &x, &ctx.cios.p);
+        free(hex);
+        hex = bigint_to_hex(&x);
+        mu_check(strcmp(hex, expected_hex[i]) == 0);
+        free(hex);
+    }
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_mont_ctx_init);
+    MU_RUN_TEST(test_mont_ctx_kernels);
+    MU_RUN_TEST(test_mont_ctx_reduce_wide);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,104 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/fixed.h"
+
+const size_t NUM_TESTS = 1024;
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+uint64_t mu = 1073741823;
+
+MU_TEST(test_fixed_mul_9x30_init) {
+    BigInt270 p, cr, one;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    // R = 2^270 mod p, which is 1 in Montgomery form
+    mu_check(hex_to_bigint270("0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c", &cr) == 0);
+
+    FixedMul9x30 f;
+    fixed_mul_9x30_init(&f, &cr, &p, mu);
+    one = bigint270_new();
+    one.v[0] = 1;
+    mu_check(memcmp(&f.w, &one, sizeof(BigInt270)) == 0);
+
+    // floor(2^270 / p)
+    char* hex = bigint270_to_hex(&f.w_shoup);
+    mu_check(strcmp(hex, "0000000000000000000000000000000000000000000000000000000000036d94") == 0);
+}
+
+MU_TEST(test_mont_mul_by_fixed_9x30) {
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, ar, cr, expected, res;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+
+    FixedMul9x30 f;
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint270(hex_strs[i * 3 + 1], &cr) == 0);
+        fixed_mul_9x30_init(&f, &cr, &p, mu);
+
+        res = mont_mul_by_fixed_9x30(&ar, &f, &p);
+        char* result_hex = bigint270_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+
+        res = mont_mul_by_fixed_9x30_ct(&ar, &f, &p);
+        result_hex = bigint270_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+    }
+
+    // p - 1 times itself, 0 and 1
+    BigInt270 pm1 = p;
+    pm1.v[0] -= 1;
+    BigInt270 zero = bigint270_new();
+    BigInt270 one = bigint270_new();
+    one.v[0] = 1;
+    BigInt270 edges[3] = {pm1, zero, one};
+    for (int i = 0; i < 3; i ++) {
+        for (int j = 0; j < 3; j ++) {
+            fixed_mul_9x30_init(&f, &edges[j], &p, mu);
+            expected = mont_mul_9x30(&edges[i], &edges[j], &p, mu);
+            res = mont_mul_by_fixed_9x30(&edges[i], &f, &p);
+            mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+            res = mont_mul_by_fixed_9x30_ct(&edges[i], &f, &p);
+            mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+        }
+    }
+}
+
+MU_TEST(test_mont_mul_by_fixed_9x30_batch) {
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, cr;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(hex_strs[1], &cr) == 0);
+
+    BigInt270 *a = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *out = malloc(NUM_TESTS * sizeof(BigInt270));
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &a[i]) == 0);
+    }
+
+    FixedMul9x30 f;
+    fixed_mul_9x30_init(&f, &cr, &p, mu);
+    mont_mul_by_fixed_9x30_batch(out, a, NUM_TESTS, &f, &p);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        BigInt270 expected = mont_mul_9x30(&a[i], &cr, &p, mu);
+        mu_check(memcmp(&out[i], &expected, sizeof(BigInt270)) == 0);
+    }
+
+    // In place
+    mont_mul_by_fixed_9x30_batch(a, a, NUM_TESTS, &f, &p);
+    mu_check(memcmp(a, out, NUM_TESTS * sizeof(BigInt270)) == 0);
+
+    free(a);
+    free(out);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_fixed_mul_9x30_init);
+    MU_RUN_TEST(test_mont_mul_by_fixed_9x30);
+    MU_RUN_TEST(test_mont_mul_by_fixed_9x30_batch);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,197 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/inv.h"
+
+const size_t NUM_TESTS = 1024;
+
+char** get_mont_test_data();
+
+MU_TEST(test_bigints270_inv) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, x, one;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    BigIntS270 ps = bigint270_to_signed(&p);
+    uint32_t p_inv = 1;
+
+    // x * x^-1 = 1, checked with mont_mul_9x30 and a factor of R^2.
+    BigInt270 r2;
+    mu_check(hex_to_bigint270("0ef1f936e2df0e3646faa8f41b8508572c41e6ef915cf1ac94a91857af094e02", &r2) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &x) == 0);
+        BigIntS270 xs = bigint270_to_signed(&x);
+        BigIntS270 x_inv_s;
+        bigints270_inv(&x_inv_s, &xs, &ps, p_inv);
+        BigInt270 x_inv = bigints270_to_unsigned(&x_inv_s);
+
+        BigInt270 xr = mont_mul_9x30(&x, &r2, &p, 1073741823);
+        one = mont_mul_9x30(&xr, &x_inv, &p, 1073741823);
+        mu_check(one.v[0] == 1);
+        for (int j = 1; j < 9; j++) {
+            mu_check(one.v[j] == 0);
+        }
+    }
+
+    // The inverse of 0 is 0, and the inverse of p - 1 is p - 1.
+    BigIntS270 zero = {{0}};
+    BigIntS270 res;
+    bigints270_inv(&res, &zero, &ps, p_inv);
+    for (int j = 0; j < 9; j++) {
+        mu_check(res.v[j] == 0);
+    }
+    BigIntS270 p_minus_one = ps;
+    p_minus_one.v[0] -= 1;
+    bigints270_inv(&res, &p_minus_one, &ps, p_inv);
+    mu_check(memcmp(&res, &p_minus_one, sizeof(BigIntS270)) == 0);
+}
+
+MU_TEST(test_mont_inv_9x30) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    // R = 2^270
+    char* r_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+    char* r3_hex = "03fda000539b9f03b5b23d888ba00b45b60b180f86657ef4e685aeb681854b2b";
+    uint64_t mu = 1073741823;
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, r, r3, ar, ar_inv, res;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(r_hex, &r) == 0);
+    mu_check(hex_to_bigint270(r3_hex, &r3) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        ar_inv = mont_inv_9x30(&ar, &p, mu, &r3);
+
+        // (a * R) * (a^-1 * R) * R^-1 = R, the Montgomery form of 1.
+        res = mont_mul_9x30(&ar, &ar_inv, &p, mu);
+        mu_check(memcmp(&res, &r, sizeof(BigInt270)) == 0);
+    }
+}
+
+MU_TEST(test_mont_inv_cios) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    // R = 2^256
+    char* r_hex = "0d4bda322bbb9a9d16d81575512c0fee7257f50f6ffffff27d1c7ffffffffff3";
+    char* r3_hex = "0601dfa555c48ddab1e55ef6f1c9d713624d23ffae2716996a4295c90f65454c";
+    uint64_t n0 = 4294967295;
+    char** hex_strs = get_mont_test_data();
+    BigInt256 p, r, r3, ar, ar_inv, res;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    mu_check(hex_to_bigint256(r_hex, &r) == 0);
+    mu_check(hex_to_bigint256(r3_hex, &r3) == 0);
+
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p.v[i];
+    }
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        ar_inv = mont_inv_cios(&ar, &p, p_wide, n0, &r3);
+
+        res = mont_mul_cios(&ar, &ar_inv, &p, p_wide, n0);
+        mu_check(bigint_eq(&res, &r));
+    }
+}
+
+MU_TEST(test_batch_inverse_9x30) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* r3_hex = "03fda000539b9f03b5b23d888ba00b45b60b180f86657ef4e685aeb681854b2b";
+    uint64_t mu = 1073741823;
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, r3;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(r3_hex, &r3) == 0);
+
+    BigInt270 *in = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *out = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *scratch = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *expected = malloc(NUM_TESTS * sizeof(BigInt270));
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &in[i]) == 0);
+        // Sprinkle in some zeros, including at both ends.
+        if (i % 100 == 0 || i == NUM_TESTS - 1) {
+            in[i] = bigint270_new();
+        }
+        expected[i] = mont_inv_9x30(&in[i], &p, mu, &r3);
+    }
+
+    batch_inverse_9x30(out, in, NUM_TESTS, &p, mu, &r3, scratch);
+    mu_check(memcmp(out, expected, NUM_TESTS * sizeof(BigInt270)) == 0);
+
+    // Odd sizes leave a short last chunk.
+    memset(out, 0, NUM_TESTS * sizeof(BigInt270));
+    batch_inverse_9x30_mt(out, in, NUM_TESTS - 3, &p, mu, &r3, scratch, 4);
+    mu_check(memcmp(out, expected, (NUM_TESTS - 3) * sizeof(BigInt270)) == 0);
+
+    // 9 elements in chunks of 3 need only 3 of the 4 threads.
+    memset(out, 0, NUM_TESTS * sizeof(BigInt270));
+    batch_inverse_9x30_mt(out, in, 9, &p, mu, &r3, scratch, 4);
+    mu_check(memcmp(out, expected, 9 * sizeof(BigInt270)) == 0);
+
+    // In place.
+    batch_inverse_9x30(in, in, NUM_TESTS, &p, mu, &r3, scratch);
+    mu_check(memcmp(in, expected, NUM_TESTS * sizeof(BigInt270)) == 0);
+
+    free(in);
+    free(out);
+    free(scratch);
+    free(expected);
+}
+
+MU_TEST(test_batch_inverse_cios) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* r3_hex = "0601dfa555c48ddab1e55ef6f1c9d713624d23ffae2716996a4295c90f65454c";
+    uint64_t n0 = 4294967295;
+    char** hex_strs = get_mont_test_data();
+    BigInt256 p, r3;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    mu_check(hex_to_bigint256(r3_hex, &r3) == 0);
+
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p.v[i];
+    }
+
+    BigInt256 *in = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *out = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *scratch = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *expected = malloc(NUM_TESTS * sizeof(BigInt256));
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &in[i]) == 0);
+        if (i % 100 == 0 || i == NUM_TESTS - 1) {
+            in[i] = bigint_new();
+        }
+        expected[i] = mont_inv_cios(&in[i], &p, p_wide, n0, &r3);
+    }
+
+    batch_inverse_cios(out, in, NUM_TESTS, &p, p_wide, n0, &r3, scratch);
+    mu_check(memcmp(out, expected, NUM_TESTS * sizeof(BigInt256)) == 0);
+
+    memset(out, 0, NUM_TESTS * sizeof(BigInt256));
+    batch_inverse_cios_mt(out, in, NUM_TESTS - 3, &p, p_wide, n0, &r3, scratch, 4);
+    mu_check(memcmp(out, expected, (NUM_TESTS - 3) * sizeof(BigInt256)) == 0);
+
+    // 9 elements in chunks of 3 need only 3 of the 4 threads.
+    memset(out, 0, NUM_TESTS * sizeof(BigInt256));
+    batch_inverse_cios_mt(out, in, 9, &p, p_wide, n0, &r3, scratch, 4);
+    mu_check(memcmp(out, expected, 9 * sizeof(BigInt256)) == 0);
+
+    free(in);
+    free(out);
+    free(scratch);
+    free(expected);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_bigints270_inv);
+    MU_RUN_TEST(test_mont_inv_9x30);
+    MU_RUN_TEST(test_mont_inv_cios);
+    MU_RUN_TEST(test_batch_inverse_9x30);
+    MU_RUN_TEST(test_batch_inverse_cios);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
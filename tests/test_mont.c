@@ -1,6 +1,8 @@
 #include "minunit.h"
 #include "./test_mont_data.c"
 #include "../c/mont.h"
+#include "../c/gen/mont_fr_29.h"
+#include "../c/gen/mont_fr_30.h"
 
 const size_t NUM_TESTS = 1024;
 
@@ -127,6 +129,65 @@ MU_TEST(test_mont_mul_cios_f64_simd) {
     }
 }
 
+MU_TEST(test_mont_mul_cios_f64_simd_x2) {
+    char** hex_strs = get_mont_f64_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t n0 = 422212465065983;
+
+    BigIntF255 p, ar0, br0, ar1, br1, abr0, abr1;
+    BigIntF255x2 p2, ar2, br2, abr2;
+
+    int result;
+    result = hex_to_bigintf255(p_hex, &p);
+    mu_check(result == 0);
+    p2 = bigintf255_pack(&p, &p);
+
+    BigIntF255 p_for_redc = bigintf_new();
+    uint64_t p0 = 0x1800000000001;
+    uint64_t p1 = 0x7DA0000002142;
+    uint64_t p2_ = 0x0DEC00566A9DB;
+    uint64_t p3 = 0x2AB305A268F2E;
+    uint64_t p4 = 0x12AB655E9A2CA;
+    memcpy(&(p_for_redc.v[0]), &p0, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[1]), &p1, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[2]), &p2_, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[3]), &p3, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[4]), &p4, sizeof(uint64_t));
+
+    char result_hex[65];
+
+    // Pair up test case i with test case NUM_TESTS - 1 - i so that both lanes
+    // hold different values.
+    for (int i = 0; i < NUM_TESTS; i++) {
+        int k = NUM_TESTS - 1 - i;
+
+        result = hex_to_bigintf255(hex_strs[i * 3], &ar0);
+        mu_check(result == 0);
+        result = hex_to_bigintf255(hex_strs[i * 3 + 1], &br0);
+        mu_check(result == 0);
+        result = hex_to_bigintf255(hex_strs[k * 3], &ar1);
+        mu_check(result == 0);
+        result = hex_to_bigintf255(hex_strs[k * 3 + 1], &br1);
+        mu_check(result == 0);
+
+        ar2 = bigintf255_pack(&ar0, &ar1);
+        br2 = bigintf255_pack(&br0, &br1);
+
+        abr2 = mont_mul_cios_f64_simd_x2(&ar2, &br2, &p2, n0);
+        bigintf255_unpack(&abr2, &abr0, &abr1);
+
+        abr0 = reduce_bigintf(&abr0, &p_for_redc);
+        abr0 = resolve_bigintf(&abr0);
+        abr1 = reduce_bigintf(&abr1, &p_for_redc);
+        abr1 = resolve_bigintf(&abr1);
+
+        bigintf255_to_hex(&abr0, result_hex);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        bigintf255_to_hex(&abr1, result_hex);
+        mu_check(strcmp(result_hex, hex_strs[k * 3 + 2]) == 0);
+    }
+}
+
 typedef BigInt256 (*MontMulFunc)(BigInt256 *, BigInt256 *, BigInt256 *, uint64_t);
 void do_mont_mul_test(
     MontMulFunc func_ptr,
@@ -217,19 +278,691 @@ MU_TEST(test_bm17_simd_mont_mul) {
     do_mont_mul_test(func_ptr, mu);
 }
 
+MU_TEST(test_bm17_simd_extmul_mont_mul) {
+    uint64_t mu = 1;
+    MontMulFunc func_ptr = bm17_simd_extmul_mont_mul;
+    do_mont_mul_test(func_ptr, mu);
+}
+
 MU_TEST(test_bm17_non_simd_mont_mul) {
     uint64_t mu = 1;
     MontMulFunc func_ptr = bm17_non_simd_mont_mul;
     do_mont_mul_test(func_ptr, mu);
 }
 
+MU_TEST(test_mont_mul_9x29_batch) {
+    char** hex_strs = get_mont_9x29_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t mu = 536870911;
+    BigInt261 p;
+    BigInt261 *a = malloc(NUM_TESTS * sizeof(BigInt261));
+    BigInt261 *b = malloc(NUM_TESTS * sizeof(BigInt261));
+    BigInt261 *out = malloc(NUM_TESTS * sizeof(BigInt261));
+
+    mu_check(hex_to_bigint261(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint261(hex_strs[i * 3], &a[i]) == 0);
+        mu_check(hex_to_bigint261(hex_strs[i * 3 + 1], &b[i]) == 0);
+    }
+
+    mont_mul_9x29_batch(out, a, b, NUM_TESTS, &p, mu);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(strcmp(bigint261_to_hex(&out[i]), hex_strs[i * 3 + 2]) == 0);
+    }
+    free(a);
+    free(b);
+    free(out);
+}
+
+MU_TEST(test_mont_mul_9x30_batch) {
+    char** hex_strs = get_mont_9x30_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t mu = 1073741823;
+    BigInt270 p;
+    BigInt270 *a = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *b = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *out = malloc(NUM_TESTS * sizeof(BigInt270));
+
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &a[i]) == 0);
+        mu_check(hex_to_bigint270(hex_strs[i * 3 + 1], &b[i]) == 0);
+    }
+
+    mont_mul_9x30_batch(out, a, b, NUM_TESTS, &p, mu);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(strcmp(bigint270_to_hex(&out[i]), hex_strs[i * 3 + 2]) == 0);
+    }
+    free(a);
+    free(b);
+    free(out);
+}
+
+MU_TEST(test_mont_mul_256_batch) {
+    char** hex_strs = get_mont_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt256 p;
+    BigInt256 *a = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *b = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *out_cios = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *out_bm17 = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *out_bm17_simd = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *out_bm17_extmul = malloc(NUM_TESTS * sizeof(BigInt256));
+    BigInt256 *out_x4 = malloc(NUM_TESTS * sizeof(BigInt256));
+
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &a[i]) == 0);
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &b[i]) == 0);
+    }
+
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p.v[i];
+    }
+
+    mont_mul_cios_batch(out_cios, a, b, NUM_TESTS, &p, p_wide, 4294967295);
+    bm17_non_simd_mont_mul_batch(out_bm17, a, b, NUM_TESTS, &p, 1);
+    bm17_simd_mont_mul_batch(out_bm17_simd, a, b, NUM_TESTS, &p, 1);
+    bm17_simd_extmul_mont_mul_batch(out_bm17_extmul, a, b, NUM_TESTS, &p, 1);
+    mont_mul_x4_batch(out_x4, a, b, NUM_TESTS, &p, 4294967295);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        char* c_hex = hex_strs[i * 3 + 2];
+        char* res_hex;
+
+        res_hex = bigint_to_hex(&out_cios[i]);
+        mu_check(strcmp(res_hex, c_hex) == 0);
+        free(res_hex);
+
+        res_hex = bigint_to_hex(&out_bm17[i]);
+        mu_check(strcmp(res_hex, c_hex) == 0);
+        free(res_hex);
+
+        res_hex = bigint_to_hex(&out_bm17_simd[i]);
+        mu_check(strcmp(res_hex, c_hex) == 0);
+        free(res_hex);
+
+        res_hex = bigint_to_hex(&out_bm17_extmul[i]);
+        mu_check(strcmp(res_hex, c_hex) == 0);
+        free(res_hex);
+
+        res_hex = bigint_to_hex(&out_x4[i]);
+        mu_check(strcmp(res_hex, c_hex) == 0);
+        free(res_hex);
+    }
+    free(a);
+    free(b);
+    free(out_cios);
+    free(out_bm17);
+    free(out_bm17_simd);
+    free(out_bm17_extmul);
+    free(out_x4);
+}
+
+MU_TEST(test_mont_mul_x4) {
+    char** hex_strs = get_mont_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt256 p;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+
+    MontParamsX4 mp;
+    mont_x4_params_init(&mp, &p, 4294967295);
+
+    BigInt256 a[4], b[4], r[4];
+    BigInt256x4 a4, b4, r4;
+    for (int i = 0; i + 3 < NUM_TESTS; i += 4) {
+        for (int k = 0; k < 4; k ++) {
+            mu_check(hex_to_bigint256(hex_strs[(i + k) * 3], &a[k]) == 0);
+            mu_check(hex_to_bigint256(hex_strs[(i + k) * 3 + 1], &b[k]) == 0);
+        }
+        bigint256_to_bigint256x4(&a4, a);
+        bigint256_to_bigint256x4(&b4, b);
+
+        // The transpose is its own inverse
+        bigint256x4_to_bigint256(r, &a4);
+        for (int k = 0; k < 4; k ++) {
+            mu_check(bigint_eq(&r[k], &a[k]));
+        }
+
+        r4 = mont_mul_x4(&a4, &b4, &mp);
+        bigint256x4_to_bigint256(r, &r4);
+        for (int k = 0; k < 4; k ++) {
+            char* res_hex = bigint_to_hex(&r[k]);
+            mu_check(strcmp(res_hex, hex_strs[(i + k) * 3 + 2]) == 0);
+            free(res_hex);
+        }
+    }
+
+    // A batch whose length is not a multiple of 4
+    BigInt256 a7[7], b7[7], out7[7];
+    for (int i = 0; i < 7; i ++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &a7[i]) == 0);
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &b7[i]) == 0);
+    }
+    mont_mul_x4_batch(out7, a7, b7, 7, &p, 4294967295);
+    for (int i = 0; i < 7; i ++) {
+        char* res_hex = bigint_to_hex(&out7[i]);
+        mu_check(strcmp(res_hex, hex_strs[i * 3 + 2]) == 0);
+        free(res_hex);
+    }
+}
+
+MU_TEST(test_mont_mul_cios_f64_simd_batch) {
+    char** hex_strs = get_mont_f64_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t n0 = 422212465065983;
+
+    BigIntF255 p;
+    mu_check(hex_to_bigintf255(p_hex, &p) == 0);
+
+    BigIntF255 p_for_redc = bigintf_new();
+    uint64_t p0 = 0x1800000000001;
+    uint64_t p1 = 0x7DA0000002142;
+    uint64_t p2 = 0x0DEC00566A9DB;
+    uint64_t p3 = 0x2AB305A268F2E;
+    uint64_t p4 = 0x12AB655E9A2CA;
+    memcpy(&(p_for_redc.v[0]), &p0, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[1]), &p1, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[2]), &p2, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[3]), &p3, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[4]), &p4, sizeof(uint64_t));
+
+    // Use an odd length so that the single-lane tail is covered too.
+    const size_t n = NUM_TESTS - 1;
+    BigIntF255 *a = malloc(n * sizeof(BigIntF255));
+    BigIntF255 *b = malloc(n * sizeof(BigIntF255));
+    BigIntF255 *out = malloc(n * sizeof(BigIntF255));
+
+    for (int i = 0; i < n; i++) {
+        mu_check(hex_to_bigintf255(hex_strs[i * 3], &a[i]) == 0);
+        mu_check(hex_to_bigintf255(hex_strs[i * 3 + 1], &b[i]) == 0);
+    }
+
+    mont_mul_cios_f64_simd_batch(out, a, b, n, &p, &p_for_redc, n0);
+
+    char result_hex[65];
+    for (int i = 0; i < n; i++) {
+        bigintf255_to_hex(&out[i], result_hex);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+    }
+    free(a);
+    free(b);
+    free(out);
+}
+
+MU_TEST(test_mont_sqr_9x29) {
+    char** hex_strs = get_mont_9x29_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t mu = 536870911;
+    BigInt261 ar, p, expected, res;
+    mu_check(hex_to_bigint261(p_hex, &p) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint261(hex_strs[i * 3], &ar) == 0);
+        expected = mont_mul_9x29(&ar, &ar, &p, mu);
+        res = mont_sqr_9x29(&ar, &p, mu);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt261)) == 0);
+        res = mont_sqr_9x29_ct(&ar, &p, mu);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt261)) == 0);
+    }
+}
+
+MU_TEST(test_mont_sqr_9x30) {
+    char** hex_strs = get_mont_9x30_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t mu = 1073741823;
+    BigInt270 ar, p, expected, res;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        expected = mont_mul_9x30(&ar, &ar, &p, mu);
+        res = mont_sqr_9x30(&ar, &p, mu);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+        res = mont_sqr_9x30_ct(&ar, &p, mu);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+    }
+}
+
+MU_TEST(test_mont_sqr_cios) {
+    char** hex_strs = get_mont_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t n0 = 4294967295;
+    BigInt256 ar, p, expected, res;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p.v[i];
+    }
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        expected = mont_mul_cios(&ar, &ar, &p, p_wide, n0);
+        res = mont_sqr_cios(&ar, &p, n0);
+        mu_check(bigint_eq(&res, &expected));
+        res = mont_sqr_cios_ct(&ar, &p, n0);
+        mu_check(bigint_eq(&res, &expected));
+    }
+}
+
+MU_TEST(test_mont_sqr_cios_f64_simd) {
+    char** hex_strs = get_mont_f64_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t n0 = 422212465065983;
+    BigIntF255 p, ar, expected, res;
+    mu_check(hex_to_bigintf255(p_hex, &p) == 0);
+
+    BigIntF255 p_for_redc = bigintf_new();
+    uint64_t p0 = 0x1800000000001;
+    uint64_t p1 = 0x7DA0000002142;
+    uint64_t p2 = 0x0DEC00566A9DB;
+    uint64_t p3 = 0x2AB305A268F2E;
+    uint64_t p4 = 0x12AB655E9A2CA;
+    memcpy(&(p_for_redc.v[0]), &p0, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[1]), &p1, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[2]), &p2, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[3]), &p3, sizeof(uint64_t));
+    memcpy(&(p_for_redc.v[4]), &p4, sizeof(uint64_t));
+
+    char expected_hex[65];
+    char result_hex[65];
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigintf255(hex_strs[i * 3], &ar) == 0);
+
+        expected = mont_mul_cios_f64_simd(&ar, &ar, &p, n0);
+        expected = reduce_bigintf(&expected, &p_for_redc);
+        expected = resolve_bigintf(&expected);
+
+        res = mont_sqr_cios_f64_simd(&ar, &p, n0);
+        res = reduce_bigintf(&res, &p_for_redc);
+        res = resolve_bigintf(&res);
+
+        bigintf255_to_hex(&expected, expected_hex);
+        bigintf255_to_hex(&res, result_hex);
+        mu_check(strcmp(result_hex, expected_hex) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_9x29_lazy) {
+    char** hex_strs = get_mont_9x29_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* p2_hex = "2556cabd34594aacc1689a3cb86f6002b354edfda00000021423000000000002";
+    uint64_t mu = 536870911;
+    BigInt261 ar, br, p, p2, x, y, x_lazy, y_lazy, res;
+    mu_check(hex_to_bigint261(p_hex, &p) == 0);
+    mu_check(hex_to_bigint261(p2_hex, &p2) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint261(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint261(hex_strs[i * 3 + 1], &br) == 0);
+
+        // Run a chain of multiplications and squarings with and without the
+        // final subtraction. The lazy values must stay below 2p and agree
+        // with the reduced ones once canonicalized.
+        x = ar;
+        y = br;
+        x_lazy = ar;
+        y_lazy = br;
+        for (int j = 0; j < 16; j++) {
+            x = mont_mul_9x29(&x, &y, &p, mu);
+            y = mont_sqr_9x29(&y, &p, mu);
+            x_lazy = mont_mul_9x29_lazy(&x_lazy, &y_lazy, &p, mu);
+            y_lazy = mont_sqr_9x29_lazy(&y_lazy, &p, mu);
+            mu_check(!gt_261(x_lazy.v, &p2));
+            mu_check(!gt_261(y_lazy.v, &p2));
+        }
+        res = canonicalize_261(&x_lazy, &p);
+        mu_check(memcmp(&res, &x, sizeof(BigInt261)) == 0);
+        res = canonicalize_261(&y_lazy, &p);
+        mu_check(memcmp(&res, &y, sizeof(BigInt261)) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_9x30_lazy) {
+    char** hex_strs = get_mont_9x30_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* p2_hex = "2556cabd34594aacc1689a3cb86f6002b354edfda00000021423000000000002";
+    uint64_t mu = 1073741823;
+    BigInt270 ar, br, p, p2, x, y, x_lazy, y_lazy, res;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(p2_hex, &p2) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint270(hex_strs[i * 3 + 1], &br) == 0);
+
+        // Run a chain of multiplications and squarings with and without the
+        // final subtraction. The lazy values must stay below 2p and agree
+        // with the reduced ones once canonicalized.
+        x = ar;
+        y = br;
+        x_lazy = ar;
+        y_lazy = br;
+        for (int j = 0; j < 16; j++) {
+            x = mont_mul_9x30(&x, &y, &p, mu);
+            y = mont_sqr_9x30(&y, &p, mu);
+            x_lazy = mont_mul_9x30_lazy(&x_lazy, &y_lazy, &p, mu);
+            y_lazy = mont_sqr_9x30_lazy(&y_lazy, &p, mu);
+            mu_check(!gt_270(x_lazy.v, &p2));
+            mu_check(!gt_270(y_lazy.v, &p2));
+        }
+        res = canonicalize_270(&x_lazy, &p);
+        mu_check(memcmp(&res, &x, sizeof(BigInt270)) == 0);
+        res = canonicalize_270(&y_lazy, &p);
+        mu_check(memcmp(&res, &y, sizeof(BigInt270)) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_9x30_fr) {
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 ar, br, res;
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint270(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_9x30_fr(&ar, &br);
+
+        char* result_hex = bigint270_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_9x29_fr) {
+    char** hex_strs = get_mont_9x29_test_data();
+    BigInt261 ar, br, res;
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint261(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint261(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_9x29_fr(&ar, &br);
+
+        char* result_hex = bigint261_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_9x30_p1) {
+    char** hex_strs = get_mont_9x30_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt270 ar, br, p, res;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint270(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_9x30_p1(&ar, &br, &p);
+
+        char* result_hex = bigint270_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_9x29_p1) {
+    char** hex_strs = get_mont_9x29_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt261 ar, br, p, res;
+    mu_check(hex_to_bigint261(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint261(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint261(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_9x29_p1(&ar, &br, &p);
+
+        char* result_hex = bigint261_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+    }
+}
+
+MU_TEST(test_mont_mul_cios_p1) {
+    char** hex_strs = get_mont_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt256 ar, br, p, res;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_cios_p1(&ar, &br, &p);
+
+        char* result_hex = bigint_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+    }
+}
+
+MU_TEST(test_mont_mul_cios_nocarry) {
+    char** hex_strs = get_mont_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t n0 = 4294967295;
+    BigInt256 ar, br, p, res;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_cios_nocarry(&ar, &br, &p, n0);
+
+        char* result_hex = bigint_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+    }
+
+    // The largest prime below 2^254, which has a top limb of 0x3FFFFFFF
+    char* p254_hex = "3fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff0b";
+    uint64_t n0_254 = 0x386cab5d;
+    BigInt256 p254, pm1, expected;
+    mu_check(hex_to_bigint256(p254_hex, &p254) == 0);
+    uint64_t p254_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p254_wide[i] = p254.v[i];
+    }
+    pm1 = p254;
+    pm1.v[0] -= 1;
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &br) == 0);
+        expected = mont_mul_cios(&ar, &br, &p254, p254_wide, n0_254);
+        res = mont_mul_cios_nocarry(&ar, &br, &p254, n0_254);
+        mu_check(bigint_eq(&res, &expected));
+        expected = mont_mul_cios(&ar, &pm1, &p254, p254_wide, n0_254);
+        res = mont_mul_cios_nocarry(&ar, &pm1, &p254, n0_254);
+        mu_check(bigint_eq(&res, &expected));
+    }
+    expected = mont_mul_cios(&pm1, &pm1, &p254, p254_wide, n0_254);
+    res = mont_mul_cios_nocarry(&pm1, &pm1, &p254, n0_254);
+    mu_check(bigint_eq(&res, &expected));
+}
+
+MU_TEST(test_mont_sqr_cios_nocarry) {
+    char** hex_strs = get_mont_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t n0 = 4294967295;
+    BigInt256 ar, p, expected, res;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        expected = mont_sqr_cios(&ar, &p, n0);
+        res = mont_sqr_cios_nocarry(&ar, &p, n0);
+        mu_check(bigint_eq(&res, &expected));
+    }
+
+    ar = p;
+    ar.v[0] -= 1;
+    expected = mont_sqr_cios(&ar, &p, n0);
+    res = mont_sqr_cios_nocarry(&ar, &p, n0);
+    mu_check(bigint_eq(&res, &expected));
+}
+
+MU_TEST(test_mont_mul_ct) {
+    char** hex_strs = get_mont_test_data();
+    char** hex_strs_9x30 = get_mont_9x30_test_data();
+    char** hex_strs_9x29 = get_mont_9x29_test_data();
+    char** hex_strs_f64 = get_mont_f64_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    BigInt256 p, ar, br, res;
+    BigInt270 p_270, ar_270, br_270, res_270;
+    BigInt261 p_261, ar_261, br_261, res_261;
+    BigIntF255 p_f, ar_f, br_f, abr_f, expected_f, res_f;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(p_hex, &p_270) == 0);
+    mu_check(hex_to_bigint261(p_hex, &p_261) == 0);
+    mu_check(hex_to_bigintf255(p_hex, &p_f) == 0);
+
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p.v[i];
+    }
+    BigIntF255 p_for_redc = bigintf_new();
+    for (int i = 0; i < 5; i ++) {
+        uint64_t limb = (uint64_t) f64x2_extract_l(p_f.v[i]);
+        memcpy(&(p_for_redc.v[i]), &limb, sizeof(uint64_t));
+    }
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &br) == 0);
+        res = mont_mul_cios_ct(&ar, &br, &p, p_wide, 4294967295);
+        char* result_hex = bigint_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+        res = bm17_non_simd_mont_mul_ct(&ar, &br, &p, 1);
+        result_hex = bigint_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+        res = bm17_simd_mont_mul_ct(&ar, &br, &p, 1);
+        result_hex = bigint_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+        res = bm17_simd_extmul_mont_mul_ct(&ar, &br, &p, 1);
+        result_hex = bigint_to_hex(&res);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+
+        mu_check(hex_to_bigint270(hex_strs_9x30[i * 3], &ar_270) == 0);
+        mu_check(hex_to_bigint270(hex_strs_9x30[i * 3 + 1], &br_270) == 0);
+        res_270 = mont_mul_9x30_ct(&ar_270, &br_270, &p_270, 1073741823);
+        result_hex = bigint270_to_hex(&res_270);
+        mu_check(strcmp(result_hex, hex_strs_9x30[i * 3 + 2]) == 0);
+
+        mu_check(hex_to_bigint261(hex_strs_9x29[i * 3], &ar_261) == 0);
+        mu_check(hex_to_bigint261(hex_strs_9x29[i * 3 + 1], &br_261) == 0);
+        res_261 = mont_mul_9x29_ct(&ar_261, &br_261, &p_261, 536870911);
+        result_hex = bigint261_to_hex(&res_261);
+        mu_check(strcmp(result_hex, hex_strs_9x29[i * 3 + 2]) == 0);
+
+        // reduce_bigintf_ct must agree with reduce_bigintf in lane 0.
+        mu_check(hex_to_bigintf255(hex_strs_f64[i * 3], &ar_f) == 0);
+        mu_check(hex_to_bigintf255(hex_strs_f64[i * 3 + 1], &br_f) == 0);
+        abr_f = mont_mul_cios_f64_simd(&ar_f, &br_f, &p_f, 422212465065983);
+        expected_f = reduce_bigintf(&abr_f, &p_for_redc);
+        res_f = reduce_bigintf_ct(&abr_f, &p_for_redc);
+        for (int j = 0; j < 5; j ++) {
+            uint64_t expected_limb, res_limb;
+            memcpy(&expected_limb, &(expected_f.v[j]), sizeof(uint64_t));
+            memcpy(&res_limb, &(res_f.v[j]), sizeof(uint64_t));
+            mu_check(expected_limb == res_limb);
+        }
+    }
+
+    // limbs_reduce on p - 1, p and 2p - 1. The lowest limb of p is 1.
+    uint64_t s[9], r[9];
+    BigInt270 x = p_270;
+    x.v[0] -= 1;
+    limbs_reduce(r, x.v, p_270.v, 9, 30);
+    mu_check(memcmp(r, x.v, sizeof(r)) == 0);
+    limbs_reduce(r, p_270.v, p_270.v, 9, 30);
+    for (int i = 0; i < 9; i ++) {
+        mu_check(r[i] == 0);
+    }
+    bigint270_add(&x, &x, &p_270);
+    memcpy(s, x.v, sizeof(s));
+    limbs_reduce(s, s, p_270.v, 9, 30);
+    x = p_270;
+    x.v[0] -= 1;
+    mu_check(memcmp(s, x.v, sizeof(s)) == 0);
+}
+
+MU_TEST(test_mont_dot_9x30) {
+    char** hex_strs = get_mont_9x30_test_data();
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    uint64_t mu = 1073741823;
+    BigInt270 p, res, prod;
+    BigInt270 expected = bigint270_new();
+    BigInt270 *a = malloc(NUM_TESTS * sizeof(BigInt270));
+    BigInt270 *b = malloc(NUM_TESTS * sizeof(BigInt270));
+
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &a[i]) == 0);
+        mu_check(hex_to_bigint270(hex_strs[i * 3 + 1], &b[i]) == 0);
+    }
+
+    // Every prefix of the test data
+    for (int i = 0; i < NUM_TESTS; i++) {
+        res = mont_dot_9x30(a, b, i, &p, mu);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+        prod = mont_mul_9x30(&a[i], &b[i], &p, mu);
+        bigint270_add_mod(&expected, &expected, &prod, &p);
+    }
+    free(a);
+    free(b);
+
+    // The largest sum of a full block, and one that spans two blocks
+    size_t n = MONT_DOT_9X30_BLOCK + 3;
+    BigInt270 *pm1 = malloc(n * sizeof(BigInt270));
+    for (size_t i = 0; i < n; i ++) {
+        pm1[i] = p;
+        pm1[i].v[0] -= 1;
+    }
+    prod = mont_mul_9x30(&pm1[0], &pm1[0], &p, mu);
+    expected = bigint270_new();
+    for (size_t i = 0; i < n; i ++) {
+        if (i == MONT_DOT_9X30_BLOCK) {
+            res = mont_dot_9x30(pm1, pm1, i, &p, mu);
+            mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+        }
+        bigint270_add_mod(&expected, &expected, &prod, &p);
+    }
+    res = mont_dot_9x30(pm1, pm1, n, &p, mu);
+    mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+    free(pm1);
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(test_bm17_simd_mont_mul);
+    MU_RUN_TEST(test_bm17_simd_extmul_mont_mul);
     MU_RUN_TEST(test_bm17_non_simd_mont_mul);
     MU_RUN_TEST(test_mont_mul_cios);
     MU_RUN_TEST(test_mont_mul_cios_f64_simd);
+    MU_RUN_TEST(test_mont_mul_cios_f64_simd_x2);
     MU_RUN_TEST(test_mont_mul_9x30);
     MU_RUN_TEST(test_mont_mul_9x29);
+    MU_RUN_TEST(test_mont_mul_9x29_batch);
+    MU_RUN_TEST(test_mont_mul_9x30_batch);
+    MU_RUN_TEST(test_mont_mul_256_batch);
+    MU_RUN_TEST(test_mont_mul_x4);
+    MU_RUN_TEST(test_mont_mul_cios_f64_simd_batch);
+    MU_RUN_TEST(test_mont_sqr_9x29);
+    MU_RUN_TEST(test_mont_sqr_9x30);
+    MU_RUN_TEST(test_mont_sqr_cios);
+    MU_RUN_TEST(test_mont_sqr_cios_f64_simd);
+    MU_RUN_TEST(test_mont_mul_9x29_lazy);
+    MU_RUN_TEST(test_mont_mul_9x30_lazy);
+    MU_RUN_TEST(test_mont_mul_9x30_fr);
+    MU_RUN_TEST(test_mont_mul_9x29_fr);
+    MU_RUN_TEST(test_mont_mul_9x30_p1);
+    MU_RUN_TEST(test_mont_mul_9x29_p1);
+    MU_RUN_TEST(test_mont_mul_cios_p1);
+    MU_RUN_TEST(test_mont_mul_cios_nocarry);
+    MU_RUN_TEST(test_mont_sqr_cios_nocarry);
+    MU_RUN_TEST(test_mont_mul_ct);
+    MU_RUN_TEST(test_mont_dot_9x30);
 }
 
 int main(int argc, char *argv[]) {
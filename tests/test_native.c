@@ -0,0 +1,133 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/native.h"
+
+const size_t NUM_TESTS = 1024;
+
+char** get_mont_test_data();
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+
+// The largest prime below 2^254
+char* p254_hex = "3fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff0b";
+
+MU_TEST(test_mont_4x64_init) {
+    BigInt256 p;
+    MontParams4x64 mp;
+    hex_to_bigint256(p_hex, &p);
+    mu_check(mont_4x64_init(&mp, &p) == 0);
+    mu_check(mp.p.v[0] * mp.n0 == 0xffffffffffffffffULL);
+
+    // R^2 mod p, with R = 2^256
+    BigInt_4_64 r2;
+    hex_to_bigint_4_64("011fdae7eff1c939a7cc008fe5dc8593cc2c27b58860591f25d577bab861857b", &r2);
+    mu_check(bigint_4_64_eq(&mp.r2, &r2));
+
+    char* even_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000000";
+    char* large_hex = "42ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    hex_to_bigint256(even_hex, &p);
+    mu_check(mont_4x64_init(&mp, &p) == -1);
+    hex_to_bigint256(large_hex, &p);
+    mu_check(mont_4x64_init(&mp, &p) == -1);
+}
+
+// The vectors in test_mont_data.c are for R = 2^256, as for mont_mul_cios, so
+// they apply to mont_mul_4x64 unchanged.
+MU_TEST(test_mont_mul_4x64) {
+    char** hex_strs = get_mont_test_data();
+    BigInt256 p, res_256;
+    BigInt_4_64 ar, br, res, sq;
+    MontParams4x64 mp;
+    hex_to_bigint256(p_hex, &p);
+    mu_check(mont_4x64_init(&mp, &p) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint_4_64(hex_strs[i * 3], &ar) == 0);
+        mu_check(hex_to_bigint_4_64(hex_strs[i * 3 + 1], &br) == 0);
+
+        res = mont_mul_4x64(&ar, &br, &mp.p, mp.n0);
+        bigint_4_64_to_bigint256(&res_256, &res);
+        char* result_hex = bigint_to_hex(&res_256);
+        mu_check(strcmp(result_hex, hex_strs[i * 3 + 2]) == 0);
+        free(result_hex);
+
+        res = mont_mul_4x64(&ar, &ar, &mp.p, mp.n0);
+        sq = mont_sqr_4x64(&ar, &mp.p, mp.n0);
+        mu_check(bigint_4_64_eq(&res, &sq));
+    }
+}
+
+/// Checks the 4 x 64-bit kernels against the 8 x 32-bit functions in
+/// bigint.h: a + b, a - b, a * b via conversion into and out of Montgomery
+/// form, and a^2, including for a = b = p - 1.
+void do_native_ops_test(char* modulus_hex) {
+    char** hex_strs = get_mont_test_data();
+    BigInt256 p, a, b, expected, res_256;
+    BigInt_4_64 a64, b64, ar, br, res, one = {{1, 0, 0, 0}};
+    MontParams4x64 mp;
+    mu_check(hex_to_bigint256(modulus_hex, &p) == 0);
+    mu_check(mont_4x64_init(&mp, &p) == 0);
+
+    for (int i = 0; i < NUM_TESTS + 1; i++) {
+        if (i < NUM_TESTS) {
+            mu_check(hex_to_bigint256(hex_strs[i * 3], &a) == 0);
+            mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &b) == 0);
+            bigint_reduce(&a, &a, &p);
+            bigint_reduce(&b, &b, &p);
+        } else {
+            BigInt256 one_256 = bigint_new();
+            one_256.v[0] = 1;
+            bigint_sub(&a, &p, &one_256);
+            b = a;
+        }
+        bigint256_to_bigint_4_64(&a64, &a);
+        bigint256_to_bigint_4_64(&b64, &b);
+
+        res = bigint_4_64_add_mod(&a64, &b64, &mp.p);
+        bigint_4_64_to_bigint256(&res_256, &res);
+        bigint_add_mod(&expected, &a, &b, &p);
+        mu_check(bigint_eq(&res_256, &expected));
+
+        res = bigint_4_64_sub_mod(&a64, &b64, &mp.p);
+        bigint_4_64_to_bigint256(&res_256, &res);
+        bigint_sub_mod(&expected, &a, &b, &p);
+        mu_check(bigint_eq(&res_256, &expected));
+
+        // a * b mod p by doubling and adding, against a * b through
+        // Montgomery form
+        expected = bigint_new();
+        for (int bit = 255; bit >= 0; bit --) {
+            bigint_double_mod(&expected, &expected, &p);
+            if ((b.v[bit / 32] >> (bit % 32)) & 1) {
+                bigint_add_mod(&expected, &expected, &a, &p);
+            }
+        }
+        ar = mont_mul_4x64(&a64, &mp.r2, &mp.p, mp.n0);
+        br = mont_mul_4x64(&b64, &mp.r2, &mp.p, mp.n0);
+        res = mont_mul_4x64(&ar, &br, &mp.p, mp.n0);
+        res = mont_mul_4x64(&res, &one, &mp.p, mp.n0);
+        bigint_4_64_to_bigint256(&res_256, &res);
+        mu_check(bigint_eq(&res_256, &expected));
+
+        res = mont_sqr_4x64(&ar, &mp.p, mp.n0);
+        BigInt_4_64 res2 = mont_mul_4x64(&ar, &ar, &mp.p, mp.n0);
+        mu_check(bigint_4_64_eq(&res, &res2));
+    }
+}
+
+MU_TEST(test_native_ops) {
+    do_native_ops_test(p_hex);
+    do_native_ops_test(p254_hex);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_mont_4x64_init);
+    MU_RUN_TEST(test_mont_mul_4x64);
+    MU_RUN_TEST(test_native_ops);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,171 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/pow.h"
+#include "../c/gen/addchain_fr.h"
+
+const size_t NUM_TESTS = 256;
+
+char** get_mont_test_data();
+
+// (p - 1) / 2 and p - 2
+char* p_minus_1_over_2_hex = "0955b2af4d1652ab305a268f2e1bd800acd53b7f680000008508c00000000000";
+char* p_minus_2_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a117fffffffffff";
+
+/// Computes ar^e with one mont_mul_9x30 per bit, for comparison.
+BigInt270 naive_pow_9x30(BigInt270 *ar, BigInt256 *e, BigInt270 *p, uint64_t mu, BigInt270 *one) {
+    BigInt270 res = *one;
+    for (int i = 255; i >= 0; i--) {
+        res = mont_mul_9x30(&res, &res, p, mu);
+        if ((e->v[i / 32] >> (i % 32)) & 1) {
+            res = mont_mul_9x30(&res, ar, p, mu);
+        }
+    }
+    return res;
+}
+
+MU_TEST(test_mont_pow_9x30) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    // R = 2^270
+    char* r_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+    uint64_t mu = 1073741823;
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, one, ar, expected, res;
+    BigInt256 e;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(r_hex, &one) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+        // Use the other test values as random exponents.
+        mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &e) == 0);
+
+        expected = naive_pow_9x30(&ar, &e, &p, mu, &one);
+        res = mont_pow_9x30(&ar, &e, &p, mu, &one);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+        res = mont_pow_9x30_ct(&ar, &e, &p, mu, &one);
+        mu_check(memcmp(&res, &expected, sizeof(BigInt270)) == 0);
+    }
+
+    // x^0 = 1 and x^1 = x
+    BigInt256 zero = bigint_new();
+    res = mont_pow_9x30(&ar, &zero, &p, mu, &one);
+    mu_check(memcmp(&res, &one, sizeof(BigInt270)) == 0);
+    res = mont_pow_9x30_ct(&ar, &zero, &p, mu, &one);
+    mu_check(memcmp(&res, &one, sizeof(BigInt270)) == 0);
+    BigInt256 unit = bigint_new();
+    unit.v[0] = 1;
+    res = mont_pow_9x30(&ar, &unit, &p, mu, &one);
+    mu_check(memcmp(&res, &ar, sizeof(BigInt270)) == 0);
+}
+
+MU_TEST(test_mont_pow_9x29) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    // R = 2^261
+    char* r_hex = "0ec09024379d1e368b840e0e38b8ddb0965868081ffffe38c60efffffffffe4a";
+    uint64_t mu = 536870911;
+    char** hex_strs = get_mont_9x29_test_data();
+    BigInt261 p, one, ar, res, res_ct;
+    BigInt256 e;
+    mu_check(hex_to_bigint261(p_hex, &p) == 0);
+    mu_check(hex_to_bigint261(r_hex, &one) == 0);
+    mu_check(hex_to_bigint256(p_minus_2_hex, &e) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint261(hex_strs[i * 3], &ar) == 0);
+
+        // ar^(p - 2) is the inverse of ar, so ar * ar^(p - 2) = 1.
+        res = mont_pow_9x29(&ar, &e, &p, mu, &one);
+        res_ct = mont_pow_9x29_ct(&ar, &e, &p, mu, &one);
+        mu_check(memcmp(&res, &res_ct, sizeof(BigInt261)) == 0);
+        res = mont_mul_9x29(&res, &ar, &p, mu);
+        mu_check(memcmp(&res, &one, sizeof(BigInt261)) == 0);
+    }
+}
+
+MU_TEST(test_mont_pow_cios) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    // R = 2^256
+    char* r_hex = "0d4bda322bbb9a9d16d81575512c0fee7257f50f6ffffff27d1c7ffffffffff3";
+    uint64_t n0 = 4294967295;
+    char** hex_strs = get_mont_test_data();
+    BigInt256 p, one, ar, res, res_ct, e;
+    mu_check(hex_to_bigint256(p_hex, &p) == 0);
+    mu_check(hex_to_bigint256(r_hex, &one) == 0);
+    mu_check(hex_to_bigint256(p_minus_2_hex, &e) == 0);
+
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p.v[i];
+    }
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint256(hex_strs[i * 3], &ar) == 0);
+
+        res = mont_pow_cios(&ar, &e, &p, p_wide, n0, &one);
+        res_ct = mont_pow_cios_ct(&ar, &e, &p, p_wide, n0, &one);
+        mu_check(bigint_eq(&res, &res_ct));
+        res = mont_mul_cios(&res, &ar, &p, p_wide, n0);
+        mu_check(bigint_eq(&res, &one));
+    }
+}
+
+MU_TEST(test_mont_pow_chain) {
+    char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    char* r_270_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+    char* r_261_hex = "0ec09024379d1e368b840e0e38b8ddb0965868081ffffe38c60efffffffffe4a";
+    char* r_256_hex = "0d4bda322bbb9a9d16d81575512c0fee7257f50f6ffffff27d1c7ffffffffff3";
+    char** hex_strs_270 = get_mont_9x30_test_data();
+    char** hex_strs_261 = get_mont_9x29_test_data();
+    char** hex_strs_256 = get_mont_test_data();
+
+    BigInt256 e_inv, e_legendre;
+    mu_check(hex_to_bigint256(p_minus_2_hex, &e_inv) == 0);
+    mu_check(hex_to_bigint256(p_minus_1_over_2_hex, &e_legendre) == 0);
+
+    BigInt270 p_270, one_270, ar_270, res_270, expected_270;
+    mu_check(hex_to_bigint270(p_hex, &p_270) == 0);
+    mu_check(hex_to_bigint270(r_270_hex, &one_270) == 0);
+    BigInt261 p_261, one_261, ar_261, res_261, expected_261;
+    mu_check(hex_to_bigint261(p_hex, &p_261) == 0);
+    mu_check(hex_to_bigint261(r_261_hex, &one_261) == 0);
+    BigInt256 p_256, one_256, ar_256, res_256, expected_256;
+    mu_check(hex_to_bigint256(p_hex, &p_256) == 0);
+    mu_check(hex_to_bigint256(r_256_hex, &one_256) == 0);
+    uint64_t p_wide[9] = {0};
+    for (int i = 0; i < 8; i ++) {
+        p_wide[i] = p_256.v[i];
+    }
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs_270[i * 3], &ar_270) == 0);
+        res_270 = mont_pow_chain_9x30(&ar_270, &addchain_fr_p_minus_2, &p_270, 1073741823);
+        expected_270 = mont_pow_9x30(&ar_270, &e_inv, &p_270, 1073741823, &one_270);
+        mu_check(memcmp(&res_270, &expected_270, sizeof(BigInt270)) == 0);
+        res_270 = mont_pow_chain_9x30(&ar_270, &addchain_fr_p_minus_1_over_2, &p_270, 1073741823);
+        expected_270 = mont_pow_9x30(&ar_270, &e_legendre, &p_270, 1073741823, &one_270);
+        mu_check(memcmp(&res_270, &expected_270, sizeof(BigInt270)) == 0);
+
+        mu_check(hex_to_bigint261(hex_strs_261[i * 3], &ar_261) == 0);
+        res_261 = mont_pow_chain_9x29(&ar_261, &addchain_fr_p_minus_2, &p_261, 536870911);
+        expected_261 = mont_pow_9x29(&ar_261, &e_inv, &p_261, 536870911, &one_261);
+        mu_check(memcmp(&res_261, &expected_261, sizeof(BigInt261)) == 0);
+
+        mu_check(hex_to_bigint256(hex_strs_256[i * 3], &ar_256) == 0);
+        res_256 = mont_pow_chain_cios(&ar_256, &addchain_fr_p_minus_1_over_2, &p_256, p_wide, 4294967295);
+        expected_256 = mont_pow_cios(&ar_256, &e_legendre, &p_256, p_wide, 4294967295, &one_256);
+        mu_check(bigint_eq(&res_256, &expected_256));
+    }
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_mont_pow_9x30);
+    MU_RUN_TEST(test_mont_pow_9x29);
+    MU_RUN_TEST(test_mont_pow_cios);
+    MU_RUN_TEST(test_mont_pow_chain);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,137 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/ctx.h"
+
+const size_t NUM_TESTS = 256;
+
+char** get_mont_test_data();
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+
+// 0x12ac * 2^240 + 2^125 + 1, which is prime, and larger than the modulus
+// above, so the test data is in range for both.
+char* sparse_p_hex = "12ac000000000000000000000000000020000000000000000000000000000001";
+
+MU_TEST(test_mont_sparse_init) {
+    MontCtx ctx;
+    mu_check(mont_ctx_init_hex(&ctx, p_hex) == 0);
+
+    // Only the low limb is special.
+    mu_check(ctx.cios.sparse.kind[0] == MONT_LIMB_ONE);
+    mu_check(ctx.cios.sparse.num_full == 7);
+    mu_check(ctx.cios.sparse.num_one == 0);
+    mu_check(mont_sparse_skipped_muls(&ctx.cios.sparse) == 8);
+    mu_check(mont_sparse_skipped_muls(&ctx.w30.sparse) == 9);
+    mu_check(mont_sparse_skipped_muls(&ctx.w29.sparse) == 9);
+
+    mu_check(mont_ctx_init_hex(&ctx, sparse_p_hex) == 0);
+
+    // In 32-bit limbs, p = [1, 0, 0, 2^29, 0, 0, 0, 0x12ac0000]
+    MontSparse *sp = &ctx.cios.sparse;
+    uint8_t cios_kinds[8] = {
+        MONT_LIMB_ONE, MONT_LIMB_ZERO, MONT_LIMB_ZERO, MONT_LIMB_FULL,
+        MONT_LIMB_ZERO, MONT_LIMB_ZERO, MONT_LIMB_ZERO, MONT_LIMB_FULL
+    };
+    for (int i = 0; i < 8; i ++) {
+        mu_check(sp->kind[i] == cios_kinds[i]);
+    }
+    mu_check(sp->num_full == 2);
+    mu_check(sp->full[0] == 3);
+    mu_check(sp->full[1] == 7);
+    mu_check(mont_sparse_skipped_muls(sp) == 8 * 6);
+
+    // In 30-bit limbs, p = [1, 0, 0, 0, 0x20, 0, 0, 0, 0x12ac]
+    sp = &ctx.w30.sparse;
+    mu_check(sp->num_full == 2);
+    mu_check(sp->full[0] == 4);
+    mu_check(sp->full[1] == 8);
+    mu_check(mont_sparse_skipped_muls(sp) == 9 * 7);
+
+    // Limbs of 1 other than the lowest
+    uint64_t limbs[9] = {3, 1, 0, 1, 5, 0, 0, 0, 7};
+    MontSparse s;
+    mont_sparse_init(&s, limbs, 9);
+    mu_check(s.kind[0] == MONT_LIMB_FULL);
+    mu_check(s.num_one == 2);
+    mu_check(s.one[0] == 1);
+    mu_check(s.one[1] == 3);
+    mu_check(s.num_full == 2);
+    mu_check(mont_sparse_skipped_muls(&s) == 9 * 6);
+}
+
+/// Checks that every sparse kernel agrees with its generic counterpart on the
+/// test data, for the modulus in ctx.
+void do_mont_sparse_kernel_test(MontCtx *ctx) {
+    char** hex_strs = get_mont_test_data();
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        char* a_hex = hex_strs[i * 3];
+        char* b_hex = hex_strs[i * 3 + 1];
+
+        // 32-bit limbs
+        MontParamsCios *cios = &ctx->cios;
+        BigInt256 a, b, expected, res;
+        mu_check(hex_to_bigint256(a_hex, &a) == 0);
+        mu_check(hex_to_bigint256(b_hex, &b) == 0);
+        expected = mont_mul_cios(&a, &b, &cios->p, cios->p_for_redc, cios->n0);
+        res = mont_mul_cios_sparse(&a, &b, &cios->p, cios->n0, &cios->sparse);
+        mu_check(bigint_eq(&res, &expected));
+
+        expected = bm17_non_simd_mont_mul(&a, &b, &cios->p, cios->mu_bm17);
+        res = bm17_non_simd_mont_mul_sparse(&a, &b, &cios->p, cios->mu_bm17, &cios->sparse);
+        mu_check(bigint_eq(&res, &expected));
+
+        // 30-bit limbs
+        MontParams9x30 *w30 = &ctx->w30;
+        BigInt270 a_270, b_270, expected_270, res_270;
+        mu_check(hex_to_bigint270(a_hex, &a_270) == 0);
+        mu_check(hex_to_bigint270(b_hex, &b_270) == 0);
+        expected_270 = mont_mul_9x30(&a_270, &b_270, &w30->p, w30->mu);
+        res_270 = mont_mul_9x30_sparse(&a_270, &b_270, &w30->p, w30->mu, &w30->sparse);
+        mu_check(memcmp(&res_270, &expected_270, sizeof(BigInt270)) == 0);
+
+        // 29-bit limbs
+        MontParams9x29 *w29 = &ctx->w29;
+        BigInt261 a_261, b_261, expected_261, res_261;
+        mu_check(hex_to_bigint261(a_hex, &a_261) == 0);
+        mu_check(hex_to_bigint261(b_hex, &b_261) == 0);
+        expected_261 = mont_mul_9x29(&a_261, &b_261, &w29->p, w29->mu);
+        res_261 = mont_mul_9x29_sparse(&a_261, &b_261, &w29->p, w29->mu, &w29->sparse);
+        mu_check(memcmp(&res_261, &expected_261, sizeof(BigInt261)) == 0);
+    }
+
+    // (p - 1) * (p - 1)
+    BigInt256 one = bigint_new();
+    one.v[0] = 1;
+    BigInt256 pm1, expected, res;
+    bigint_sub(&pm1, &ctx->cios.p, &one);
+    expected = mont_mul_cios(&pm1, &pm1, &ctx->cios.p, ctx->cios.p_for_redc, ctx->cios.n0);
+    res = mont_mul_cios_sparse(&pm1, &pm1, &ctx->cios.p, ctx->cios.n0, &ctx->cios.sparse);
+    mu_check(bigint_eq(&res, &expected));
+
+    BigInt270 pm1_270, expected_270, res_270;
+    bigint256_to_bigint270(&pm1_270, &pm1);
+    expected_270 = mont_mul_9x30(&pm1_270, &pm1_270, &ctx->w30.p, ctx->w30.mu);
+    res_270 = mont_mul_9x30_sparse(&pm1_270, &pm1_270, &ctx->w30.p, ctx->w30.mu, &ctx->w30.sparse);
+    mu_check(memcmp(&res_270, &expected_270, sizeof(BigInt270)) == 0);
+}
+
+MU_TEST(test_mont_sparse_kernels) {
+    MontCtx ctx;
+    mu_check(mont_ctx_init_hex(&ctx, p_hex) == 0);
+    do_mont_sparse_kernel_test(&ctx);
+
+    mu_check(mont_ctx_init_hex(&ctx, sparse_p_hex) == 0);
+    do_mont_sparse_kernel_test(&ctx);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_mont_sparse_init);
+    MU_RUN_TEST(test_mont_sparse_kernels);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
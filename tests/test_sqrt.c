@@ -0,0 +1,107 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/sqrt.h"
+#include "../c/gen/addchain_fr.h"
+
+const size_t NUM_TESTS = 1024;
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+// R = 2^270 mod p
+char* r_hex = "0aa44f23ebc780c66b926887e9d99f0b2fcc461fbffc6fe83a61fffffffc926c";
+// (p - 1) / 2
+char* p_minus_1_over_2_hex = "0955b2af4d1652ab305a268f2e1bd800acd53b7f680000008508c00000000000";
+uint64_t mu = 1073741823;
+
+MU_TEST(test_legendre_9x30) {
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, one, ar, x;
+    BigInt256 e;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(r_hex, &one) == 0);
+    mu_check(hex_to_bigint256(p_minus_1_over_2_hex, &e) == 0);
+
+    int num_squares = 0;
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+
+        // Euler's criterion
+        x = mont_pow_9x30(&ar, &e, &p, mu, &one);
+        int expected = memcmp(&x, &one, sizeof(BigInt270)) == 0 ? 1 : -1;
+        int legendre = legendre_9x30(&ar, &p, mu, &one);
+        mu_check(legendre == expected);
+        mu_check(is_square_9x30(&ar, &p, mu, &one) == (expected == 1));
+        num_squares += legendre == 1;
+
+        // Squares are always squares.
+        x = mont_sqr_9x30(&ar, &p, mu);
+        mu_check(legendre_9x30(&x, &p, mu, &one) == 1);
+    }
+    // Roughly half of the inputs should be squares.
+    mu_check(num_squares > NUM_TESTS / 4 && num_squares < NUM_TESTS * 3 / 4);
+
+    BigInt270 zero = bigint270_new();
+    mu_check(legendre_9x30(&zero, &p, mu, &one) == 0);
+    mu_check(is_square_9x30(&zero, &p, mu, &one));
+}
+
+void do_sqrt_test(SqrtCtx9x30 *ctx) {
+    char** hex_strs = get_mont_9x30_test_data();
+    BigInt270 p, one, ar, a2, root, root2;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(r_hex, &one) == 0);
+
+    for (int i = 0; i < NUM_TESTS; i++) {
+        mu_check(hex_to_bigint270(hex_strs[i * 3], &ar) == 0);
+
+        // The square root of a^2 is a or -a.
+        a2 = mont_sqr_9x30(&ar, &p, mu);
+        mu_check(mont_sqrt_9x30(&root, &a2, ctx));
+        root2 = mont_sqr_9x30(&root, &p, mu);
+        mu_check(memcmp(&root2, &a2, sizeof(BigInt270)) == 0);
+
+        // Inputs that are not squares are rejected.
+        bool square = legendre_9x30(&ar, &p, mu, &one) == 1;
+        mu_check(mont_sqrt_9x30(&root, &ar, ctx) == square);
+        if (square) {
+            root2 = mont_sqr_9x30(&root, &p, mu);
+            mu_check(memcmp(&root2, &ar, sizeof(BigInt270)) == 0);
+        }
+    }
+
+    // sqrt(0) = 0 and sqrt(1) = +-1
+    BigInt270 zero = bigint270_new();
+    mu_check(mont_sqrt_9x30(&root, &zero, ctx));
+    mu_check(memcmp(&root, &zero, sizeof(BigInt270)) == 0);
+    mu_check(mont_sqrt_9x30(&root, &one, ctx));
+    root2 = mont_sqr_9x30(&root, &p, mu);
+    mu_check(memcmp(&root2, &one, sizeof(BigInt270)) == 0);
+}
+
+MU_TEST(test_mont_sqrt_9x30) {
+    BigInt270 p, one;
+    mu_check(hex_to_bigint270(p_hex, &p) == 0);
+    mu_check(hex_to_bigint270(r_hex, &one) == 0);
+
+    SqrtCtx9x30 *ctx = malloc(sizeof(SqrtCtx9x30));
+    mu_check(sqrt_ctx_9x30_init(ctx, &p, mu, &one, NULL) == 0);
+    mu_check(ctx->s == 47);
+    mu_check(ctx->num_digits == 8);
+    mu_check(ctx->top_width == 4);
+    do_sqrt_test(ctx);
+
+    // With the generated addition chain for (t - 1) / 2
+    mu_check(sqrt_ctx_9x30_init(ctx, &p, mu, &one, &addchain_fr_t_minus_1_over_2) == 0);
+    do_sqrt_test(ctx);
+    free(ctx);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_legendre_9x30);
+    MU_RUN_TEST(test_mont_sqrt_9x30);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}
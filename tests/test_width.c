@@ -0,0 +1,112 @@
+#include "minunit.h"
+#include "./test_mont_data.c"
+#include "../c/width.h"
+#include "../c/barrett.h"
+
+const size_t NUM_TESTS = 1024;
+
+char** get_mont_test_data();
+
+char* p_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+
+// The largest prime below 2^254
+char* p254_hex = "3fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff0b";
+
+MU_TEST(test_mont_width_params_init) {
+    BigInt256 p;
+    MontWidthParams mp;
+    hex_to_bigint256(p_hex, &p);
+
+    for (int w = MONT_WIDTH_MIN; w <= MONT_WIDTH_MAX; w ++) {
+        mu_check(mont_width_params_init(&mp, &p, w) == 0);
+        mu_check(mp.n == mont_width_num_limbs(w));
+        mu_check(mp.n * w >= 256);
+
+        // mu * p = -1 mod 2^w
+        uint64_t mask = (1ULL << w) - 1;
+        mu_check(((mp.mu * mp.p[0]) & mask) == mask);
+    }
+
+    // The 30-bit constants match those in MontCtx
+    mu_check(mont_width_params_init(&mp, &p, 30) == 0);
+    mu_check(mp.mu == 1073741823);
+    mu_check(mont_width_params_init(&mp, &p, 29) == 0);
+    mu_check(mp.mu == 536870911);
+
+    mu_check(mont_width_params_init(&mp, &p, 25) == -1);
+    mu_check(mont_width_params_init(&mp, &p, 33) == -1);
+    char* even_hex = "12ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000000";
+    char* large_hex = "42ab655e9a2ca55660b44d1e5c37b00159aa76fed00000010a11800000000001";
+    hex_to_bigint256(even_hex, &p);
+    mu_check(mont_width_params_init(&mp, &p, 30) == -1);
+    hex_to_bigint256(large_hex, &p);
+    mu_check(mont_width_params_init(&mp, &p, 30) == -1);
+}
+
+/// For each width, converts a and b into Montgomery form with r2, multiplies
+/// them, converts the product back, and checks it against barrett_mul_8x32.
+/// Also checks the square of each operand against its product with itself.
+void do_mont_width_test(char* modulus_hex) {
+    char** hex_strs = get_mont_test_data();
+    BigInt256 p, a, b, expected, res;
+    BarrettCtx bctx;
+    mu_check(hex_to_bigint256(modulus_hex, &p) == 0);
+    mu_check(barrett_ctx_init(&bctx, &p) == 0);
+
+    for (size_t k = 0; k < NUM_MONT_WIDTH_KERNELS; k ++) {
+        const MontWidthKernel *kern = &mont_width_kernels[k];
+        MontWidthParams mp;
+        mu_check(mont_width_params_init(&mp, &p, kern->w) == 0);
+        mu_check(mp.n == kern->n);
+
+        uint64_t one[MONT_WIDTH_MAX_LIMBS] = {1};
+        uint64_t al[MONT_WIDTH_MAX_LIMBS], bl[MONT_WIDTH_MAX_LIMBS];
+        uint64_t ar[MONT_WIDTH_MAX_LIMBS], br[MONT_WIDTH_MAX_LIMBS];
+        uint64_t cr[MONT_WIDTH_MAX_LIMBS], sq[MONT_WIDTH_MAX_LIMBS];
+        uint64_t cl[MONT_WIDTH_MAX_LIMBS];
+        for (int i = 0; i < NUM_TESTS + 1; i ++) {
+            if (i < NUM_TESTS) {
+                mu_check(hex_to_bigint256(hex_strs[i * 3], &a) == 0);
+                mu_check(hex_to_bigint256(hex_strs[i * 3 + 1], &b) == 0);
+                bigint_reduce(&a, &a, &p);
+                bigint_reduce(&b, &b, &p);
+            } else {
+                // (p - 1) * (p - 1)
+                BigInt256 one_256 = bigint_new();
+                one_256.v[0] = 1;
+                bigint_sub(&a, &p, &one_256);
+                b = a;
+            }
+            expected = barrett_mul_8x32(&a, &b, &bctx.w32);
+
+            mont_width_from_bigint256(al, &a, mp.n, mp.w);
+            mont_width_from_bigint256(bl, &b, mp.n, mp.w);
+            kern->mul(ar, al, mp.r2, mp.p, mp.mu);
+            kern->mul(br, bl, mp.r2, mp.p, mp.mu);
+            kern->mul(cr, ar, br, mp.p, mp.mu);
+            kern->mul(cl, cr, one, mp.p, mp.mu);
+            mont_width_to_bigint256(&res, cl, mp.n, mp.w);
+            mu_check(bigint_eq(&res, &expected));
+
+            kern->sqr(sq, ar, mp.p, mp.mu);
+            kern->mul(cr, ar, ar, mp.p, mp.mu);
+            mu_check(memcmp(sq, cr, mp.n * sizeof(uint64_t)) == 0);
+        }
+    }
+}
+
+MU_TEST(test_mont_width_mul) {
+    do_mont_width_test(p_hex);
+    do_mont_width_test(p254_hex);
+}
+
+MU_TEST_SUITE(test_suite) {
+    MU_RUN_TEST(test_mont_width_params_init);
+    MU_RUN_TEST(test_mont_width_mul);
+}
+
+int main(int argc, char *argv[]) {
+	MU_RUN_SUITE(test_suite);
+	MU_REPORT();
+	return MU_EXIT_CODE;
+}